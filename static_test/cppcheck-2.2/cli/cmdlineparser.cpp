@@ -238,6 +238,20 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
                 mSettings->configExcludePaths.insert(Path::fromNativeSeparators(argv[i] + 17));
             }
 
+            // Checking threads per file
+            else if (std::strncmp(argv[i], "--config-jobs=", 14) == 0) {
+                std::istringstream iss(14+argv[i]);
+                if (!(iss >> mSettings->configJobs)) {
+                    printMessage("cppcheck: argument to '--config-jobs=' is not a number.");
+                    return false;
+                }
+
+                if (mSettings->configJobs > 10000) {
+                    printMessage("cppcheck: argument for '--config-jobs=' is allowed to be 10000 at max.");
+                    return false;
+                }
+            }
+
             else if (std::strncmp(argv[i], "--config-excludes-file=", 23) == 0) {
                 // open this file and read every input file (1 file name per line)
                 const std::string cfgExcludesFile(23 + argv[i]);
@@ -253,6 +267,18 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
                     mSettings->buildDir.erase(mSettings->buildDir.size() - 1U);
             }
 
+            else if (std::strncmp(argv[i], "--cppcheck-build-dir-format=", 28) == 0) {
+                const std::string format = argv[i] + 28;
+                if (format == "xml")
+                    mSettings->buildDirFormat = Settings::BuildDirFormat::XML;
+                else if (format == "binary")
+                    mSettings->buildDirFormat = Settings::BuildDirFormat::Binary;
+                else {
+                    printMessage("cppcheck: error: unrecognized build dir format: \"" + format + "\". Supported formats: xml, binary.");
+                    return false;
+                }
+            }
+
             // Show --debug output after the first simplifications
             else if (std::strcmp(argv[i], "--debug") == 0 ||
                      std::strcmp(argv[i], "--debug-normal") == 0)
@@ -337,6 +363,21 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
                 CppCheckExecutor::setExceptionOutput((exceptionOutfilename=="stderr") ? stderr : stdout);
             }
 
+#ifdef THREADING_MODEL_FORK
+            // How -j jobs are run
+            else if (std::strncmp(argv[i], "--executor=", 11) == 0) {
+                const std::string executor = argv[i] + 11;
+                if (executor == "process")
+                    mSettings->executor = Settings::ExecutorType::Process;
+                else if (executor == "thread")
+                    mSettings->executor = Settings::ExecutorType::Thread;
+                else {
+                    printMessage("cppcheck: error: unrecognized executor: \"" + executor + "\". Supported executors: process, thread.");
+                    return false;
+                }
+            }
+#endif
+
             // Filter errors
             else if (std::strncmp(argv[i], "--exitcode-suppressions=", 24) == 0) {
                 // exitcode-suppressions=filename.txt
@@ -538,6 +579,29 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
             else if (std::strncmp(argv[i], "--max-ctu-depth=", 16) == 0)
                 mSettings->maxCtuDepth = std::atoi(argv[i] + 16);
 
+            // Budget of the forward analysis in ValueFlow
+            else if (std::strncmp(argv[i], "--max-valueflow-forks=", 22) == 0 ||
+                     std::strncmp(argv[i], "--max-valueflow-time=", 21) == 0 ||
+                     std::strncmp(argv[i], "--max-valueflow-tokens=", 23) == 0) {
+                const std::string option(argv[i], std::strchr(argv[i], '=') + 1);
+                int *limit = &mSettings->maxValueFlowTokens;
+                if (option == "--max-valueflow-forks=")
+                    limit = &mSettings->maxValueFlowForks;
+                else if (option == "--max-valueflow-time=")
+                    limit = &mSettings->maxValueFlowTime;
+
+                std::istringstream iss(argv[i] + option.size());
+                if (!(iss >> *limit)) {
+                    printMessage("cppcheck: argument to '" + option + "' is not a number.");
+                    return false;
+                }
+
+                if (*limit < 0) {
+                    printMessage("cppcheck: argument to '" + option + "' must not be negative.");
+                    return false;
+                }
+            }
+
             // Write results in file
             else if (std::strncmp(argv[i], "--output-file=", 14) == 0)
                 mSettings->outputFile = Path::simplifyPath(Path::fromNativeSeparators(argv[i] + 14));
@@ -743,6 +807,9 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
                 }
             }
 
+            else if (std::strncmp(argv[i], "--showtime-output=", 18) == 0)
+                mSettings->showtimeOutput = argv[i] + 18;
+
             // --std
             else if (std::strcmp(argv[i], "--std=posix") == 0) {
                 printMessage("cppcheck: Option --std=posix is deprecated and will be removed in 2.05.");
@@ -852,6 +919,9 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
                 }
             }
 
+            else if (std::strncmp(argv[i], "--trace-output=", 15) == 0)
+                mSettings->traceOutput = argv[i] + 15;
+
             else if (std::strcmp(argv[i], "-v") == 0 || std::strcmp(argv[i], "--verbose") == 0)
                 mSettings->verbose = true;
 
@@ -921,6 +991,11 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
         printMessage("cppcheck: unusedFunction check can't be used with '-j' option. Disabling unusedFunction check.");
     }
 
+    if (!mSettings->showtimeOutput.empty() && mSettings->showtime == SHOWTIME_MODES::SHOWTIME_NONE) {
+        printMessage("cppcheck: error: --showtime-output requires --showtime.");
+        return false;
+    }
+
     if (argc <= 1) {
         mShowHelp = true;
         mExitAfterPrint = true;
@@ -972,6 +1047,19 @@ void CmdLineParser::printHelp()
               "                            the hash for a file is unchanged.\n"
               "                          * some useful debug information, i.e. commands used to\n"
               "                            execute clang/clang-tidy/addons.\n"
+              "                          * faster preprocessing; the tokens of each included\n"
+              "                            header are stored in a <header>.<hash>.tokens file\n"
+              "                            and reused while the header is unchanged. These\n"
+              "                            files are not removed by Cppcheck, delete them\n"
+              "                            together with the folder.\n"
+              "    --cppcheck-build-dir-format=<format>\n"
+              "                         Format of the analysis results in the Cppcheck work\n"
+              "                         folder. Valid values are:\n"
+              "                          * xml\n"
+              "                                  XML files. This is the default.\n"
+              "                          * binary\n"
+              "                                  Smaller files that are faster to read. They\n"
+              "                                  can only be read by the same Cppcheck build.\n"
               "    --check-config       Check cppcheck configuration. The normal code\n"
               "                         analysis is disabled by this flag.\n"
               "    --check-library      Show information messages when library files have\n"
@@ -990,6 +1078,12 @@ void CmdLineParser::printHelp()
               "                         be considered for evaluation.\n"
               "    --config-excludes-file=<file>\n"
               "                         A file that contains a list of config-excludes\n"
+              "    --config-jobs=<n>    Check up to <n> configurations of a file\n"
+              "                         simultaneously. The threads that are not needed for\n"
+              "                         the configurations analyze the functions of a\n"
+              "                         configuration simultaneously. The default is 0, then\n"
+              "                         the -j threads that are not needed for the files are\n"
+              "                         used, 1 when there are more files than -j threads.\n"
               "    --dump               Dump xml data for each translation unit. The dump\n"
               "                         files have the extension .dump and contain ast,\n"
               "                         tokenlist, symboldatabase, valueflow.\n"
@@ -1031,6 +1125,18 @@ void CmdLineParser::printHelp()
               "                         provided. Note that your operating system can modify\n"
               "                         this value, e.g. '256' can become '0'.\n"
               "    --errorlist          Print a list of all the error messages in XML format.\n"
+#ifdef THREADING_MODEL_FORK
+              "    --executor=<type>    How the -j jobs are run. Valid values are:\n"
+              "                          * process\n"
+              "                                  Check each file in a forked child process.\n"
+              "                                  This is the default.\n"
+              "                          * thread\n"
+              "                                  Use a pool of <jobs> threads inside the\n"
+              "                                  cppcheck process. No process is created per\n"
+              "                                  file. A crash while checking one file ends\n"
+              "                                  the whole run, with process only the child\n"
+              "                                  of that file is lost.\n"
+#endif
               "    --exitcode-suppressions=<file>\n"
               "                         Used when certain messages should be displayed but\n"
               "                         should not cause a non-zero exitcode.\n"
@@ -1069,6 +1175,9 @@ void CmdLineParser::printHelp()
               "                         more comments, like: '// cppcheck-suppress warningId'\n"
               "                         on the lines before the warning to suppress.\n"
               "    -j <jobs>            Start <jobs> threads to do the checking simultaneously.\n"
+              "                         When there are fewer files than <jobs>, the\n"
+              "                         configurations of a file are checked simultaneously,\n"
+              "                         see --config-jobs.\n"
 #ifdef THREADING_MODEL_FORK
               "    -l <load>            Specifies that no new threads should be started if\n"
               "                         there are other threads running and the load average is\n"
@@ -1087,6 +1196,21 @@ void CmdLineParser::printHelp()
               "    --max-ctu-depth=N    Max depth in whole program analysis. The default value\n"
               "                         is 2. A larger value will mean more errors can be found\n"
               "                         but also means the analysis will be slower.\n"
+              "    --max-valueflow-forks=N\n"
+              "                         Max number of scopes that the forward analysis of\n"
+              "                         values forks in one function. When it is exceeded,\n"
+              "                         the rest of the function is analyzed faster but with\n"
+              "                         less precision. The default value 0 means no limit.\n"
+              "    --max-valueflow-time=<seconds>\n"
+              "                         Max time for the value flow analysis of one file.\n"
+              "                         When it is exceeded, the rest of the file is analyzed\n"
+              "                         faster but with less precision. The default value 0\n"
+              "                         means no limit.\n"
+              "    --max-valueflow-tokens=N\n"
+              "                         Max number of tokens that the forward analysis of\n"
+              "                         values visits in one function. When it is exceeded,\n"
+              "                         the rest of the function is analyzed faster but with\n"
+              "                         less precision. The default value 0 means no limit.\n"
               "    --output-file=<file> Write results to file, rather than standard error.\n"
               "    --project=<file>     Run Cppcheck on project. The <file> can be a Visual\n"
               "                         Studio Solution (*.sln), Visual Studio Project\n"
@@ -1141,6 +1265,12 @@ void CmdLineParser::printHelp()
               "    --rule-file=<file>   Use given rule file. For more information, see: \n"
               "                         http://sourceforge.net/projects/cppcheck/files/Articles/\n"
 #endif
+              "    --showtime-output=<file>\n"
+              "                         Write the timing results of --showtime for each file\n"
+              "                         and in total to <file>: CPU and wall time, growth of\n"
+              "                         the peak memory usage, memory allocations and tokens\n"
+              "                         of each phase. The format is CSV if <file> ends with\n"
+              "                         '.csv' and JSON otherwise.\n"
               "    --std=<id>           Set standard.\n"
               "                         The available options are:\n"
               "                          * c89\n"
@@ -1207,6 +1337,11 @@ void CmdLineParser::printHelp()
               "                           \\r         insert carriage return\n"
               "                         Example format (gcc-like):\n"
               "                         '{file}:{line}:{column}: note: {info}\\n{code}'\n"
+              "    --trace-output=<file>\n"
+              "                         Write the timed phases of the analysis to <file> as a\n"
+              "                         Chrome trace event JSON file, that can be opened in\n"
+              "                         chrome://tracing or Perfetto. With -j each worker is\n"
+              "                         a process of the trace.\n"
               "    -U<ID>               Undefine preprocessor symbol. Use -U to explicitly\n"
               "                         hide certain #ifdef <ID> code paths from checking.\n"
               "                         Example: '-UDEBUG'\n"
@@ -31,6 +31,7 @@
 #include "settings.h"
 #include "suppressions.h"
 #include "threadexecutor.h"
+#include "timer.h"
 #include "utils.h"
 #include "checkunusedfunctions.h"
 
@@ -330,7 +331,7 @@ static void print_stacktrace(FILE* output, bool demangling, int maxdepth, bool l
 #endif
 }
 
-static const size_t MYSTACKSIZE = 16*1024+SIGSTKSZ; // wild guess about a reasonable buffer
+static const size_t MYSTACKSIZE = 16*1024+32768; // wild guess about a reasonable buffer
 static char mytstack[MYSTACKSIZE]= {0}; // alternative stack for signal handler
 static bool bStackBelowHeap=false; // lame attempt to locate heap vs. stack address space. See CppCheckExecutor::check_wrapper()
 
@@ -902,6 +903,18 @@ int CppCheckExecutor::check_internal(CppCheck& cppcheck, int /*argc*/, const cha
         AnalyzerInformation::writeFilesTxt(settings.buildDir, fileNames, settings.project.fileSettings);
     }
 
+    // Unless --config-jobs is given, the threads that are not needed for
+    // the files check the configurations of a file in parallel
+    if (settings.configJobs == 0) {
+        const std::size_t fileCount = settings.project.fileSettings.empty() ? mFiles.size() : settings.project.fileSettings.size();
+        settings.configJobs = (fileCount > 0 && fileCount < settings.jobs) ? settings.jobs / fileCount : 1;
+    }
+
+    // Timers of all threads and worker processes add their events to the trace
+    static TimerTrace timerTrace;
+    if (!settings.traceOutput.empty())
+        Timer::setTrace(&timerTrace);
+
     unsigned int returnValue = 0;
     if (settings.jobs == 1) {
         // Single process
@@ -961,6 +974,13 @@ int CppCheckExecutor::check_internal(CppCheck& cppcheck, int /*argc*/, const cha
 
     cppcheck.analyseWholeProgram(mSettings->buildDir, mFiles);
 
+    if (!settings.traceOutput.empty()) {
+        Timer::setTrace(nullptr);
+        if (!timerTrace.write(settings.traceOutput))
+            std::cerr << "cppcheck: error: could not write the trace to '" << settings.traceOutput << "'" << std::endl;
+        timerTrace.clear();
+    }
+
     if (settings.isEnabled(Settings::INFORMATION) || settings.checkConfiguration) {
         const bool enableUnusedFunctionCheck = cppcheck.isUnusedFunctionCheckEnabled();
 
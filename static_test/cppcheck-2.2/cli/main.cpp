@@ -60,8 +60,12 @@
 
 
 #include "cppcheckexecutor.h"
+#include "timer.h"
 
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
+#include <new>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -69,6 +73,67 @@
 static char exename[1024] = {0};
 #endif
 
+// The memory allocations of each thread are counted for --showtime
+static thread_local std::uint64_t allocations = 0;
+
+static std::uint64_t allocationCount()
+{
+    return allocations;
+}
+
+void *operator new(std::size_t size)
+{
+    ++allocations;
+    for (;;) {
+        void *p = std::malloc(size ? size : 1);
+        if (p)
+            return p;
+        const std::new_handler handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc();
+        handler();
+    }
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) NOEXCEPT
+{
+    try {
+        return operator new(size);
+    } catch (const std::bad_alloc &) {
+        return nullptr;
+    }
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &tag) NOEXCEPT
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void *p) NOEXCEPT
+{
+    std::free(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) NOEXCEPT
+{
+    std::free(p);
+}
+
+void operator delete[](void *p) NOEXCEPT
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) NOEXCEPT
+{
+    std::free(p);
+}
+
 /**
  * Main function of cppcheck
  *
@@ -83,6 +148,8 @@ int main(int argc, char* argv[])
     _CrtSetDbgFlag(_CrtSetDbgFlag(_CRTDBG_REPORT_FLAG) | _CRTDBG_LEAK_CHECK_DF);
 #endif
 
+    Timer::setAllocationCounter(allocationCount);
+
     CppCheckExecutor exec;
 #ifdef _WIN32
     GetModuleFileNameA(nullptr, exename, sizeof(exename)/sizeof(exename[0])-1);
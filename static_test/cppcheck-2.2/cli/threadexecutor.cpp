@@ -18,19 +18,31 @@
 
 #include "threadexecutor.h"
 
+#include "analyzerinfo.h"
 #include "config.h"
 #include "cppcheck.h"
 #include "cppcheckexecutor.h"
 #include "importproject.h"
+#include "path.h"
 #include "settings.h"
 #include "suppressions.h"
+#include "timer.h"
+
+#include <simplecpp.h>
 
 #include <algorithm>
 #include <cerrno>
+#include <csignal>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <set>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #ifdef __SVR4  // Solaris
 #include <sys/loadavg.h>
@@ -40,6 +52,7 @@
 #include <sys/prctl.h>
 #endif
 #include <sys/select.h>
+#include <sys/stat.h>
 #include <sys/wait.h>
 #include <fcntl.h>
 #include <unistd.h>
@@ -58,12 +71,13 @@ ThreadExecutor::ThreadExecutor(const std::map<std::string, std::size_t> &files,
 {
 #if defined(THREADING_MODEL_FORK)
     mWpipe = 0;
-#elif defined(THREADING_MODEL_WIN)
+    mPipeBufferSize = 0;
+    mChildUsedCachedResults = false;
+#endif
     mProcessedFiles = 0;
     mTotalFiles = 0;
     mProcessedSize = 0;
     mTotalFileSize = 0;
-#endif
 }
 
 ThreadExecutor::~ThreadExecutor()
@@ -85,63 +99,90 @@ void ThreadExecutor::addFileContent(const std::string &path, const std::string &
 
 int ThreadExecutor::handleRead(int rpipe, unsigned int &result)
 {
-    char type = 0;
-    if (read(rpipe, &type, 1) <= 0) {
+    char buf[65536];
+    const ssize_t bytesRead = read(rpipe, buf, sizeof(buf));
+    if (bytesRead <= 0) {
         if (errno == EAGAIN)
             return 0;
 
+        mReadBuffers.erase(rpipe);
         return -1;
     }
 
-    if (type != REPORT_OUT && type != REPORT_ERROR && type != REPORT_INFO && type != CHILD_END) {
-        std::cerr << "#### ThreadExecutor::handleRead error, type was:" << type << std::endl;
-        std::exit(0);
-    }
-
-    unsigned int len = 0;
-    if (read(rpipe, &len, sizeof(len)) <= 0) {
-        std::cerr << "#### ThreadExecutor::handleRead error, type was:" << type << std::endl;
-        std::exit(0);
+    std::string &data = mReadBuffers[rpipe];
+    data.append(buf, bytesRead);
+
+    // Handle all complete messages, an incomplete message at the end is kept until the rest is read
+    const char *pos = data.data();
+    const char * const end = pos + data.size();
+    std::uint32_t len = 0;
+    while (end - pos >= static_cast<std::ptrdiff_t>(1 + sizeof(len))) {
+        const PipeSignal type = static_cast<PipeSignal>(pos[0]);
+        std::memcpy(&len, pos + 1, sizeof(len));
+        if (end - pos - 1 - static_cast<std::ptrdiff_t>(sizeof(len)) < static_cast<std::ptrdiff_t>(len))
+            break;
+        const char * const payload = pos + 1 + sizeof(len);
+        pos = payload + len;
+        if (!handleMessage(type, payload, pos, result)) {
+            mReadBuffers.erase(rpipe);
+            return -1;
+        }
     }
+    data.erase(0, pos - data.data());
 
-    // Don't rely on incoming data being null-terminated.
-    // Allocate +1 element and null-terminate the buffer.
-    char *buf = new char[len + 1];
-    const ssize_t readIntoBuf = read(rpipe, buf, len);
-    if (readIntoBuf <= 0) {
-        std::cerr << "#### ThreadExecutor::handleRead error, type was:" << type << std::endl;
-        std::exit(0);
-    }
-    buf[readIntoBuf] = 0;
+    return 1;
+}
 
+bool ThreadExecutor::handleMessage(PipeSignal type, const char *data, const char *end, unsigned int &result)
+{
     if (type == REPORT_OUT) {
-        mErrorLogger.reportOut(buf);
+        mErrorLogger.reportOut(std::string(data, end));
+    } else if (type == REPORT_VERIFICATION) {
+        mErrorLogger.bughuntingReport(std::string(data, end));
     } else if (type == REPORT_ERROR || type == REPORT_INFO) {
         ErrorMessage msg;
-        msg.deserialize(buf);
+        if (!msg.deserializeBinary(data, end)) {
+            std::cerr << "#### ThreadExecutor::handleRead error, invalid message of type:" << static_cast<char>(type) << std::endl;
+            std::exit(0);
+        }
 
         if (!mSettings.nomsg.isSuppressed(msg.toSuppressionsErrorMessage())) {
             // Alert only about unique errors
-            std::string errmsg = msg.toString(mSettings.verbose);
-            if (std::find(mErrorList.begin(), mErrorList.end(), errmsg) == mErrorList.end()) {
-                mErrorList.emplace_back(errmsg);
+            if (mErrorList.insert(msg, mSettings.verbose)) {
                 if (type == REPORT_ERROR)
                     mErrorLogger.reportErr(msg);
                 else
                     mErrorLogger.reportInfo(msg);
             }
         }
+    } else if (type == REPORT_TIMING) {
+        TimerResults timerResults;
+        if (!timerResults.deserializeBinary(data, end)) {
+            std::cerr << "#### ThreadExecutor::handleRead error, invalid timing results" << std::endl;
+            std::exit(0);
+        }
+        CppCheck::timerResults().merge(timerResults);
+    } else if (type == REPORT_TRACE) {
+        TimerTrace trace;
+        if (!trace.deserializeBinary(data, end) || !Timer::trace()) {
+            std::cerr << "#### ThreadExecutor::handleRead error, invalid trace" << std::endl;
+            std::exit(0);
+        }
+        Timer::trace()->merge(trace);
     } else if (type == CHILD_END) {
-        std::istringstream iss(buf);
-        unsigned int fileResult = 0;
-        iss >> fileResult;
+        std::uint32_t fileResult = 0;
+        mChildUsedCachedResults = false;
+        if (end - data == sizeof(fileResult) + 1) {
+            std::memcpy(&fileResult, data, sizeof(fileResult));
+            mChildUsedCachedResults = (data[sizeof(fileResult)] != 0);
+        }
         result += fileResult;
-        delete [] buf;
-        return -1;
+        return false;
+    } else {
+        std::cerr << "#### ThreadExecutor::handleRead error, type was:" << static_cast<char>(type) << std::endl;
+        std::exit(0);
     }
-
-    delete [] buf;
-    return 1;
+    return true;
 }
 
 bool ThreadExecutor::checkLoadAverage(size_t nchildren)
@@ -166,9 +207,14 @@ bool ThreadExecutor::checkLoadAverage(size_t nchildren)
 
 unsigned int ThreadExecutor::check()
 {
+    if (mSettings.executor == Settings::ExecutorType::Thread)
+        return checkThreads();
+
     mFileCount = 0;
     unsigned int result = 0;
 
+    createWorkItems();
+
     std::size_t totalfilesize = 0;
     for (std::map<std::string, std::size_t>::const_iterator i = mFiles.begin(); i != mFiles.end(); ++i) {
         totalfilesize += i->second;
@@ -176,14 +222,19 @@ unsigned int ThreadExecutor::check()
 
     std::list<int> rpipes;
     std::map<pid_t, std::string> childFile;
-    std::map<int, std::string> pipeFile;
+    std::map<int, const WorkItem *> pipeFile;
+    std::map<int, std::chrono::steady_clock::time_point> pipeStartTime;
+    // The children are numbered as the workers of the trace, a finished child's number is reused
+    std::map<int, unsigned int> pipeWorker;
+    std::set<unsigned int> freeWorkers;
+    for (unsigned int worker = 1; worker <= mSettings.jobs; ++worker)
+        freeWorkers.insert(worker);
     std::size_t processedsize = 0;
-    std::map<std::string, std::size_t>::const_iterator iFile = mFiles.begin();
-    std::list<ImportProject::FileSettings>::const_iterator iFileSettings = mSettings.project.fileSettings.begin();
+    std::vector<WorkItem>::const_iterator iWorkItem = mWorkItems.begin();
     for (;;) {
         // Start a new child
         size_t nchildren = rpipes.size();
-        if ((iFile != mFiles.end() || iFileSettings != mSettings.project.fileSettings.end()) && nchildren < mSettings.jobs && checkLoadAverage(nchildren)) {
+        if (iWorkItem != mWorkItems.end() && nchildren < mSettings.jobs && checkLoadAverage(nchildren)) {
             int pipes[2];
             if (pipe(pipes) == -1) {
                 std::cerr << "#### ThreadExecutor::check, pipe() failed: "<< std::strerror(errno) << std::endl;
@@ -201,6 +252,9 @@ unsigned int ThreadExecutor::check()
                 std::exit(EXIT_FAILURE);
             }
 
+            const unsigned int worker = *freeWorkers.begin();
+            freeWorkers.erase(freeWorkers.begin());
+
             pid_t pid = fork();
             if (pid < 0) {
                 // Error
@@ -212,38 +266,56 @@ unsigned int ThreadExecutor::check()
 #endif
                 close(pipes[0]);
                 mWpipe = pipes[1];
+                installCrashHandler();
+
+                // The timing results inherited from the parent are not reported again
+                CppCheck::timerResults().clear();
+                if (Timer::trace())
+                    Timer::trace()->clear();
+                Timer::setTraceWorker(worker);
 
                 CppCheck fileChecker(*this, false, CppCheckExecutor::executeCommand);
                 fileChecker.settings() = mSettings;
                 unsigned int resultOfCheck = 0;
 
-                if (iFileSettings != mSettings.project.fileSettings.end()) {
-                    resultOfCheck = fileChecker.check(*iFileSettings);
-                } else if (!mFileContents.empty() && mFileContents.find(iFile->first) != mFileContents.end()) {
+                if (iWorkItem->fileSettings) {
+                    resultOfCheck = fileChecker.check(*iWorkItem->fileSettings);
+                } else if (!mFileContents.empty() && mFileContents.find(*iWorkItem->file) != mFileContents.end()) {
                     // File content was given as a string
-                    resultOfCheck = fileChecker.check(iFile->first, mFileContents[ iFile->first ]);
+                    resultOfCheck = fileChecker.check(*iWorkItem->file, mFileContents[ *iWorkItem->file ]);
                 } else {
                     // Read file from a file
-                    resultOfCheck = fileChecker.check(iFile->first);
+                    resultOfCheck = fileChecker.check(*iWorkItem->file);
                 }
 
-                std::ostringstream oss;
-                oss << resultOfCheck;
-                writeToPipe(CHILD_END, oss.str());
+                if (mSettings.showtime != SHOWTIME_MODES::SHOWTIME_NONE) {
+                    std::string timerResults;
+                    CppCheck::timerResults().serializeBinary(timerResults);
+                    writeToPipe(REPORT_TIMING, timerResults);
+                }
+                if (Timer::trace()) {
+                    std::string trace;
+                    Timer::trace()->serializeBinary(trace);
+                    writeToPipe(REPORT_TRACE, trace);
+                }
+
+                const std::uint32_t fileResult = resultOfCheck;
+                std::string childEnd(reinterpret_cast<const char *>(&fileResult), sizeof(fileResult));
+                childEnd += fileChecker.usedCachedResults() ? '1' : '\0';
+                writeToPipe(CHILD_END, childEnd);
                 std::exit(0);
             }
 
             close(pipes[1]);
             rpipes.push_back(pipes[0]);
-            if (iFileSettings != mSettings.project.fileSettings.end()) {
-                childFile[pid] = iFileSettings->filename + ' ' + iFileSettings->cfg;
-                pipeFile[pipes[0]] = iFileSettings->filename + ' ' + iFileSettings->cfg;
-                ++iFileSettings;
-            } else {
-                childFile[pid] = iFile->first;
-                pipeFile[pipes[0]] = iFile->first;
-                ++iFile;
-            }
+            if (iWorkItem->fileSettings)
+                childFile[pid] = iWorkItem->fileSettings->filename + ' ' + iWorkItem->fileSettings->cfg;
+            else
+                childFile[pid] = *iWorkItem->file;
+            pipeFile[pipes[0]] = &*iWorkItem;
+            pipeStartTime[pipes[0]] = std::chrono::steady_clock::now();
+            pipeWorker[pipes[0]] = worker;
+            ++iWorkItem;
         } else if (!rpipes.empty()) {
             fd_set rfds;
             FD_ZERO(&rfds);
@@ -261,15 +333,19 @@ unsigned int ThreadExecutor::check()
                         int readRes = handleRead(*rp, result);
                         if (readRes == -1) {
                             std::size_t size = 0;
-                            std::map<int, std::string>::iterator p = pipeFile.find(*rp);
+                            std::map<int, const WorkItem *>::iterator p = pipeFile.find(*rp);
                             if (p != pipeFile.end()) {
-                                std::string name = p->second;
+                                const WorkItem *item = p->second;
                                 pipeFile.erase(p);
-                                std::map<std::string, std::size_t>::const_iterator fs = mFiles.find(name);
-                                if (fs != mFiles.end()) {
-                                    size = fs->second;
-                                }
+                                if (!item->fileSettings)
+                                    size = item->size;
+                                const std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - pipeStartTime[*rp];
+                                if (!mChildUsedCachedResults)
+                                    addFileTiming(*item, std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
                             }
+                            pipeStartTime.erase(*rp);
+                            freeWorkers.insert(pipeWorker[*rp]);
+                            pipeWorker.erase(*rp);
 
                             mFileCount++;
                             processedsize += size;
@@ -318,45 +394,355 @@ unsigned int ThreadExecutor::check()
         }
     }
 
+    if (!mSettings.buildDir.empty())
+        AnalyzerInformation::writeFileTimings(mSettings.buildDir, mFileTimings);
+
+    return result;
+}
+
+std::string ThreadExecutor::WorkItem::timingKey() const
+{
+    if (fileSettings)
+        return fileSettings->cfg + ':' + Path::simplifyPath(Path::fromNativeSeparators(fileSettings->filename));
+    return ':' + Path::simplifyPath(Path::fromNativeSeparators(*file));
+}
+
+void ThreadExecutor::createWorkItems()
+{
+    mFileTimings.clear();
+    if (!mSettings.buildDir.empty())
+        mFileTimings = AnalyzerInformation::readFileTimings(mSettings.buildDir);
+
+    mWorkItems.clear();
+    mWorkItems.reserve(mFiles.size() + mSettings.project.fileSettings.size());
+    for (std::map<std::string, std::size_t>::const_iterator i = mFiles.begin(); i != mFiles.end(); ++i) {
+        WorkItem item;
+        item.file = &i->first;
+        item.size = i->second;
+        mWorkItems.push_back(item);
+    }
+    for (std::list<ImportProject::FileSettings>::const_iterator i = mSettings.project.fileSettings.begin(); i != mSettings.project.fileSettings.end(); ++i) {
+        WorkItem item;
+        item.fileSettings = &*i;
+        struct stat fileStat;
+        if (stat(i->filename.c_str(), &fileStat) == 0)
+            item.size = fileStat.st_size;
+        mWorkItems.push_back(item);
+    }
+
+    // Files that were analyzed before are estimated by their analysis time, the
+    // others by their size and the average time per byte of the analyzed files.
+    std::vector<std::size_t> milliseconds(mWorkItems.size(), 0);
+    std::size_t timedMilliseconds = 0;
+    std::size_t timedSize = 0;
+    for (std::size_t i = 0; i < mWorkItems.size(); ++i) {
+        const std::map<std::string, std::size_t>::const_iterator timing = mFileTimings.find(mWorkItems[i].timingKey());
+        if (timing == mFileTimings.end())
+            continue;
+        milliseconds[i] = timing->second + 1;
+        timedMilliseconds += timing->second + 1;
+        timedSize += mWorkItems[i].size;
+    }
+    const double millisecondsPerByte = (timedSize > 0) ? ((double)timedMilliseconds / timedSize) : 1.0;
+    for (std::size_t i = 0; i < mWorkItems.size(); ++i)
+        mWorkItems[i].cost = milliseconds[i] ? milliseconds[i] : (mWorkItems[i].size * millisecondsPerByte);
+
+    std::stable_sort(mWorkItems.begin(), mWorkItems.end(), [](const WorkItem &a, const WorkItem &b) {
+        return a.cost > b.cost;
+    });
+}
+
+void ThreadExecutor::addFileTiming(const WorkItem &item, std::size_t milliseconds)
+{
+    // Keep the largest time so a fast run does not move an expensive file to
+    // the end of the schedule. It decays so the time follows the file when it
+    // really gets cheaper.
+    const std::pair<std::map<std::string, std::size_t>::iterator, bool> inserted =
+        mFileTimings.insert(std::make_pair(item.timingKey(), milliseconds));
+    if (!inserted.second)
+        inserted.first->second = std::max(milliseconds, inserted.first->second - inserted.first->second / 4);
+}
+
+const ThreadExecutor::WorkItem *ThreadExecutor::nextWorkItem(std::vector<WorkQueue> &queues, std::size_t self)
+{
+    {
+        std::lock_guard<std::mutex> queueLock(queues[self].sync);
+        if (!queues[self].items.empty()) {
+            const WorkItem *item = queues[self].items.front();
+            queues[self].items.pop_front();
+            return item;
+        }
+    }
+
+    for (std::size_t i = 1; i < queues.size(); ++i) {
+        WorkQueue &victim = queues[(self + i) % queues.size()];
+        std::lock_guard<std::mutex> queueLock(victim.sync);
+        if (!victim.items.empty()) {
+            const WorkItem *item = victim.items.back();
+            victim.items.pop_back();
+            return item;
+        }
+    }
+
+    return nullptr;
+}
+
+unsigned int ThreadExecutor::checkThreads()
+{
+    createWorkItems();
+
+    mProcessedFiles = 0;
+    mProcessedSize = 0;
+    mTotalFiles = mFiles.size() + mSettings.project.fileSettings.size();
+    mTotalFileSize = 0;
+    for (std::map<std::string, std::size_t>::const_iterator i = mFiles.begin(); i != mFiles.end(); ++i) {
+        mTotalFileSize += i->second;
+    }
+
+    // Deal the files round robin so every thread starts with the most expensive
+    // files that are left
+    std::vector<WorkQueue> queues(mSettings.jobs);
+    for (std::size_t i = 0; i < mWorkItems.size(); ++i)
+        queues[i % queues.size()].items.push_back(&mWorkItems[i]);
+
+    // The threads share the tokenized headers
+    simplecpp::HeaderCache headerCache;
+    headerCache.setDirectory(mSettings.buildDir);
+
+    std::vector<unsigned int> results(mSettings.jobs, 0);
+    std::vector<std::thread> threads;
+    threads.reserve(mSettings.jobs);
+    for (unsigned int i = 0; i < mSettings.jobs; ++i) {
+        unsigned int &threadResult = results[i];
+        threads.emplace_back([this, &queues, i, &headerCache, &threadResult]() {
+            threadResult = threadProc(queues, i, headerCache);
+        });
+    }
+
+    unsigned int result = 0;
+    for (unsigned int i = 0; i < mSettings.jobs; ++i) {
+        threads[i].join();
+        result += results[i];
+    }
+
+    if (!mSettings.buildDir.empty())
+        AnalyzerInformation::writeFileTimings(mSettings.buildDir, mFileTimings);
+
+    return result;
+}
+
+unsigned int ThreadExecutor::threadProc(std::vector<WorkQueue> &queues, std::size_t self, simplecpp::HeaderCache &headerCache)
+{
+    unsigned int result = 0;
+
+    Timer::setTraceWorker(static_cast<unsigned int>(self + 1));
+
+    std::unique_lock<std::mutex> fileLock(mFileSync);
+
+    // Each thread reuses one CppCheck instance for all its files
+    CppCheck fileChecker(*this, false, CppCheckExecutor::executeCommand);
+    fileChecker.settings() = mSettings;
+    fileChecker.setHeaderCache(&headerCache);
+
+    fileLock.unlock();
+
+    while (const WorkItem *item = nextWorkItem(queues, self)) {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        if (item->file) {
+            const std::map<std::string, std::string>::const_iterator fileContent = mFileContents.find(*item->file);
+            if (fileContent != mFileContents.end()) {
+                // File content was given as a string
+                result += fileChecker.check(*item->file, fileContent->second);
+            } else {
+                // Read file from a file
+                result += fileChecker.check(*item->file);
+            }
+        } else { // file settings..
+            result += fileChecker.check(*item->fileSettings);
+            if (mSettings.clangTidy)
+                fileChecker.analyseClangTidy(*item->fileSettings);
+        }
+
+        const std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+
+        fileLock.lock();
+
+        if (!fileChecker.usedCachedResults())
+            addFileTiming(*item, std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+        if (item->file)
+            mProcessedSize += item->size;
+        mProcessedFiles++;
+        if (!mSettings.quiet) {
+            std::lock_guard<std::mutex> reportLock(mReportSync);
+            CppCheckExecutor::reportStatus(mProcessedFiles, mTotalFiles, mProcessedSize, mTotalFileSize);
+        }
+
+        fileLock.unlock();
+    }
+
+    // The timing results are shared by all threads, the summary is shown once by the main CppCheck instance
+    fileChecker.settings().showtime = SHOWTIME_MODES::SHOWTIME_NONE;
 
     return result;
 }
 
+void ThreadExecutor::report(const ErrorMessage &msg, MessageType msgType)
+{
+    // Alert only about unique errors
+    {
+        std::lock_guard<std::mutex> errorLock(mErrorSync);
+        if (mSettings.nomsg.isSuppressed(msg.toSuppressionsErrorMessage()))
+            return;
+
+        if (!mErrorList.insert(msg, mSettings.verbose))
+            return;
+    }
+
+    std::lock_guard<std::mutex> reportLock(mReportSync);
+    switch (msgType) {
+    case MessageType::REPORT_ERROR:
+        mErrorLogger.reportErr(msg);
+        break;
+    case MessageType::REPORT_INFO:
+        mErrorLogger.reportInfo(msg);
+        break;
+    }
+}
+
 void ThreadExecutor::writeToPipe(PipeSignal type, const std::string &data)
 {
-    unsigned int len = static_cast<unsigned int>(data.length() + 1);
-    char *out = new char[ len + 1 + sizeof(len)];
-    out[0] = static_cast<char>(type);
-    std::memcpy(&(out[1]), &len, sizeof(len));
-    std::memcpy(&(out[1+sizeof(len)]), data.c_str(), len);
-    if (write(mWpipe, out, len + 1 + sizeof(len)) <= 0) {
-        delete [] out;
-        out = nullptr;
-        std::cerr << "#### ThreadExecutor::writeToPipe, Failed to write to pipe" << std::endl;
-        std::exit(0);
+    // The buffer is allocated once, the crash handler may read it at any time
+    if (mPipeBuffer.empty())
+        mPipeBuffer.resize(65536);
+
+    const std::uint32_t len = static_cast<std::uint32_t>(data.length());
+    const std::size_t size = 1 + sizeof(len) + data.length();
+    if (static_cast<std::size_t>(mPipeBufferSize) + size > mPipeBuffer.size())
+        flushPipe();
+    if (size > mPipeBuffer.size()) {
+        char header[1 + sizeof(len)];
+        header[0] = static_cast<char>(type);
+        std::memcpy(header + 1, &len, sizeof(len));
+        writeAllToPipe(header, sizeof(header));
+        writeAllToPipe(data.data(), data.length());
+    } else {
+        char *pos = &mPipeBuffer[mPipeBufferSize];
+        *pos = static_cast<char>(type);
+        std::memcpy(pos + 1, &len, sizeof(len));
+        std::memcpy(pos + 1 + sizeof(len), data.data(), data.length());
+        // The message is complete, now the crash handler may send it
+        mPipeBufferSize += size;
+    }
+
+    // Progress output is shown right away, findings are sent in batches.
+    // The buffer is flushed at the end of the file, or by the crash handler
+    // if the check of the file crashes.
+    if (type == REPORT_OUT || type == CHILD_END)
+        flushPipe();
+}
+
+void ThreadExecutor::flushPipe()
+{
+    writeAllToPipe(mPipeBuffer.data(), mPipeBufferSize);
+    mPipeBufferSize = 0;
+}
+
+void ThreadExecutor::writeAllToPipe(const char *data, std::size_t size) const
+{
+    std::size_t written = 0;
+    while (written < size) {
+        const ssize_t res = write(mWpipe, data + written, size - written);
+        if (res <= 0) {
+            if (res < 0 && errno == EINTR)
+                continue;
+            std::cerr << "#### ThreadExecutor::writeToPipe, Failed to write to pipe" << std::endl;
+            std::exit(0);
+        }
+        written += res;
+    }
+}
+
+/** The executor of the child and the signal handlers that were replaced, used by the crash handler */
+static ThreadExecutor *crashExecutor = nullptr;
+static const int crashSignals[] = { SIGABRT, SIGBUS, SIGFPE, SIGILL, SIGSEGV };
+static struct sigaction oldCrashActions[sizeof(crashSignals) / sizeof(crashSignals[0])];
+
+void ThreadExecutor::installCrashHandler()
+{
+    crashExecutor = this;
+    struct sigaction act;
+    std::memset(&act, 0, sizeof(act));
+    act.sa_handler = crashHandler;
+    act.sa_flags = SA_ONSTACK; // use the alternate stack of the cppcheck signal handler if there is one
+    for (std::size_t i = 0; i < sizeof(crashSignals) / sizeof(crashSignals[0]); ++i)
+        sigaction(crashSignals[i], &act, &oldCrashActions[i]);
+}
+
+void ThreadExecutor::crashHandler(int signo)
+{
+    // Only async-signal-safe functions: write the complete messages and let
+    // the previous handler deal with the signal
+    const char *data = crashExecutor->mPipeBuffer.data();
+    std::size_t size = crashExecutor->mPipeBufferSize;
+    while (size > 0) {
+        const ssize_t res = write(crashExecutor->mWpipe, data, size);
+        if (res <= 0 && errno != EINTR)
+            break;
+        if (res > 0) {
+            data += res;
+            size -= res;
+        }
     }
+    crashExecutor->mPipeBufferSize = 0;
 
-    delete [] out;
+    for (std::size_t i = 0; i < sizeof(crashSignals) / sizeof(crashSignals[0]); ++i) {
+        if (crashSignals[i] == signo)
+            sigaction(signo, &oldCrashActions[i], nullptr);
+    }
+    raise(signo);
 }
 
 void ThreadExecutor::reportOut(const std::string &outmsg)
 {
+    if (mSettings.executor == Settings::ExecutorType::Thread) {
+        std::lock_guard<std::mutex> reportLock(mReportSync);
+        mErrorLogger.reportOut(outmsg);
+        return;
+    }
     writeToPipe(REPORT_OUT, outmsg);
 }
 
 void ThreadExecutor::reportErr(const ErrorMessage &msg)
 {
-    writeToPipe(REPORT_ERROR, msg.serialize());
+    if (mSettings.executor == Settings::ExecutorType::Thread) {
+        report(msg, MessageType::REPORT_ERROR);
+        return;
+    }
+    std::string data;
+    msg.serializeBinary(data);
+    writeToPipe(REPORT_ERROR, data);
 }
 
 void ThreadExecutor::reportInfo(const ErrorMessage &msg)
 {
-    writeToPipe(REPORT_INFO, msg.serialize());
+    if (mSettings.executor == Settings::ExecutorType::Thread) {
+        report(msg, MessageType::REPORT_INFO);
+        return;
+    }
+    std::string data;
+    msg.serializeBinary(data);
+    writeToPipe(REPORT_INFO, data);
 }
 
 void ThreadExecutor::bughuntingReport(const std::string &str)
 {
-    writeToPipe(REPORT_VERIFICATION, str.c_str());
+    if (mSettings.executor == Settings::ExecutorType::Thread) {
+        std::lock_guard<std::mutex> reportLock(mReportSync);
+        mErrorLogger.bughuntingReport(str);
+        return;
+    }
+    writeToPipe(REPORT_VERIFICATION, str);
 }
 
 #elif defined(THREADING_MODEL_WIN)
@@ -517,14 +903,8 @@ void ThreadExecutor::report(const ErrorMessage &msg, MessageType msgType)
         return;
 
     // Alert only about unique errors
-    bool reportError = false;
-    const std::string errmsg = msg.toString(mSettings.verbose);
-
     EnterCriticalSection(&mErrorSync);
-    if (std::find(mErrorList.begin(), mErrorList.end(), errmsg) == mErrorList.end()) {
-        mErrorList.emplace_back(errmsg);
-        reportError = true;
-    }
+    const bool reportError = mErrorList.insert(msg, mSettings.verbose);
     LeaveCriticalSection(&mErrorSync);
 
     if (reportError) {
@@ -29,6 +29,12 @@
 
 #if (defined(__GNUC__) || defined(__sun)) && !defined(__MINGW32__) && !defined(__CYGWIN__)
 #define THREADING_MODEL_FORK
+#include <csignal>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "importproject.h"
 #elif defined(_WIN32)
 #define THREADING_MODEL_WIN
 #include <windows.h>
@@ -37,6 +43,9 @@
 #endif
 
 class Settings;
+namespace simplecpp {
+    class HeaderCache;
+}
 
 /// @addtogroup CLI
 /// @{
@@ -46,6 +55,7 @@ class Settings;
  * all files using threads.
  */
 class ThreadExecutor : public ErrorLogger {
+    friend class TestThreadExecutor;
 public:
     ThreadExecutor(const std::map<std::string, std::size_t> &files, Settings &settings, ErrorLogger &errorLogger);
     ThreadExecutor(const ThreadExecutor &) = delete;
@@ -78,7 +88,7 @@ private:
     /** @brief Key is file name, and value is the content of the file */
     std::map<std::string, std::string> mFileContents;
 private:
-    enum PipeSignal {REPORT_OUT='1',REPORT_ERROR='2', REPORT_INFO='3', REPORT_VERIFICATION='4', CHILD_END='5'};
+    enum PipeSignal {REPORT_OUT='1',REPORT_ERROR='2', REPORT_INFO='3', REPORT_VERIFICATION='4', CHILD_END='5', REPORT_TIMING='6', REPORT_TRACE='7'};
 
     /**
      * Read from the pipe, parse and handle what ever is in there.
@@ -87,14 +97,57 @@ private:
      *         1 if we did read something
      */
     int handleRead(int rpipe, unsigned int &result);
+
+    /**
+     * Handle one message from a child.
+     *@return false if the child has finished (CHILD_END)
+     */
+    bool handleMessage(PipeSignal type, const char *data, const char *end, unsigned int &result);
+
+    /**
+     * Send a message to the parent. Messages are framed as type byte,
+     * 32-bit length and payload. Progress output and the end of the
+     * child are sent right away, the other messages are collected in the
+     * bounded pipe buffer.
+     */
     void writeToPipe(PipeSignal type, const std::string &data);
+
+    /** @brief Write all queued messages to the pipe */
+    void flushPipe();
+
+    /** @brief Write data to the pipe, exit if that fails */
+    void writeAllToPipe(const char *data, std::size_t size) const;
+
+    /**
+     * Install the crash handler of the child. It writes the queued
+     * messages to the pipe, so the findings of a crashed file are not lost.
+     */
+    void installCrashHandler();
+
+    /** @brief Signal handler of the child, see installCrashHandler() */
+    static void crashHandler(int signo);
+
+    /** @brief Messages that are already reported, used to report every message once */
+    ErrorMessageSet mErrorList;
+
     /**
      * Write end of status pipe, different for each child.
      * Not used in master process.
      */
-    std::list<std::string> mErrorList;
     int mWpipe;
 
+    /** @brief Messages of the child that are not written to the pipe yet, it is allocated once and never grows */
+    std::vector<char> mPipeBuffer;
+
+    /** @brief Size of the complete messages in mPipeBuffer, read by the crash handler */
+    volatile std::sig_atomic_t mPipeBufferSize;
+
+    /** @brief Data read from the pipes of the children that is not handled yet, key is the read end of the pipe */
+    std::map<int, std::string> mReadBuffers;
+
+    /** @brief The child that finished last read its results from the build dir */
+    bool mChildUsedCachedResults;
+
     /**
      * @brief Check load average condition
      * @param nchildren - count of currently ran children
@@ -102,6 +155,72 @@ private:
      */
     bool checkLoadAverage(size_t nchildren);
 
+    /** @brief A file, or a file configuration of the project, to check */
+    struct WorkItem {
+        WorkItem() : file(nullptr), fileSettings(nullptr), size(0), cost(0) {}
+
+        /** Source file, set when checking the files given on the command line */
+        const std::string *file;
+        /** Project file configuration, set when checking a project */
+        const ImportProject::FileSettings *fileSettings;
+        /** File size in bytes */
+        std::size_t size;
+        /** Estimated analysis time, the most expensive files are checked first */
+        double cost;
+
+        /** Key in the file timings of the build dir, "cfg:sourcefile" */
+        std::string timingKey() const;
+    };
+
+    /**
+     * @brief Fill mWorkItems, most expensive first. The cost is the analysis time
+     * of the previous run in --cppcheck-build-dir, otherwise it is estimated
+     * from the file size.
+     */
+    void createWorkItems();
+
+    /**
+     * @brief Remember how long it took to check a file (mFileSync must be held).
+     * The largest time is kept, it decays by a quarter in every run where
+     * the file is faster. Do not call this when the results of the file were
+     * read from the build dir, that time says nothing about the analysis.
+     */
+    void addFileTiming(const WorkItem &item, std::size_t milliseconds);
+
+    /** @brief Work queue of one thread, other threads steal from it when they are idle */
+    struct WorkQueue {
+        std::mutex sync;
+        std::deque<const WorkItem *> items;
+    };
+
+    /**
+     * @brief Get the next file to check. Take the most expensive file of the own
+     * queue, if it is empty steal the cheapest file of another queue.
+     * @return nullptr if there are no more files
+     */
+    static const WorkItem *nextWorkItem(std::vector<WorkQueue> &queues, std::size_t self);
+
+    /** @brief Check the files with a pool of threads (--executor=thread) */
+    unsigned int checkThreads();
+
+    /** @brief Worker loop, checks files until there are none left */
+    unsigned int threadProc(std::vector<WorkQueue> &queues, std::size_t self, simplecpp::HeaderCache &headerCache);
+
+    enum class MessageType {REPORT_ERROR, REPORT_INFO};
+
+    void report(const ErrorMessage &msg, MessageType msgType);
+
+    std::vector<WorkItem> mWorkItems;
+    /** @brief Analysis time in milliseconds, key is WorkItem::timingKey() */
+    std::map<std::string, std::size_t> mFileTimings;
+    std::size_t mProcessedFiles;
+    std::size_t mTotalFiles;
+    std::size_t mProcessedSize;
+    std::size_t mTotalFileSize;
+    std::mutex mFileSync;
+    std::mutex mErrorSync;
+    std::mutex mReportSync;
+
 public:
     /**
      * @return true if support for threads exist.
@@ -124,7 +243,7 @@ private:
     std::size_t mTotalFileSize;
     CRITICAL_SECTION mFileSync;
 
-    std::list<std::string> mErrorList;
+    ErrorMessageSet mErrorList;
     CRITICAL_SECTION mErrorSync;
 
     CRITICAL_SECTION mReportSync;
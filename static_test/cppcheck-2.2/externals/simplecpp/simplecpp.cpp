@@ -23,6 +23,7 @@
 #include "simplecpp.h"
 
 #include <algorithm>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <exception>
@@ -34,6 +35,17 @@
 #include <stdexcept>
 #include <utility>
 
+#if !defined(SIMPLECPP_WINDOWS) && __cplusplus >= 201103L
+#include <mutex>
+#endif
+
+#ifndef SIMPLECPP_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #ifdef SIMPLECPP_WINDOWS
 #include <windows.h>
 #undef ERROR
@@ -206,12 +218,168 @@ void simplecpp::Token::printOut() const
 
 simplecpp::TokenList::TokenList(std::vector<std::string> &filenames) : frontToken(NULL), backToken(NULL), files(filenames) {}
 
+/**
+ * Input of the tokenizer. The functions behave like the std::istream
+ * functions with the same name. The tokenizer is a template, so the
+ * functions of the different inputs can be inlined.
+ */
+class StdIStream {
+public:
+    explicit StdIStream(std::istream &istr) : istr(istr) {}
+
+    int get() {
+        return istr.get();
+    }
+    int peek() {
+        return istr.peek();
+    }
+    void unget() {
+        istr.unget();
+    }
+    bool good() const {
+        return istr.good();
+    }
+
+private:
+    std::istream &istr;
+};
+
+/** Reads the characters directly from a buffer, without the overhead of std::istream */
+class CharBufferStream {
+public:
+    CharBufferStream(const char *data, std::size_t size)
+        : data(reinterpret_cast<const unsigned char *>(data)), size(size), pos(0), eof(false), fail(false) {}
+
+    int get() {
+        if (!good()) {
+            fail = true;
+            return EOF;
+        }
+        if (pos >= size) {
+            eof = fail = true;
+            return EOF;
+        }
+        return data[pos++];
+    }
+    int peek() {
+        if (!good()) {
+            fail = true;
+            return EOF;
+        }
+        if (pos >= size) {
+            eof = true;
+            return EOF;
+        }
+        return data[pos];
+    }
+    void unget() {
+        // Like std::istream::unget() in C++11, the eof flag is cleared first
+        eof = false;
+        if (fail || pos == 0)
+            fail = true;
+        else
+            --pos;
+    }
+    bool good() const {
+        return !eof && !fail;
+    }
+
+private:
+    const unsigned char * const data;
+    const std::size_t size;
+    std::size_t pos;
+    bool eof;
+    bool fail;
+};
+
+/**
+ * Contents of a file, the file is memory mapped when possible. The mapping
+ * is not protected against a truncation of the file by another process:
+ * then the pages past the new end raise SIGBUS when they are read.
+ */
+class FileData {
+public:
+    explicit FileData(const std::string &filename) : data(NULL), size(0) {
+#ifndef SIMPLECPP_WINDOWS
+        mapping = NULL;
+        const int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+            return;
+        struct stat fileStat;
+        const bool regularFile = (fstat(fd, &fileStat) == 0 && S_ISREG(fileStat.st_mode));
+        if (regularFile && fileStat.st_size > 0) {
+            void *p = mmap(NULL, static_cast<std::size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                mapping = p;
+                data = static_cast<const char *>(p);
+                size = static_cast<std::size_t>(fileStat.st_size);
+            }
+        }
+        close(fd);
+        if (mapping || (regularFile && fileStat.st_size == 0))
+            return;
+#endif
+        // Fallback: read the file
+        std::ifstream fin(filename.c_str(), std::ios::binary);
+        if (!fin.is_open())
+            return;
+        std::ostringstream ostr;
+        ostr << fin.rdbuf();
+        buffer = ostr.str();
+        data = buffer.data();
+        size = buffer.size();
+    }
+
+    ~FileData() {
+#ifndef SIMPLECPP_WINDOWS
+        if (mapping)
+            munmap(mapping, size);
+#endif
+    }
+
+    const char *data;
+    std::size_t size;
+
+private:
+#ifndef SIMPLECPP_WINDOWS
+    void *mapping;
+#endif
+    std::string buffer;
+
+    // Not implemented - prevent copy
+    FileData(const FileData &);
+    FileData &operator=(const FileData &);
+};
+
 simplecpp::TokenList::TokenList(std::istream &istr, std::vector<std::string> &filenames, const std::string &filename, OutputList *outputList)
     : frontToken(NULL), backToken(NULL), files(filenames)
 {
     readfile(istr,filename,outputList);
 }
 
+simplecpp::TokenList::TokenList(const char *data, std::size_t size, std::vector<std::string> &filenames, const std::string &filename, OutputList *outputList)
+    : frontToken(NULL), backToken(NULL), files(filenames)
+{
+    CharBufferStream stream(data, size);
+    readStream(stream,filename,outputList);
+}
+
+simplecpp::TokenList::TokenList(const std::string &filename, std::vector<std::string> &filenames, OutputList *outputList)
+    : frontToken(NULL), backToken(NULL), files(filenames)
+{
+    const FileData fileData(filename);
+    CharBufferStream stream(fileData.data, fileData.size);
+    readStream(stream,filename,outputList);
+}
+
+simplecpp::TokenList::TokenList(const std::string &path, const std::string &filename, std::vector<std::string> &filenames, OutputList *outputList)
+    : frontToken(NULL), backToken(NULL), files(filenames)
+{
+    const FileData fileData(path);
+    CharBufferStream stream(fileData.data, fileData.size);
+    readStream(stream,filename,outputList);
+}
+
 simplecpp::TokenList::TokenList(const TokenList &other) : frontToken(NULL), backToken(NULL), files(other.files)
 {
     *this = other;
@@ -307,7 +475,8 @@ std::string simplecpp::TokenList::stringify() const
     return ret.str();
 }
 
-static unsigned char readChar(std::istream &istr, unsigned int bom)
+template<class Stream>
+static unsigned char readChar(Stream &istr, unsigned int bom)
 {
     unsigned char ch = (unsigned char)istr.get();
 
@@ -338,7 +507,8 @@ static unsigned char readChar(std::istream &istr, unsigned int bom)
     return ch;
 }
 
-static unsigned char peekChar(std::istream &istr, unsigned int bom)
+template<class Stream>
+static unsigned char peekChar(Stream &istr, unsigned int bom)
 {
     unsigned char ch = (unsigned char)istr.peek();
 
@@ -359,14 +529,16 @@ static unsigned char peekChar(std::istream &istr, unsigned int bom)
     return ch;
 }
 
-static void ungetChar(std::istream &istr, unsigned int bom)
+template<class Stream>
+static void ungetChar(Stream &istr, unsigned int bom)
 {
     istr.unget();
     if (bom == 0xfeff || bom == 0xfffe)
         istr.unget();
 }
 
-static unsigned short getAndSkipBOM(std::istream &istr)
+template<class Stream>
+static unsigned short getAndSkipBOM(Stream &istr)
 {
     const int ch1 = istr.peek();
 
@@ -447,6 +619,13 @@ void simplecpp::TokenList::lineDirective(unsigned int fileIndex, unsigned int li
 }
 
 void simplecpp::TokenList::readfile(std::istream &istr, const std::string &filename, OutputList *outputList)
+{
+    StdIStream stream(istr);
+    readStream(stream, filename, outputList);
+}
+
+template<class Stream>
+void simplecpp::TokenList::readStream(Stream &istr, const std::string &filename, OutputList *outputList)
 {
     std::stack<simplecpp::Location> loc;
 
@@ -1125,7 +1304,8 @@ void simplecpp::TokenList::removeComments()
     }
 }
 
-std::string simplecpp::TokenList::readUntil(std::istream &istr, const Location &location, const char start, const char end, OutputList *outputList, unsigned int bom)
+template<class Stream>
+std::string simplecpp::TokenList::readUntil(Stream &istr, const Location &location, const char start, const char end, OutputList *outputList, unsigned int bom)
 {
     std::string ret;
     ret += start;
@@ -2439,7 +2619,358 @@ static bool hasFile(const std::map<std::string, simplecpp::TokenList *> &filedat
     return !getFileName(filedata, sourcefile, header, dui, systemheader).empty();
 }
 
-std::map<std::string, simplecpp::TokenList*> simplecpp::load(const simplecpp::TokenList &rawtokens, std::vector<std::string> &fileNumbers, const simplecpp::DUI &dui, simplecpp::OutputList *outputList)
+struct simplecpp::HeaderCache::Entry {
+    struct CachedToken {
+        std::string str;
+        unsigned int fileIndex;
+        unsigned int line;
+        unsigned int col;
+    };
+    struct CachedOutput {
+        int type;
+        unsigned int fileIndex;
+        unsigned int line;
+        unsigned int col;
+        std::string msg;
+    };
+
+    Entry() : size(0), hash(0) {}
+
+    std::string filename;
+    unsigned long long size;
+    unsigned long long hash;
+    std::vector<std::string> files;
+    std::vector<CachedToken> tokens;
+    std::vector<CachedOutput> outputs;
+    std::list<std::string>::iterator lruPos;
+};
+
+struct simplecpp::HeaderCache::Data {
+    Data() : maxTokens(1000000U), tokenCount(0) {
+#ifdef SIMPLECPP_WINDOWS
+        InitializeCriticalSection(&criticalSection);
+#endif
+    }
+    ~Data() {
+        for (std::map<std::string, Entry *>::iterator it = entries.begin(); it != entries.end(); ++it)
+            delete it->second;
+#ifdef SIMPLECPP_WINDOWS
+        DeleteCriticalSection(&criticalSection);
+#endif
+    }
+
+    /** Remove the least recently used headers until the token limit is met */
+    void shrink() {
+        while (tokenCount > maxTokens && !lru.empty()) {
+            const std::map<std::string, Entry *>::iterator it = entries.find(lru.front());
+            tokenCount -= it->second->tokens.size();
+            delete it->second;
+            entries.erase(it);
+            lru.pop_front();
+        }
+    }
+
+    std::map<std::string, Entry *> entries;
+    /** filenames of the entries, least recently used first */
+    std::list<std::string> lru;
+    std::string directory;
+    std::size_t maxTokens;
+    std::size_t tokenCount;
+#ifdef SIMPLECPP_WINDOWS
+    CRITICAL_SECTION criticalSection;
+#elif __cplusplus >= 201103L
+    std::mutex mutex;
+#endif
+};
+
+#ifdef SIMPLECPP_WINDOWS
+#define HEADERCACHE_LOCK(data) ScopedLock headerCacheLock((data)->criticalSection)
+#elif __cplusplus >= 201103L
+#define HEADERCACHE_LOCK(data) std::lock_guard<std::mutex> headerCacheLock((data)->mutex)
+#else
+#define HEADERCACHE_LOCK(data) (void)(data)
+#endif
+
+/** FNV-1a hash */
+static unsigned long long hashData(const char *data, std::size_t size, unsigned long long hash = 14695981039346656037ULL)
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+template<class T>
+static void writeCacheValue(std::string &buffer, T value)
+{
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+static void writeCacheValue(std::string &buffer, const std::string &str)
+{
+    writeCacheValue(buffer, static_cast<unsigned int>(str.size()));
+    buffer.append(str);
+}
+
+template<class T>
+static bool readCacheValue(const char *&pos, const char *end, T &value)
+{
+    if (static_cast<std::size_t>(end - pos) < sizeof(value))
+        return false;
+    std::memcpy(&value, pos, sizeof(value));
+    pos += sizeof(value);
+    return true;
+}
+
+static bool readCacheValue(const char *&pos, const char *end, std::string &str)
+{
+    unsigned int len = 0;
+    if (!readCacheValue(pos, end, len) || static_cast<std::size_t>(end - pos) < len)
+        return false;
+    str.assign(pos, len);
+    pos += len;
+    return true;
+}
+
+static const char HEADERCACHE_MAGIC[] = "simplecpp-tokens-1";
+
+simplecpp::HeaderCache::HeaderCache() : data(new Data) {}
+
+simplecpp::HeaderCache::~HeaderCache()
+{
+    delete data;
+}
+
+void simplecpp::HeaderCache::setDirectory(const std::string &dir)
+{
+    HEADERCACHE_LOCK(data);
+    data->directory = dir;
+}
+
+void simplecpp::HeaderCache::setMaxTokens(std::size_t maxTokens)
+{
+    HEADERCACHE_LOCK(data);
+    data->maxTokens = maxTokens;
+    data->shrink();
+}
+
+std::size_t simplecpp::HeaderCache::tokenCount() const
+{
+    HEADERCACHE_LOCK(data);
+    return data->tokenCount;
+}
+
+void simplecpp::HeaderCache::clear()
+{
+    HEADERCACHE_LOCK(data);
+    for (std::map<std::string, Entry *>::iterator it = data->entries.begin(); it != data->entries.end(); ++it)
+        delete it->second;
+    data->entries.clear();
+    data->lru.clear();
+    data->tokenCount = 0;
+}
+
+std::string simplecpp::HeaderCache::cacheFileName(const std::string &directory, const std::string &filename)
+{
+    std::ostringstream ostr;
+    ostr << std::hex << hashData(filename.data(), filename.size());
+    const std::string::size_type pos = filename.find_last_of("\\/");
+    const std::string basename = (pos == std::string::npos) ? filename : filename.substr(pos + 1);
+    std::string dir = directory;
+    if (!dir.empty() && dir[dir.size() - 1U] != '/' && dir[dir.size() - 1U] != '\\')
+        dir += '/';
+    return dir + basename + '.' + ostr.str() + ".tokens";
+}
+
+simplecpp::HeaderCache::Entry *simplecpp::HeaderCache::readEntry(const std::string &directory, const std::string &filename)
+{
+    std::ifstream fin(cacheFileName(directory, filename).c_str(), std::ios::binary);
+    if (!fin.is_open())
+        return NULL;
+    std::ostringstream ostr;
+    ostr << fin.rdbuf();
+    const std::string buffer = ostr.str();
+
+    // The data ends with a checksum so a file that is written by another process at the same time is ignored
+    unsigned long long checksum = 0;
+    if (buffer.size() < sizeof(HEADERCACHE_MAGIC) + sizeof(checksum) || buffer.compare(0, sizeof(HEADERCACHE_MAGIC), HEADERCACHE_MAGIC, sizeof(HEADERCACHE_MAGIC)) != 0)
+        return NULL;
+    const char *pos = buffer.data() + sizeof(HEADERCACHE_MAGIC);
+    const char *end = buffer.data() + buffer.size() - sizeof(checksum);
+    std::memcpy(&checksum, end, sizeof(checksum));
+    if (checksum != hashData(buffer.data(), buffer.size() - sizeof(checksum)))
+        return NULL;
+
+    Entry *entry = new Entry;
+    unsigned int count = 0;
+    bool ok = readCacheValue(pos, end, entry->filename) && entry->filename == filename &&
+              readCacheValue(pos, end, entry->size) &&
+              readCacheValue(pos, end, entry->hash) &&
+              readCacheValue(pos, end, count);
+    for (unsigned int i = 0; ok && i < count; ++i) {
+        entry->files.push_back(std::string());
+        ok = readCacheValue(pos, end, entry->files.back());
+    }
+    ok = ok && readCacheValue(pos, end, count);
+    for (unsigned int i = 0; ok && i < count; ++i) {
+        entry->tokens.push_back(Entry::CachedToken());
+        Entry::CachedToken &tok = entry->tokens.back();
+        ok = readCacheValue(pos, end, tok.str) &&
+             readCacheValue(pos, end, tok.fileIndex) &&
+             readCacheValue(pos, end, tok.line) &&
+             readCacheValue(pos, end, tok.col) &&
+             tok.fileIndex < entry->files.size();
+    }
+    ok = ok && readCacheValue(pos, end, count);
+    for (unsigned int i = 0; ok && i < count; ++i) {
+        entry->outputs.push_back(Entry::CachedOutput());
+        Entry::CachedOutput &out = entry->outputs.back();
+        ok = readCacheValue(pos, end, out.type) &&
+             readCacheValue(pos, end, out.fileIndex) &&
+             readCacheValue(pos, end, out.line) &&
+             readCacheValue(pos, end, out.col) &&
+             readCacheValue(pos, end, out.msg);
+    }
+    if (!ok || pos != end) {
+        delete entry;
+        return NULL;
+    }
+    return entry;
+}
+
+void simplecpp::HeaderCache::writeEntry(const std::string &directory, const Entry &entry)
+{
+    std::string buffer(HEADERCACHE_MAGIC, sizeof(HEADERCACHE_MAGIC));
+    writeCacheValue(buffer, entry.filename);
+    writeCacheValue(buffer, entry.size);
+    writeCacheValue(buffer, entry.hash);
+    writeCacheValue(buffer, static_cast<unsigned int>(entry.files.size()));
+    for (std::vector<std::string>::const_iterator it = entry.files.begin(); it != entry.files.end(); ++it)
+        writeCacheValue(buffer, *it);
+    writeCacheValue(buffer, static_cast<unsigned int>(entry.tokens.size()));
+    for (std::vector<Entry::CachedToken>::const_iterator it = entry.tokens.begin(); it != entry.tokens.end(); ++it) {
+        writeCacheValue(buffer, it->str);
+        writeCacheValue(buffer, it->fileIndex);
+        writeCacheValue(buffer, it->line);
+        writeCacheValue(buffer, it->col);
+    }
+    writeCacheValue(buffer, static_cast<unsigned int>(entry.outputs.size()));
+    for (std::vector<Entry::CachedOutput>::const_iterator it = entry.outputs.begin(); it != entry.outputs.end(); ++it) {
+        writeCacheValue(buffer, it->type);
+        writeCacheValue(buffer, it->fileIndex);
+        writeCacheValue(buffer, it->line);
+        writeCacheValue(buffer, it->col);
+        writeCacheValue(buffer, it->msg);
+    }
+    writeCacheValue(buffer, hashData(buffer.data(), buffer.size()));
+
+    std::ofstream fout(cacheFileName(directory, entry.filename).c_str(), std::ios::binary);
+    fout.write(buffer.data(), buffer.size());
+}
+
+simplecpp::TokenList *simplecpp::HeaderCache::createTokenList(const Entry &entry, std::vector<std::string> &filenames, OutputList *outputList) const
+{
+    // The file indexes of the cached tokens are changed to the indexes in filenames
+    std::vector<unsigned int> fileIndexes;
+    for (std::vector<std::string>::const_iterator it = entry.files.begin(); it != entry.files.end(); ++it) {
+        const std::vector<std::string>::const_iterator f = std::find(filenames.begin(), filenames.end(), *it);
+        if (f != filenames.end())
+            fileIndexes.push_back(static_cast<unsigned int>(f - filenames.begin()));
+        else {
+            fileIndexes.push_back(static_cast<unsigned int>(filenames.size()));
+            filenames.push_back(*it);
+        }
+    }
+
+    TokenList *tokens = new TokenList(filenames);
+    Location location(filenames);
+    for (std::vector<Entry::CachedToken>::const_iterator it = entry.tokens.begin(); it != entry.tokens.end(); ++it) {
+        location.fileIndex = fileIndexes[it->fileIndex];
+        location.line = it->line;
+        location.col = it->col;
+        tokens->push_back(new Token(it->str, location));
+    }
+
+    if (outputList) {
+        for (std::vector<Entry::CachedOutput>::const_iterator it = entry.outputs.begin(); it != entry.outputs.end(); ++it) {
+            Output output(filenames);
+            output.type = static_cast<Output::Type>(it->type);
+            output.location.fileIndex = it->fileIndex < fileIndexes.size() ? fileIndexes[it->fileIndex] : it->fileIndex;
+            output.location.line = it->line;
+            output.location.col = it->col;
+            output.msg = it->msg;
+            outputList->push_back(output);
+        }
+    }
+
+    return tokens;
+}
+
+simplecpp::TokenList *simplecpp::HeaderCache::tokenize(std::istream &istr, std::vector<std::string> &filenames, const std::string &filename, OutputList *outputList)
+{
+    std::ostringstream ostr;
+    ostr << istr.rdbuf();
+    const std::string contents = ostr.str();
+    const unsigned long long size = contents.size();
+    const unsigned long long hash = hashData(contents.data(), contents.size());
+
+    std::string directory;
+    {
+        HEADERCACHE_LOCK(data);
+        const std::map<std::string, Entry *>::const_iterator it = data->entries.find(filename);
+        if (it != data->entries.end() && it->second->size == size && it->second->hash == hash) {
+            data->lru.splice(data->lru.end(), data->lru, it->second->lruPos);
+            return createTokenList(*it->second, filenames, outputList);
+        }
+        directory = data->directory;
+    }
+
+    // Not cached or the file has changed
+    Entry *entry = directory.empty() ? NULL : readEntry(directory, filename);
+    if (entry && (entry->size != size || entry->hash != hash)) {
+        delete entry;
+        entry = NULL;
+    }
+
+    if (!entry) {
+        entry = new Entry;
+        entry->filename = filename;
+        entry->size = size;
+        entry->hash = hash;
+
+        OutputList outputs;
+        const TokenList tokens(contents.data(), contents.size(), entry->files, filename, &outputs);
+        for (const Token *tok = tokens.cfront(); tok; tok = tok->next) {
+            const Entry::CachedToken cachedToken = { tok->str(), tok->location.fileIndex, tok->location.line, tok->location.col };
+            entry->tokens.push_back(cachedToken);
+        }
+        for (OutputList::const_iterator it = outputs.begin(); it != outputs.end(); ++it) {
+            const Entry::CachedOutput cachedOutput = { it->type, it->location.fileIndex, it->location.line, it->location.col, it->msg };
+            entry->outputs.push_back(cachedOutput);
+        }
+
+        if (!directory.empty())
+            writeEntry(directory, *entry);
+    }
+
+    TokenList *tokens = createTokenList(*entry, filenames, outputList);
+
+    HEADERCACHE_LOCK(data);
+    Entry *&cached = data->entries[filename];
+    if (cached) {
+        data->tokenCount -= cached->tokens.size();
+        data->lru.erase(cached->lruPos);
+        delete cached;
+    }
+    cached = entry;
+    entry->lruPos = data->lru.insert(data->lru.end(), filename);
+    data->tokenCount += entry->tokens.size();
+    data->shrink();
+    return tokens;
+}
+
+std::map<std::string, simplecpp::TokenList*> simplecpp::load(const simplecpp::TokenList &rawtokens, std::vector<std::string> &fileNumbers, const simplecpp::DUI &dui, simplecpp::OutputList *outputList, simplecpp::HeaderCache *headerCache)
 {
     std::map<std::string, simplecpp::TokenList*> ret;
 
@@ -2464,7 +2995,7 @@ std::map<std::string, simplecpp::TokenList*> simplecpp::load(const simplecpp::To
             continue;
         }
 
-        TokenList *tokenlist = new TokenList(fin, fileNumbers, filename, outputList);
+        TokenList *tokenlist = headerCache ? headerCache->tokenize(fin, fileNumbers, filename, outputList) : new TokenList(fin, fileNumbers, filename, outputList);
         if (!tokenlist->front()) {
             delete tokenlist;
             continue;
@@ -2504,7 +3035,7 @@ std::map<std::string, simplecpp::TokenList*> simplecpp::load(const simplecpp::To
         if (!f.is_open())
             continue;
 
-        TokenList *tokens = new TokenList(f, fileNumbers, header2, outputList);
+        TokenList *tokens = headerCache ? headerCache->tokenize(f, fileNumbers, header2, outputList) : new TokenList(f, fileNumbers, header2, outputList);
         ret[header2] = tokens;
         if (tokens->front())
             filelist.push_back(tokens->front());
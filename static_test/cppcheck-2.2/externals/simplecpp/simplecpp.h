@@ -181,6 +181,16 @@ namespace simplecpp {
     public:
         explicit TokenList(std::vector<std::string> &filenames);
         TokenList(std::istream &istr, std::vector<std::string> &filenames, const std::string &filename=std::string(), OutputList *outputList = NULL);
+        /** Tokenize the data in a buffer, the data is not copied */
+        TokenList(const char *data, std::size_t size, std::vector<std::string> &filenames, const std::string &filename=std::string(), OutputList *outputList = NULL);
+        /**
+         * Tokenize a file, the file is memory mapped when possible. The
+         * file must not be truncated while it is tokenized, reading the
+         * mapped pages past the new end of the file raises SIGBUS.
+         */
+        TokenList(const std::string &filename, std::vector<std::string> &filenames, OutputList *outputList = NULL);
+        /** Tokenize the file at path like above, the locations refer to filename */
+        TokenList(const std::string &path, const std::string &filename, std::vector<std::string> &filenames, OutputList *outputList = NULL);
         TokenList(const TokenList &other);
 #if __cplusplus >= 201103L
         TokenList(TokenList &&other);
@@ -265,7 +275,10 @@ namespace simplecpp {
         void constFoldLogicalOp(Token *tok);
         void constFoldQuestionOp(Token **tok1);
 
-        std::string readUntil(std::istream &istr, const Location &location, char start, char end, OutputList *outputList, unsigned int bom);
+        template<class Stream>
+        void readStream(Stream &stream, const std::string &filename, OutputList *outputList);
+        template<class Stream>
+        std::string readUntil(Stream &stream, const Location &location, char start, char end, OutputList *outputList, unsigned int bom);
         void lineDirective(unsigned int fileIndex, unsigned int line, Location *location);
 
         std::string lastLine(int maxsize=100000) const;
@@ -298,7 +311,68 @@ namespace simplecpp {
         std::list<std::string> includes;
     };
 
-    SIMPLECPP_LIB std::map<std::string, TokenList*> load(const TokenList &rawtokens, std::vector<std::string> &filenames, const DUI &dui, OutputList *outputList = NULL);
+    /**
+     * Cache of the raw tokens of included files that is shared by several
+     * calls of load(), so a header is tokenized once and not for every
+     * source file that includes it. A cached header is used as long as the
+     * file contents are unchanged. Optionally the tokens are stored in a
+     * directory so they are reused by later runs.
+     * The cache can be used by several threads.
+     */
+    class SIMPLECPP_LIB HeaderCache {
+    public:
+        HeaderCache();
+        ~HeaderCache();
+
+        /** Directory where the tokens are stored, empty to only cache them in memory */
+        void setDirectory(const std::string &dir);
+
+        /** Limit the number of tokens kept in memory, the least recently used headers are removed first (default: 1000000) */
+        void setMaxTokens(std::size_t maxTokens);
+
+        /** Number of tokens kept in memory */
+        std::size_t tokenCount() const;
+
+        /**
+         * Tokenize a file, or copy the tokens from the cache.
+         * @param istr the opened file
+         * @param filenames internal data of simplecpp
+         * @param filename name of the file
+         * @param outputList output: list that will receive output messages
+         * @return token list, the caller owns it
+         */
+        TokenList *tokenize(std::istream &istr, std::vector<std::string> &filenames, const std::string &filename, OutputList *outputList);
+
+        /** Remove all headers from the memory cache */
+        void clear();
+
+        /** Name of the file in directory where the tokens of filename are stored */
+        static std::string cacheFileName(const std::string &directory, const std::string &filename);
+
+    private:
+        struct Entry;
+        struct Data;
+
+        TokenList *createTokenList(const Entry &entry, std::vector<std::string> &filenames, OutputList *outputList) const;
+        static Entry *readEntry(const std::string &directory, const std::string &filename);
+        static void writeEntry(const std::string &directory, const Entry &entry);
+
+        Data *data;
+
+        // Not implemented - prevent copy
+        HeaderCache(const HeaderCache &);
+        HeaderCache &operator=(const HeaderCache &);
+    };
+
+    /**
+     * Load the files included by rawtokens
+     * @param rawtokens Raw tokenlist for top sourcefile
+     * @param filenames internal data of simplecpp
+     * @param dui defines, undefs, and include paths
+     * @param outputList output: list that will receive output messages
+     * @param headerCache optional cache of tokenized headers
+     */
+    SIMPLECPP_LIB std::map<std::string, TokenList*> load(const TokenList &rawtokens, std::vector<std::string> &filenames, const DUI &dui, OutputList *outputList = NULL, HeaderCache *headerCache = NULL);
 
     /**
      * Preprocess
@@ -23,10 +23,23 @@
 #include "utils.h"
 
 #include <tinyxml2.h>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <map>
 #include <sstream>
 
+/** Start of a binary analyzer info file, followed by the format version and the checksum */
+static const char BinaryMagic[] = {'C', 'P', 'P', 'C', 'H', 'K', 'A', 'I'};
+static const std::uint32_t BinaryVersion = 1;
+
+/** Records of a binary analyzer info file */
+enum BinaryRecord : std::uint8_t { BinaryError = 'e', BinaryFileInfo = 'f', BinaryEnd = 'z' };
+
+AnalyzerInformation::AnalyzerInformation() : mBinary(false)
+{
+}
+
 AnalyzerInformation::~AnalyzerInformation()
 {
     close();
@@ -61,19 +74,128 @@ void AnalyzerInformation::writeFilesTxt(const std::string &buildDir, const std::
     }
 }
 
+std::map<std::string, std::size_t> AnalyzerInformation::readFileTimings(const std::string &buildDir)
+{
+    std::map<std::string, std::size_t> timings;
+
+    std::ifstream fin(buildDir + "/timings.txt");
+    std::string line;
+    while (std::getline(fin, line)) {
+        // milliseconds:cfg:sourcefile
+        const std::string::size_type pos = line.find(':');
+        if (pos == std::string::npos || pos == 0)
+            continue;
+        timings[line.substr(pos + 1)] = std::strtoul(line.c_str(), nullptr, 10);
+    }
+    return timings;
+}
+
+void AnalyzerInformation::writeFileTimings(const std::string &buildDir, const std::map<std::string, std::size_t> &timings)
+{
+    std::ofstream fout(buildDir + "/timings.txt");
+    for (std::map<std::string, std::size_t>::const_iterator it = timings.begin(); it != timings.end(); ++it)
+        fout << it->second << ':' << it->first << '\n';
+}
+
 void AnalyzerInformation::close()
 {
     mAnalyzerInfoFile.clear();
     if (mOutputStream.is_open()) {
-        mOutputStream << "</analyzerinfo>\n";
+        if (mBinary)
+            mOutputStream.put(static_cast<char>(BinaryEnd));
+        else
+            mOutputStream << "</analyzerinfo>\n";
         mOutputStream.close();
     }
 }
 
-static bool skipAnalysis(const std::string &analyzerInfoFile, unsigned long long checksum, std::list<ErrorMessage> *errors)
+bool AnalyzerInformation::loadFile(const std::string &filename, std::string &data)
+{
+    std::ifstream fin(filename, std::ios::binary);
+    if (!fin.is_open() || !fin.seekg(0, std::ios::end))
+        return false;
+    const std::streamoff size = fin.tellg();
+    if (size < 0 || !fin.seekg(0, std::ios::beg))
+        return false;
+    data.resize(static_cast<std::size_t>(size));
+    return size == 0 || fin.read(&data[0], size);
+}
+
+bool AnalyzerInformation::isBinaryFile(const std::string &data)
+{
+    return data.compare(0, sizeof(BinaryMagic), BinaryMagic, sizeof(BinaryMagic)) == 0;
+}
+
+static bool parseBinaryHeader(const char *&data, const char *end, unsigned long long &checksum)
+{
+    std::uint32_t version = 0;
+    std::uint64_t sum = 0;
+    data += sizeof(BinaryMagic);
+    if (!readBinary(data, end, version) || version != BinaryVersion || !readBinary(data, end, sum))
+        return false;
+    checksum = sum;
+    return true;
+}
+
+bool AnalyzerInformation::parseBinary(const std::string &data, unsigned long long &checksum, std::list<ErrorMessage> *errors, std::list<std::pair<std::string, std::string>> *fileInfo)
 {
+    if (!isBinaryFile(data))
+        return false;
+    const char *pos = data.data();
+    const char * const end = pos + data.size();
+    if (!parseBinaryHeader(pos, end, checksum))
+        return false;
+
+    std::uint8_t record = 0;
+    while (readBinary(pos, end, record)) {
+        switch (record) {
+        case BinaryError: {
+            ErrorMessage errmsg;
+            if (!errmsg.deserializeBinary(pos, end))
+                return false;
+            if (errors)
+                errors->push_back(errmsg);
+            break;
+        }
+        case BinaryFileInfo: {
+            std::string check, info;
+            if (!readBinary(pos, end, check) || !readBinary(pos, end, info))
+                return false;
+            if (fileInfo)
+                fileInfo->emplace_back(check, info);
+            break;
+        }
+        case BinaryEnd:
+            return pos == end;
+        default:
+            return false;
+        }
+    }
+
+    // The file is truncated
+    return false;
+}
+
+static bool skipAnalysis(const std::string &analyzerInfoFile, unsigned long long checksum, bool binary, std::list<ErrorMessage> *errors)
+{
+    std::string data;
+    if (!AnalyzerInformation::loadFile(analyzerInfoFile, data) || AnalyzerInformation::isBinaryFile(data) != binary)
+        return false;
+
+    if (binary) {
+        const char *pos = data.data();
+        unsigned long long fileChecksum = 0;
+        if (!parseBinaryHeader(pos, pos + data.size(), fileChecksum) || fileChecksum != checksum)
+            return false;
+        std::list<ErrorMessage> fileErrors;
+        if (!AnalyzerInformation::parseBinary(data, fileChecksum, &fileErrors, nullptr))
+            return false;
+        errors->splice(errors->end(), fileErrors);
+        return true;
+    }
+
     tinyxml2::XMLDocument doc;
-    const tinyxml2::XMLError error = doc.LoadFile(analyzerInfoFile.c_str());
+    const tinyxml2::XMLError error = doc.Parse(data.c_str(), data.size());
     if (error != tinyxml2::XML_SUCCESS)
         return false;
 
@@ -123,36 +245,62 @@ std::string AnalyzerInformation::getAnalyzerInfoFile(const std::string &buildDir
     return filename;
 }
 
-bool AnalyzerInformation::analyzeFile(const std::string &buildDir, const std::string &sourcefile, const std::string &cfg, unsigned long long checksum, std::list<ErrorMessage> *errors)
+bool AnalyzerInformation::analyzeFile(const std::string &buildDir, const std::string &sourcefile, const std::string &cfg, unsigned long long checksum, bool binary, std::list<ErrorMessage> *errors)
 {
     if (buildDir.empty() || sourcefile.empty())
         return true;
     close();
 
     mAnalyzerInfoFile = AnalyzerInformation::getAnalyzerInfoFile(buildDir,sourcefile,cfg);
+    mBinary = binary;
 
-    if (skipAnalysis(mAnalyzerInfoFile, checksum, errors))
+    if (skipAnalysis(mAnalyzerInfoFile, checksum, binary, errors))
         return false;
 
-    mOutputStream.open(mAnalyzerInfoFile);
-    if (mOutputStream.is_open()) {
-        mOutputStream << "<?xml version=\"1.0\"?>\n";
-        mOutputStream << "<analyzerinfo checksum=\"" << checksum << "\">\n";
+    if (binary) {
+        mOutputStream.open(mAnalyzerInfoFile, std::ios::binary);
+        if (mOutputStream.is_open()) {
+            std::string header(BinaryMagic, sizeof(BinaryMagic));
+            appendBinary(header, BinaryVersion);
+            appendBinary(header, static_cast<std::uint64_t>(checksum));
+            mOutputStream.write(header.data(), header.size());
+        }
     } else {
-        mAnalyzerInfoFile.clear();
+        mOutputStream.open(mAnalyzerInfoFile);
+        if (mOutputStream.is_open()) {
+            mOutputStream << "<?xml version=\"1.0\"?>\n";
+            mOutputStream << "<analyzerinfo checksum=\"" << checksum << "\">\n";
+        }
     }
+    if (!mOutputStream.is_open())
+        mAnalyzerInfoFile.clear();
 
     return true;
 }
 
 void AnalyzerInformation::reportErr(const ErrorMessage &msg, bool /*verbose*/)
 {
-    if (mOutputStream.is_open())
+    if (!mOutputStream.is_open())
+        return;
+    if (mBinary) {
+        std::string record(1, static_cast<char>(BinaryError));
+        msg.serializeBinary(record);
+        mOutputStream.write(record.data(), record.size());
+    } else {
         mOutputStream << msg.toXML() << '\n';
+    }
 }
 
 void AnalyzerInformation::setFileInfo(const std::string &check, const std::string &fileInfo)
 {
-    if (mOutputStream.is_open() && !fileInfo.empty())
+    if (!mOutputStream.is_open() || fileInfo.empty())
+        return;
+    if (mBinary) {
+        std::string record(1, static_cast<char>(BinaryFileInfo));
+        appendBinary(record, check);
+        appendBinary(record, fileInfo);
+        mOutputStream.write(record.data(), record.size());
+    } else {
         mOutputStream << "  <FileInfo check=\"" << check << "\">\n" << fileInfo << "  </FileInfo>\n";
+    }
 }
@@ -24,9 +24,12 @@
 #include "config.h"
 #include "importproject.h"
 
+#include <cstddef>
 #include <fstream>
 #include <list>
+#include <map>
 #include <string>
+#include <utility>
 
 class ErrorMessage;
 
@@ -45,22 +48,67 @@ class ErrorMessage;
 * - 'make' - only analyze TUs that are changed and generate full report
 * - should be possible to add distributed analysis later
 * - multi-threaded whole program analysis
+*
+* The information is written as XML, or in a compact binary format that
+* is faster to read (--cppcheck-build-dir-format=binary). The binary
+* format uses the native byte order, it is only read by the same build of
+* Cppcheck.
 */
 class CPPCHECKLIB AnalyzerInformation {
 public:
+    AnalyzerInformation();
     ~AnalyzerInformation();
 
     static void writeFilesTxt(const std::string &buildDir, const std::list<std::string> &sourcefiles, const std::list<ImportProject::FileSettings> &fileSettings);
 
+    /**
+     * Read analysis times of the previous runs (timings.txt)
+     * @return milliseconds, key is "cfg:sourcefile"
+     */
+    static std::map<std::string, std::size_t> readFileTimings(const std::string &buildDir);
+    static void writeFileTimings(const std::string &buildDir, const std::map<std::string, std::size_t> &timings);
+
     /** Close current TU.analyzerinfo file */
     void close();
-    bool analyzeFile(const std::string &buildDir, const std::string &sourcefile, const std::string &cfg, unsigned long long checksum, std::list<ErrorMessage> *errors);
+
+    /**
+     * Open the analyzer info file of a TU
+     * @param binary write the file in the binary format instead of XML. A file in the other format is not reused.
+     * @param errors the errors of the previous analysis are added here if it can be reused
+     * @return false if the previous analysis can be reused
+     */
+    bool analyzeFile(const std::string &buildDir, const std::string &sourcefile, const std::string &cfg, unsigned long long checksum, bool binary, std::list<ErrorMessage> *errors);
     void reportErr(const ErrorMessage &msg, bool verbose);
+
+    /** @param fileInfo XML or binary data, see isBinary() */
     void setFileInfo(const std::string &check, const std::string &fileInfo);
+
+    /** Is the current TU.analyzerinfo file written in the binary format? */
+    bool isBinary() const {
+        return mBinary;
+    }
+
     static std::string getAnalyzerInfoFile(const std::string &buildDir, const std::string &sourcefile, const std::string &cfg);
+
+    /** Read the whole analyzer info file into data */
+    static bool loadFile(const std::string &filename, std::string &data);
+
+    /** Is data a binary analyzer info file? Otherwise it is XML */
+    static bool isBinaryFile(const std::string &data);
+
+    /**
+     * Parse a binary analyzer info file
+     * @param data content of the file
+     * @param checksum the checksum of the file is written here
+     * @param errors the errors are added here, nullptr if they are not needed
+     * @param fileInfo the file info of the checks are added here (check name, data), nullptr if they are not needed
+     * @return false if the data is not a complete binary analyzer info file of this version
+     */
+    static bool parseBinary(const std::string &data, unsigned long long &checksum, std::list<ErrorMessage> *errors, std::list<std::pair<std::string, std::string>> *fileInfo);
 private:
     std::ofstream mOutputStream;
     std::string mAnalyzerInfoFile;
+    bool mBinary;
 };
 
 /// @}
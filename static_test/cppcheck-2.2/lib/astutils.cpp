@@ -1175,9 +1175,9 @@ bool isUniqueExpression(const Token* tok)
         const Type * varType = var->type();
         // Iterate over the variables in scope and the parameters of the function if possible
         const Function * fun = scope->function;
-        const std::list<Variable>* setOfVars[] = {&scope->varlist, fun ? &fun->argumentList : nullptr};
+        const ChunkedList<Variable>* setOfVars[] = {&scope->varlist, fun ? &fun->argumentList : nullptr};
 
-        for (const std::list<Variable>* vars:setOfVars) {
+        for (const ChunkedList<Variable>* vars:setOfVars) {
             if (!vars)
                 continue;
             bool other = std::any_of(vars->cbegin(), vars->cend(), [=](const Variable &v) {
@@ -1661,7 +1661,7 @@ Token* findVariableChanged(Token *start, const Token *end, int indirect, const n
                 // TODO: Is global variable really changed by function call?
                 return tok;
             // Is aliased function call
-            if (Token::Match(tok, "%var% (") && std::any_of(tok->values().begin(), tok->values().end(), std::mem_fn(&ValueFlow::Value::isLifetimeValue))) {
+            if (std::any_of(tok->values().begin(), tok->values().end(), std::mem_fn(&ValueFlow::Value::isLifetimeValue)) && Token::Match(tok, "%var% (")) {
                 bool aliased = false;
                 // If we cant find the expression then assume it was modified
                 if (!getExprTok())
@@ -102,6 +102,10 @@ public:
         virtual std::string toString() const {
             return std::string();
         }
+        /** Binary format of the analyzer info (--cppcheck-build-dir-format=binary) */
+        virtual std::string toBinary() const {
+            return std::string();
+        }
     };
 
     virtual FileInfo * getFileInfo(const Tokenizer *tokenizer, const Settings *settings) const {
@@ -115,6 +119,13 @@ public:
         return nullptr;
     }
 
+    /** Load file info written by FileInfo::toBinary() */
+    virtual FileInfo * loadFileInfoFromBinary(const char *data, const char *end) const {
+        (void)data;
+        (void)end;
+        return nullptr;
+    }
+
     // Return true if an error is reported.
     virtual bool analyseWholeProgram(const CTU::FileInfo *ctu, const std::list<FileInfo*> &fileInfo, const Settings& /*settings*/, ErrorLogger &/*errorLogger*/) {
         (void)ctu;
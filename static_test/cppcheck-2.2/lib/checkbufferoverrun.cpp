@@ -753,6 +753,11 @@ std::string CheckBufferOverrun::MyFileInfo::toString() const
     return xml;
 }
 
+std::string CheckBufferOverrun::MyFileInfo::toBinary() const
+{
+    return CTU::toBinary(unsafeArrayIndex) + CTU::toBinary(unsafePointerArith);
+}
+
 bool CheckBufferOverrun::isCtuUnsafeBufferUsage(const Check *check, const Token *argtok, MathLib::bigint *offset, int type)
 {
     const CheckBufferOverrun *c = dynamic_cast<const CheckBufferOverrun *>(check);
@@ -822,6 +827,19 @@ Check::FileInfo * CheckBufferOverrun::loadFileInfoFromXml(const tinyxml2::XMLEle
     return fileInfo;
 }
 
+Check::FileInfo * CheckBufferOverrun::loadFileInfoFromBinary(const char *data, const char *end) const
+{
+    MyFileInfo *fileInfo = new MyFileInfo;
+    if (!CTU::loadUnsafeUsageListFromBinary(data, end, fileInfo->unsafeArrayIndex) ||
+        !CTU::loadUnsafeUsageListFromBinary(data, end, fileInfo->unsafePointerArith) ||
+        (fileInfo->unsafeArrayIndex.empty() && fileInfo->unsafePointerArith.empty())) {
+        delete fileInfo;
+        return nullptr;
+    }
+
+    return fileInfo;
+}
+
 /** @brief Analyse all file infos for all TU */
 bool CheckBufferOverrun::analyseWholeProgram(const CTU::FileInfo *ctu, const std::list<Check::FileInfo*> &fileInfo, const Settings& settings, ErrorLogger &errorLogger)
 {
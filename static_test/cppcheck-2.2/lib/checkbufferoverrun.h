@@ -131,6 +131,9 @@ private:
 
         /** Convert MyFileInfo data into xml string */
         std::string toString() const OVERRIDE;
+
+        /** Convert MyFileInfo data into the binary analyzer info format */
+        std::string toBinary() const OVERRIDE;
     };
 
     static bool isCtuUnsafeBufferUsage(const Check *check, const Token *argtok, MathLib::bigint *offset, int type);
@@ -138,6 +141,8 @@ private:
     static bool isCtuUnsafePointerArith(const Check *check, const Token *argtok, MathLib::bigint *offset);
 
     Check::FileInfo * loadFileInfoFromXml(const tinyxml2::XMLElement *xmlElement) const OVERRIDE;
+
+    Check::FileInfo * loadFileInfoFromBinary(const char *data, const char *end) const OVERRIDE;
     bool analyseWholeProgram1(const CTU::FileInfo *ctu, const std::map<std::string, std::list<const CTU::FileInfo::CallBase *>> &callsMap, const CTU::FileInfo::UnsafeUsage &unsafeUsage, int type, ErrorLogger &errorLogger);
 
 
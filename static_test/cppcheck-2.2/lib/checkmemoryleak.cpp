@@ -417,7 +417,7 @@ const char *CheckMemoryLeak::functionArgAlloc(const Function *func, nonneg int t
     if (!Token::simpleMatch(func->retDef, "void"))
         return "";
 
-    std::list<Variable>::const_iterator arg = func->argumentList.begin();
+    ChunkedList<Variable>::const_iterator arg = func->argumentList.begin();
     for (; arg != func->argumentList.end(); ++arg) {
         if (arg->index() == targetpar-1)
             break;
@@ -539,6 +539,11 @@ std::string CheckNullPointer::MyFileInfo::toString() const
     return CTU::toString(unsafeUsage);
 }
 
+std::string CheckNullPointer::MyFileInfo::toBinary() const
+{
+    return CTU::toBinary(unsafeUsage);
+}
+
 static bool isUnsafeUsage(const Check *check, const Token *vartok, MathLib::bigint *value)
 {
     (void)value;
@@ -570,6 +575,17 @@ Check::FileInfo * CheckNullPointer::loadFileInfoFromXml(const tinyxml2::XMLEleme
     return fileInfo;
 }
 
+Check::FileInfo * CheckNullPointer::loadFileInfoFromBinary(const char *data, const char *end) const
+{
+    std::list<CTU::FileInfo::UnsafeUsage> unsafeUsage;
+    if (!CTU::loadUnsafeUsageListFromBinary(data, end, unsafeUsage) || unsafeUsage.empty())
+        return nullptr;
+
+    MyFileInfo *fileInfo = new MyFileInfo;
+    fileInfo->unsafeUsage.swap(unsafeUsage);
+    return fileInfo;
+}
+
 bool CheckNullPointer::analyseWholeProgram(const CTU::FileInfo *ctu, const std::list<Check::FileInfo*> &fileInfo, const Settings& settings, ErrorLogger &errorLogger)
 {
     if (!ctu)
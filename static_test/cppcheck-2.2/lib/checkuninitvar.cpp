@@ -1394,6 +1394,11 @@ std::string CheckUninitVar::MyFileInfo::toString() const
     return CTU::toString(unsafeUsage);
 }
 
+std::string CheckUninitVar::MyFileInfo::toBinary() const
+{
+    return CTU::toBinary(unsafeUsage);
+}
+
 Check::FileInfo *CheckUninitVar::getFileInfo(const Tokenizer *tokenizer, const Settings *settings) const
 {
     const CheckUninitVar checker(tokenizer, settings, nullptr);
@@ -1429,6 +1434,17 @@ Check::FileInfo * CheckUninitVar::loadFileInfoFromXml(const tinyxml2::XMLElement
     return fileInfo;
 }
 
+Check::FileInfo * CheckUninitVar::loadFileInfoFromBinary(const char *data, const char *end) const
+{
+    std::list<CTU::FileInfo::UnsafeUsage> unsafeUsage;
+    if (!CTU::loadUnsafeUsageListFromBinary(data, end, unsafeUsage) || unsafeUsage.empty())
+        return nullptr;
+
+    MyFileInfo *fileInfo = new MyFileInfo;
+    fileInfo->unsafeUsage.swap(unsafeUsage);
+    return fileInfo;
+}
+
 bool CheckUninitVar::analyseWholeProgram(const CTU::FileInfo *ctu, const std::list<Check::FileInfo*> &fileInfo, const Settings& settings, ErrorLogger &errorLogger)
 {
     if (!ctu)
@@ -98,6 +98,9 @@ public:
 
         /** Convert MyFileInfo data into xml string */
         std::string toString() const OVERRIDE;
+
+        /** Convert MyFileInfo data into the binary analyzer info format */
+        std::string toBinary() const OVERRIDE;
     };
 
     /** @brief Parse current TU and extract file info */
@@ -105,6 +108,8 @@ public:
 
     Check::FileInfo * loadFileInfoFromXml(const tinyxml2::XMLElement *xmlElement) const OVERRIDE;
 
+    Check::FileInfo * loadFileInfoFromBinary(const char *data, const char *end) const OVERRIDE;
+
     /** @brief Analyse all file infos for all TU */
     bool analyseWholeProgram(const CTU::FileInfo *ctu, const std::list<Check::FileInfo*> &fileInfo, const Settings& settings, ErrorLogger &errorLogger) OVERRIDE;
 
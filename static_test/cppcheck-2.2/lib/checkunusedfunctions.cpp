@@ -20,6 +20,7 @@
 //---------------------------------------------------------------------------
 #include "checkunusedfunctions.h"
 
+#include "analyzerinfo.h"
 #include "astutils.h"
 #include "errorlogger.h"
 #include "library.h"
@@ -28,12 +29,15 @@
 #include "token.h"
 #include "tokenize.h"
 #include "tokenlist.h"
+#include "utils.h"
 
 #include <tinyxml2.h>
 #include <algorithm>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <istream>
+#include <mutex>
 #include <utility>
 //---------------------------------------------------------------------------
 
@@ -347,8 +351,12 @@ Check::FileInfo *CheckUnusedFunctions::getFileInfo(const Tokenizer *tokenizer, c
 {
     if (!settings->isEnabled(Settings::UNUSED_FUNCTION))
         return nullptr;
-    if (settings->jobs == 1 && settings->buildDir.empty())
+    if (settings->jobs == 1 && settings->buildDir.empty()) {
+        // The configurations of a file can be checked in parallel (--config-jobs)
+        static std::mutex instanceSync;
+        std::lock_guard<std::mutex> instanceLock(instanceSync);
         instance.parseTokens(*tokenizer, tokenizer->list.getFiles().front().c_str(), settings);
+    }
     return nullptr;
 }
 
@@ -378,6 +386,28 @@ std::string CheckUnusedFunctions::analyzerInfo() const
     return ret.str();
 }
 
+std::string CheckUnusedFunctions::analyzerInfoBinary() const
+{
+    if (mFunctionDecl.empty() && mFunctionCalls.empty())
+        return std::string();
+    std::string ret;
+    appendBinary(ret, static_cast<std::uint32_t>(mFunctionDecl.size()));
+    for (const FunctionDecl &functionDecl : mFunctionDecl) {
+        appendBinary(ret, functionDecl.functionName);
+        appendBinary(ret, static_cast<std::int32_t>(functionDecl.lineNumber));
+    }
+    appendBinary(ret, static_cast<std::uint32_t>(mFunctionCalls.size()));
+    for (const std::string &fc : mFunctionCalls)
+        appendBinary(ret, fc);
+    return ret;
+}
+
+void CheckUnusedFunctions::addAnalyzerInfo(const CheckUnusedFunctions &other)
+{
+    mFunctionDecl.insert(mFunctionDecl.end(), other.mFunctionDecl.begin(), other.mFunctionDecl.end());
+    mFunctionCalls.insert(other.mFunctionCalls.begin(), other.mFunctionCalls.end());
+}
+
 namespace {
     struct Location {
         Location() : lineNumber(0) {}
@@ -387,6 +417,39 @@ namespace {
     };
 }
 
+static void loadAnalyzerInfoBinary(const std::string &data, const std::string &sourcefile, std::map<std::string, Location> &decls, std::set<std::string> &calls)
+{
+    unsigned long long checksum = 0;
+    std::list<std::pair<std::string, std::string>> fileInfo;
+    if (!AnalyzerInformation::parseBinary(data, checksum, nullptr, &fileInfo))
+        return;
+
+    for (const std::pair<std::string, std::string> &fi : fileInfo) {
+        if (fi.first != "CheckUnusedFunctions")
+            continue;
+        const char *pos = fi.second.data();
+        const char * const end = pos + fi.second.size();
+        std::uint32_t count = 0;
+        if (!readBinary(pos, end, count))
+            continue;
+        for (std::uint32_t i = 0; i < count; ++i) {
+            std::string functionName;
+            std::int32_t lineNumber = 0;
+            if (!readBinary(pos, end, functionName) || !readBinary(pos, end, lineNumber))
+                return;
+            decls[functionName] = Location(sourcefile, lineNumber);
+        }
+        if (!readBinary(pos, end, count))
+            continue;
+        for (std::uint32_t i = 0; i < count; ++i) {
+            std::string functionName;
+            if (!readBinary(pos, end, functionName))
+                return;
+            calls.insert(functionName);
+        }
+    }
+}
+
 void CheckUnusedFunctions::analyseWholeProgram(ErrorLogger * const errorLogger, const std::string &buildDir)
 {
     std::map<std::string, Location> decls;
@@ -405,8 +468,17 @@ void CheckUnusedFunctions::analyseWholeProgram(ErrorLogger * const errorLogger,
         const std::string xmlfile = buildDir + '/' + filesTxtLine.substr(0,firstColon);
         const std::string sourcefile = filesTxtLine.substr(secondColon+1);
 
+        std::string data;
+        if (!AnalyzerInformation::loadFile(xmlfile, data))
+            continue;
+
+        if (AnalyzerInformation::isBinaryFile(data)) {
+            loadAnalyzerInfoBinary(data, sourcefile, decls, calls);
+            continue;
+        }
+
         tinyxml2::XMLDocument doc;
-        const tinyxml2::XMLError error = doc.LoadFile(xmlfile.c_str());
+        const tinyxml2::XMLError error = doc.Parse(data.c_str(), data.size());
         if (error != tinyxml2::XML_SUCCESS)
             continue;
 
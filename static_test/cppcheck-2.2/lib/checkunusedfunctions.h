@@ -73,6 +73,12 @@ public:
 
     std::string analyzerInfo() const;
 
+    /** @brief analyzerInfo() in the binary analyzer info format */
+    std::string analyzerInfoBinary() const;
+
+    /** @brief Add the function declarations and calls that another instance has parsed */
+    void addAnalyzerInfo(const CheckUnusedFunctions &other);
+
     /** @brief Combine and analyze all analyzerInfos for all TUs */
     static void analyseWholeProgram(ErrorLogger * const errorLogger, const std::string &buildDir);
 
@@ -0,0 +1,304 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2020 Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef chunkedlistH
+#define chunkedlistH
+//---------------------------------------------------------------------------
+
+#include "config.h"
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Sequence container with the interface of std::list for the
+ * elements that are only appended and removed at the back.
+ *
+ * The elements are stored in chunks that are never reallocated, so
+ * pointers and references to the elements stay valid until the element
+ * is removed, just like in a std::list. The chunk sizes double (1, 2, 4, ...),
+ * so a container with n elements needs about log2(n) allocations and
+ * the elements are mostly contiguous when they are iterated.
+ */
+template <class T>
+class CPPCHECKLIB ChunkedList {
+    struct Chunk {
+        Chunk *prev;
+        Chunk *next;
+        std::size_t capacity;
+
+        T *elements() {
+            return reinterpret_cast<T *>(reinterpret_cast<char *>(this) + headerSize);
+        }
+    };
+
+    /** size of the chunk header, the elements follow it */
+    static const std::size_t headerSize = (sizeof(Chunk) + alignof(T) - 1) / alignof(T) * alignof(T);
+
+    template <class U>
+    class Iterator {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef U *pointer;
+        typedef U &reference;
+
+        Iterator() : mList(nullptr), mIndex(0), mChunk(nullptr), mPtr(nullptr), mChunkEnd(nullptr) {}
+
+        /** conversion from iterator to const_iterator */
+        template <class V, class = typename std::enable_if<std::is_same<U, const V>::value>::type>
+        // cppcheck-suppress noExplicitConstructor
+        Iterator(const Iterator<V> &other) : mList(other.mList), mIndex(other.mIndex), mChunk(other.mChunk), mPtr(other.mPtr), mChunkEnd(other.mChunkEnd) {}
+
+        reference operator*() const {
+            return *mPtr;
+        }
+        pointer operator->() const {
+            return mPtr;
+        }
+
+        Iterator &operator++() {
+            ++mIndex;
+            if (mIndex >= mList->mSize)
+                mPtr = nullptr;
+            else if (++mPtr == mChunkEnd)
+                setChunk(mChunk->next, 0);
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator it(*this);
+            ++*this;
+            return it;
+        }
+
+        Iterator &operator--() {
+            if (!mPtr) {
+                // the container might have grown since end() was taken
+                mIndex = mList->mSize - 1;
+                setChunk(mList->mLast, mList->mSize - mList->mLast->capacity);
+            } else if (mPtr == mChunk->elements()) {
+                --mIndex;
+                setChunk(mChunk->prev, mChunk->prev->capacity - 1);
+            } else {
+                --mIndex;
+                --mPtr;
+            }
+            return *this;
+        }
+        Iterator operator--(int) {
+            Iterator it(*this);
+            --*this;
+            return it;
+        }
+
+        template <class V>
+        bool operator==(const Iterator<V> &other) const {
+            return mPtr == other.mPtr;
+        }
+        template <class V>
+        bool operator!=(const Iterator<V> &other) const {
+            return mPtr != other.mPtr;
+        }
+
+    private:
+        friend class ChunkedList;
+        template <class V> friend class Iterator;
+
+        Iterator(const ChunkedList *list, std::size_t index) : mList(list), mIndex(index), mChunk(nullptr), mPtr(nullptr), mChunkEnd(nullptr) {
+            if (mIndex < mList->mSize)
+                setChunk(mList->mFirst, 0);
+        }
+
+        void setChunk(Chunk *chunk, std::size_t offset) {
+            mChunk = chunk;
+            mPtr = chunk->elements() + offset;
+            mChunkEnd = chunk->elements() + chunk->capacity;
+        }
+
+        const ChunkedList *mList;
+        std::size_t mIndex;
+        Chunk *mChunk;
+        /** current element, nullptr for the end iterator */
+        T *mPtr;
+        T *mChunkEnd;
+    };
+
+public:
+    typedef T value_type;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef Iterator<T> iterator;
+    typedef Iterator<const T> const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    ChunkedList() : mFirst(nullptr), mLast(nullptr), mSize(0) {}
+
+    ChunkedList(const ChunkedList &other) : mFirst(nullptr), mLast(nullptr), mSize(0) {
+        for (const T &t : other)
+            push_back(t);
+    }
+
+    ChunkedList(ChunkedList &&other) : mFirst(nullptr), mLast(nullptr), mSize(0) {
+        swap(other);
+    }
+
+    ~ChunkedList() {
+        clear();
+    }
+
+    ChunkedList &operator=(ChunkedList other) {
+        swap(other);
+        return *this;
+    }
+
+    void swap(ChunkedList &other) {
+        std::swap(mFirst, other.mFirst);
+        std::swap(mLast, other.mLast);
+        std::swap(mSize, other.mSize);
+    }
+
+    iterator begin() {
+        return iterator(this, 0);
+    }
+    const_iterator begin() const {
+        return const_iterator(this, 0);
+    }
+    const_iterator cbegin() const {
+        return begin();
+    }
+    iterator end() {
+        return iterator(this, mSize);
+    }
+    const_iterator end() const {
+        return const_iterator(this, mSize);
+    }
+    const_iterator cend() const {
+        return end();
+    }
+    reverse_iterator rbegin() {
+        return reverse_iterator(end());
+    }
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+    reverse_iterator rend() {
+        return reverse_iterator(begin());
+    }
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+
+    bool empty() const {
+        return mSize == 0;
+    }
+    size_type size() const {
+        return mSize;
+    }
+
+    T &front() {
+        return *mFirst->elements();
+    }
+    const T &front() const {
+        return *mFirst->elements();
+    }
+    T &back() {
+        return mLast->elements()[mSize - mLast->capacity];
+    }
+    const T &back() const {
+        return mLast->elements()[mSize - mLast->capacity];
+    }
+
+    void push_back(const T &t) {
+        emplace_back(t);
+    }
+    void push_back(T &&t) {
+        emplace_back(std::move(t));
+    }
+
+    template <class... Args>
+    T &emplace_back(Args&&... args) {
+        // chunk n holds the elements [2^n - 1, 2^(n+1) - 1)
+        if (((mSize + 1) & mSize) == 0)
+            addChunk(mSize + 1);
+        T *p = mLast->elements() + (mSize + 1 - mLast->capacity);
+        try {
+            ::new (static_cast<void *>(p)) T(std::forward<Args>(args)...);
+        } catch (...) {
+            if (p == mLast->elements())
+                removeChunk();
+            throw;
+        }
+        ++mSize;
+        return *p;
+    }
+
+    void pop_back() {
+        T *p = &back();
+        p->~T();
+        --mSize;
+        if (p == mLast->elements())
+            removeChunk();
+    }
+
+    void clear() {
+        while (!empty())
+            pop_back();
+    }
+
+private:
+    void addChunk(std::size_t capacity) {
+        Chunk *chunk = static_cast<Chunk *>(::operator new(headerSize + capacity * sizeof(T)));
+        chunk->prev = mLast;
+        chunk->next = nullptr;
+        chunk->capacity = capacity;
+        if (mLast)
+            mLast->next = chunk;
+        else
+            mFirst = chunk;
+        mLast = chunk;
+    }
+
+    void removeChunk() {
+        Chunk *chunk = mLast;
+        mLast = chunk->prev;
+        if (mLast)
+            mLast->next = nullptr;
+        else
+            mFirst = nullptr;
+        ::operator delete(chunk);
+    }
+
+    Chunk *mFirst;
+    Chunk *mLast;
+    std::size_t mSize;
+};
+
+/// @}
+//---------------------------------------------------------------------------
+#endif // chunkedlistH
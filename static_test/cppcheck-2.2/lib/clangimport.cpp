@@ -267,7 +267,7 @@ namespace clangimport {
         Token *addtoken(TokenList *tokenList, const std::string &str, bool valueType=true);
         void addTypeTokens(TokenList *tokenList, const std::string &str);
         Scope *createScope(TokenList *tokenList, Scope::ScopeType scopeType, AstNodePtr astNode, const Token *def);
-        Scope *createScope(TokenList *tokenList, Scope::ScopeType scopeType, const std::vector<AstNodePtr> &children, const Token *def);
+        Scope *createScope(TokenList *tokenList, Scope::ScopeType scopeType, const std::vector<AstNodePtr> &children, const Token *def, const std::string &className = emptyString);
         Token *createTokensCall(TokenList *tokenList);
         void createTokensFunctionDecl(TokenList *tokenList);
         void createTokensForCXXRecord(TokenList *tokenList);
@@ -480,7 +480,7 @@ Scope *clangimport::AstNode::createScope(TokenList *tokenList, Scope::ScopeType
     return createScope(tokenList, scopeType, children2, def);
 }
 
-Scope *clangimport::AstNode::createScope(TokenList *tokenList, Scope::ScopeType scopeType, const std::vector<AstNodePtr> & children2, const Token *def)
+Scope *clangimport::AstNode::createScope(TokenList *tokenList, Scope::ScopeType scopeType, const std::vector<AstNodePtr> & children2, const Token *def, const std::string &className)
 {
     SymbolDatabase *symbolDatabase = mData->mSymbolDatabase;
 
@@ -490,8 +490,9 @@ Scope *clangimport::AstNode::createScope(TokenList *tokenList, Scope::ScopeType
     Scope *scope = &symbolDatabase->scopeList.back();
     if (scopeType == Scope::ScopeType::eEnum)
         scope->enumeratorList.reserve(children2.size());
-    nestedIn->nestedList.push_back(scope);
     scope->type = scopeType;
+    scope->className = className;
+    nestedIn->addNestedScope(scope);
     scope->classDef = def;
     scope->check = nestedIn->check;
     if (!children2.empty()) {
@@ -775,9 +776,7 @@ Token *clangimport::AstNode::createTokens(TokenList *tokenList)
         Token *nametok = nullptr;
         if (mExtTokens[mExtTokens.size() - 3].compare(0,4,"col:") == 0)
             nametok = addtoken(tokenList, mExtTokens.back());
-        Scope *enumscope = createScope(tokenList, Scope::ScopeType::eEnum, children, enumtok);
-        if (nametok)
-            enumscope->className = nametok->str();
+        Scope *enumscope = createScope(tokenList, Scope::ScopeType::eEnum, children, enumtok, nametok ? nametok->str() : emptyString);
         if (enumscope->bodyEnd && Token::simpleMatch(enumscope->bodyEnd->previous(), ", }"))
             const_cast<Token *>(enumscope->bodyEnd)->deletePrevious();
 
@@ -921,9 +920,7 @@ Token *clangimport::AstNode::createTokens(TokenList *tokenList)
         const std::string &s = mExtTokens[mExtTokens.size() - 2];
         Token *nameToken = (s.compare(0,4,"col:")==0 || s.compare(0,5,"line:")==0) ?
                            addtoken(tokenList, mExtTokens.back()) : nullptr;
-        Scope *scope = createScope(tokenList, Scope::ScopeType::eNamespace, children, defToken);
-        if (nameToken)
-            scope->className = nameToken->str();
+        createScope(tokenList, Scope::ScopeType::eNamespace, children, defToken, nameToken ? nameToken->str() : emptyString);
         return nullptr;
     }
     if (nodeType == NullStmt)
@@ -1098,7 +1095,7 @@ void clangimport::AstNode::createTokensFunctionDecl(TokenList *tokenList)
         scope->classDef = nameToken;
         scope->type = Scope::ScopeType::eFunction;
         scope->className = nameToken->str();
-        nestedIn->nestedList.push_back(scope);
+        nestedIn->addNestedScope(scope);
         function->hasBody(true);
         function->functionScope = scope;
     }
@@ -1170,8 +1167,7 @@ void clangimport::AstNode::createTokensForCXXRecord(TokenList *tokenList)
         addtoken(tokenList, ";");
         return;
     }
-    Scope *scope = createScope(tokenList, Scope::ScopeType::eClass, children2, classToken);
-    scope->className = className;
+    Scope *scope = createScope(tokenList, Scope::ScopeType::eClass, children2, classToken, className);
     mData->mSymbolDatabase->typeList.push_back(Type(classToken, scope, classToken->scope()));
     scope->definedType = &mData->mSymbolDatabase->typeList.back();
 }
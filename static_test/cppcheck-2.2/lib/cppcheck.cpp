@@ -39,10 +39,16 @@
 #include <simplecpp.h>
 #include <tinyxml2.h>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstring>
+#include <exception>
+#include <functional>
+#include <mutex>
 #include <new>
 #include <set>
 #include <stdexcept>
+#include <thread>
 #include <vector>
 #include <memory>
 #include <iostream> // <- TEMPORARY
@@ -58,6 +64,29 @@ static const char ExtraVersion[] = "";
 
 static TimerResults s_timerResults;
 
+namespace {
+    /** Adds the timing results of a file to the totals when the check of the file is done */
+    class FileTimerResultsAdder {
+    public:
+        FileTimerResultsAdder(const Settings &settings, const std::string &filename, TimerResults &fileResults)
+            : mSettings(settings)
+            , mFilename(filename)
+            , mFileResults(fileResults) {
+        }
+
+        ~FileTimerResultsAdder() {
+            if (mSettings.showtime != SHOWTIME_MODES::SHOWTIME_NONE)
+                s_timerResults.addFileResults(mFilename, mFileResults, !mSettings.showtimeOutput.empty());
+            mFileResults.clear();
+        }
+
+    private:
+        const Settings &mSettings;
+        const std::string &mFilename;
+        TimerResults &mFileResults;
+    };
+}
+
 // CWE ids used
 static const CWE CWE398(398U);  // Indicator of Poor Code Quality
 
@@ -242,6 +271,92 @@ static std::string getDefinesFlags(const std::string &semicolonSeparatedString)
     return flags;
 }
 
+/**
+ * The tokens of one configuration and the results of its checking. The
+ * messages are buffered so several configurations can be checked at the
+ * same time and still be reported in the order of the configurations.
+ */
+class CppCheck::ConfigurationResult : public ErrorLogger {
+public:
+    /**
+     * @param progressLogger progress is reported here, nullptr if progress
+     * should not be reported
+     */
+    explicit ConfigurationResult(ErrorLogger *progressLogger)
+        : checked(false)
+        , hasChecksum(false)
+        , checksum(0)
+        , purged(false)
+        , samePreprocessedCode(false)
+        , skippedTokens(0)
+        , checkUnusedFunctions(nullptr, nullptr, nullptr)
+        , mProgressLogger(progressLogger) {
+    }
+
+    ~ConfigurationResult() OVERRIDE {
+        for (const std::pair<std::string, Check::FileInfo *> &fi : fileInfo)
+            delete fi.second;
+    }
+
+    void reportOut(const std::string &outmsg) OVERRIDE {
+        messages.emplace_back(Message::Out, outmsg);
+    }
+
+    void reportErr(const ErrorMessage &msg) OVERRIDE {
+        messages.emplace_back(msg);
+    }
+
+    void bughuntingReport(const std::string &str) OVERRIDE {
+        messages.emplace_back(Message::BugHunting, str);
+    }
+
+    void reportProgress(const std::string &filename, const char stage[], const std::size_t value) OVERRIDE {
+        if (mProgressLogger)
+            mProgressLogger->reportProgress(filename, stage, value);
+    }
+
+    struct Message {
+        enum Type { Out, Err, BugHunting };
+
+        Message(Type t, const std::string &s) : type(t), str(s) {}
+        explicit Message(const ErrorMessage &msg) : type(Err), errmsg(msg) {}
+
+        Type type;
+        std::string str;
+        ErrorMessage errmsg;
+    };
+
+    std::string cfg;
+
+    std::unique_ptr<Tokenizer> tokenizer;
+
+    std::vector<Message> messages;
+
+    /** File info for whole program analysis, by check name */
+    std::list<std::pair<std::string, Check::FileInfo *>> fileInfo;
+
+    /** Has the checking finished? Then the checksum is known */
+    bool checked;
+    bool hasChecksum;
+    unsigned long long checksum;
+
+    /** Was the configuration skipped because an earlier configuration had the same tokens? */
+    bool purged;
+
+    /** Was the preprocessed code the same as the code of an earlier configuration? */
+    bool samePreprocessedCode;
+    std::string sameCodeAs;
+    std::size_t skippedTokens;
+
+    CheckUnusedFunctions checkUnusedFunctions;
+
+    /** Exception that aborted the checking */
+    std::exception_ptr exception;
+
+private:
+    ErrorLogger *mProgressLogger;
+};
+
 CppCheck::CppCheck(ErrorLogger &errorLogger,
                    bool useGlobalSuppressions,
                    std::function<bool(std::string,std::vector<std::string>,std::string,std::string*)> executeCommand)
@@ -250,7 +365,9 @@ CppCheck::CppCheck(ErrorLogger &errorLogger,
     , mSuppressInternalErrorFound(false)
     , mUseGlobalSuppressions(useGlobalSuppressions)
     , mTooManyConfigs(false)
+    , mUsedCachedResults(false)
     , mSimplify(true)
+    , mHeaderCache(nullptr)
     , mExecuteCommand(executeCommand)
 {
 }
@@ -262,6 +379,10 @@ CppCheck::~CppCheck()
         mFileInfo.pop_back();
     }
     s_timerResults.showResults(mSettings.showtime);
+    if (mSettings.showtime != SHOWTIME_MODES::SHOWTIME_NONE && !mSettings.showtimeOutput.empty()) {
+        if (!s_timerResults.writeResults(mSettings.showtimeOutput))
+            std::cerr << "cppcheck: error: could not write the timing results to '" << mSettings.showtimeOutput << "'" << std::endl;
+    }
 }
 
 const char * CppCheck::version()
@@ -383,24 +504,26 @@ unsigned int CppCheck::check(const std::string &path)
         ValueFlow::setValues(&tokenizer.list, const_cast<SymbolDatabase *>(tokenizer.getSymbolDatabase()), this, &mSettings);
         if (mSettings.debugnormal)
             tokenizer.printDebugOutput(1);
-        checkNormalTokens(tokenizer);
+        ConfigurationResult result(this);
+        checkNormalTokens(tokenizer, result);
+        reportConfigurationResult(result);
         return mExitCode;
     }
 
-    std::ifstream fin(path);
-    return checkFile(Path::simplifyPath(path), emptyString, fin);
+    return checkFile(Path::simplifyPath(path), emptyString, nullptr, path);
 }
 
 unsigned int CppCheck::check(const std::string &path, const std::string &content)
 {
     std::istringstream iss(content);
-    return checkFile(Path::simplifyPath(path), emptyString, iss);
+    return checkFile(Path::simplifyPath(path), emptyString, &iss, path);
 }
 
 unsigned int CppCheck::check(const ImportProject::FileSettings &fs)
 {
     CppCheck temp(mErrorLogger, mUseGlobalSuppressions, mExecuteCommand);
     temp.mSettings = mSettings;
+    temp.setHeaderCache(headerCache());
     if (!temp.mSettings.userDefines.empty())
         temp.mSettings.userDefines += ';';
     if (mSettings.clang)
@@ -419,14 +542,14 @@ unsigned int CppCheck::check(const ImportProject::FileSettings &fs)
         temp.mSettings.includePaths.insert(temp.mSettings.includePaths.end(), fs.systemIncludePaths.cbegin(), fs.systemIncludePaths.cend());
         temp.check(Path::simplifyPath(fs.filename));
     }
-    std::ifstream fin(fs.filename);
-    return temp.checkFile(Path::simplifyPath(fs.filename), fs.cfg, fin);
+    return temp.checkFile(Path::simplifyPath(fs.filename), fs.cfg, nullptr, fs.filename);
 }
 
-unsigned int CppCheck::checkFile(const std::string& filename, const std::string &cfgname, std::istream& fileStream)
+unsigned int CppCheck::checkFile(const std::string& filename, const std::string &cfgname, std::istream* fileStream, const std::string &path)
 {
     mExitCode = 0;
     mSuppressInternalErrorFound = false;
+    mUsedCachedResults = false;
 
     // only show debug warnings for accepted C/C++ source files
     if (!Path::acceptFile(filename))
@@ -435,6 +558,12 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
     if (Settings::terminated())
         return mExitCode;
 
+    const FileTimerResultsAdder timerResultsAdder(mSettings, filename, mFileTimerResults);
+
+    // The check of the file is one event of the trace
+    Timer fileTimer("CppCheck::checkFile", SHOWTIME_MODES::SHOWTIME_NONE);
+    fileTimer.setDetail(filename);
+
     if (!mSettings.quiet) {
         std::string fixedpath = Path::simplifyPath(filename);
         fixedpath = Path::toNativeSeparators(fixedpath);
@@ -466,11 +595,14 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
 
     try {
         Preprocessor preprocessor(mSettings, this);
+        preprocessor.setHeaderCache(headerCache());
         std::set<std::string> configurations;
 
         simplecpp::OutputList outputList;
         std::vector<std::string> files;
-        simplecpp::TokenList tokens1(fileStream, files, filename, &outputList);
+        simplecpp::TokenList tokens1 = fileStream ?
+                                       simplecpp::TokenList(*fileStream, files, filename, &outputList) :
+                                       simplecpp::TokenList(path, filename, files, &outputList);
 
         // If there is a syntax error, report it and stop
         for (const simplecpp::Output &output : outputList) {
@@ -581,11 +713,12 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
             // Calculate checksum so it can be compared with old checksum / future checksums
             const unsigned int checksum = preprocessor.calculateChecksum(tokens1, toolinfo.str());
             std::list<ErrorMessage> errors;
-            if (!mAnalyzerInformation.analyzeFile(mSettings.buildDir, filename, cfgname, checksum, &errors)) {
+            if (!mAnalyzerInformation.analyzeFile(mSettings.buildDir, filename, cfgname, checksum, mSettings.buildDirFormat == Settings::BuildDirFormat::Binary, &errors)) {
                 while (!errors.empty()) {
                     reportErr(errors.front());
                     errors.pop_front();
                 }
+                mUsedCachedResults = true;
                 return mExitCode;  // known results => no need to reanalyze file
             }
         }
@@ -598,7 +731,7 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
 
         // Get configurations..
         if ((mSettings.checkAllConfigurations && mSettings.userDefines.empty()) || mSettings.force) {
-            Timer t("Preprocessor::getConfigs", mSettings.showtime, &s_timerResults);
+            Timer t("Preprocessor::getConfigs", mSettings.showtime, &mFileTimerResults);
             configurations = preprocessor.getConfigs(tokens1);
         } else {
             configurations.insert(mSettings.userDefines);
@@ -625,7 +758,7 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
             Tokenizer tokenizer2(&mSettings, this);
             std::istringstream istr2(code);
             tokenizer2.list.createTokens(istr2);
-            executeRules("define", tokenizer2);
+            executeRules("define", tokenizer2, *this);
             break;
         }
 
@@ -637,35 +770,176 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
             }
         }
 
-        std::set<unsigned long long> checksums;
-        unsigned int checkCount = 0;
-        bool hasValidConfig = false;
-        std::list<std::string> configurationError;
-        for (const std::string &currCfg : configurations) {
+        checkConfigurations(filename, tokens1, files, preprocessor, configurations, fdump, checkUnusedFunctions);
+
+        // dumped all configs, close root </dumps> element now
+        if ((mSettings.dump || !mSettings.addons.empty()) && fdump.is_open())
+            fdump << "</dumps>" << std::endl;
+
+        if (!mSettings.addons.empty()) {
+            fdump.close();
+
+            for (const std::string &addon : mSettings.addons) {
+                struct AddonInfo addonInfo;
+                const std::string &failedToGetAddonInfo = addonInfo.getAddonInfo(addon, mSettings.exename);
+                if (!failedToGetAddonInfo.empty()) {
+                    reportOut(failedToGetAddonInfo);
+                    mExitCode = 1;
+                    continue;
+                }
+                const std::string results =
+                    executeAddon(addonInfo, mSettings.addonPython, dumpFile, mExecuteCommand);
+                std::istringstream istr(results);
+                std::string line;
+
+                while (std::getline(istr, line)) {
+                    if (line.compare(0,1,"{") != 0)
+                        continue;
+
+                    picojson::value res;
+                    std::istringstream istr2(line);
+                    istr2 >> res;
+                    if (!res.is<picojson::object>())
+                        continue;
+
+                    picojson::object obj = res.get<picojson::object>();
+
+                    const std::string fileName = obj["file"].get<std::string>();
+                    const int64_t lineNumber = obj["linenr"].get<int64_t>();
+                    const int64_t column = obj["column"].get<int64_t>();
+
+                    ErrorMessage errmsg;
+
+                    errmsg.callStack.emplace_back(ErrorMessage::FileLocation(fileName, lineNumber, column));
+
+                    errmsg.id = obj["addon"].get<std::string>() + "-" + obj["errorId"].get<std::string>();
+                    const std::string text = obj["message"].get<std::string>();
+                    errmsg.setmsg(text);
+                    const std::string severity = obj["severity"].get<std::string>();
+                    errmsg.severity = Severity::fromString(severity);
+                    if (errmsg.severity == Severity::SeverityType::none)
+                        continue;
+                    errmsg.file0 = fileName;
+
+                    reportErr(errmsg);
+                }
+            }
+            std::remove(dumpFile.c_str());
+        }
+
+    } catch (const std::runtime_error &e) {
+        internalError(filename, e.what());
+    } catch (const std::bad_alloc &e) {
+        internalError(filename, e.what());
+    } catch (const InternalError &e) {
+        internalError(filename, e.errorMessage);
+        mExitCode=1; // e.g. reflect a syntax error
+    }
+
+    mAnalyzerInformation.setFileInfo("CheckUnusedFunctions", mAnalyzerInformation.isBinary() ? checkUnusedFunctions.analyzerInfoBinary() : checkUnusedFunctions.analyzerInfo());
+    mAnalyzerInformation.close();
+
+    // In jointSuppressionReport mode, unmatched suppressions are
+    // collected after all files are processed
+    if (!mSettings.jointSuppressionReport && (mSettings.isEnabled(Settings::INFORMATION) || mSettings.checkConfiguration)) {
+        reportUnmatchedSuppressions(mSettings.nomsg.getUnmatchedLocalSuppressions(filename, isUnusedFunctionCheckEnabled()));
+    }
+
+    mErrorList.clear();
+
+    return mExitCode;
+}
+
+static void reportInternalError(const InternalError &e, const Tokenizer &tokenizer, const std::string &filename, const Settings &settings, ErrorLogger &errorLogger)
+{
+    std::list<ErrorMessage::FileLocation> locationList;
+    if (e.token) {
+        ErrorMessage::FileLocation loc(e.token, &tokenizer.list);
+        locationList.push_back(loc);
+    } else {
+        ErrorMessage::FileLocation loc(tokenizer.list.getSourceFilePath(), 0, 0);
+        ErrorMessage::FileLocation loc2(filename, 0, 0);
+        locationList.push_back(loc2);
+        locationList.push_back(loc);
+    }
+    ErrorMessage errmsg(locationList,
+                        tokenizer.list.getSourceFilePath(),
+                        Severity::error,
+                        e.errorMessage,
+                        e.id,
+                        false);
+
+    if (errmsg.severity == Severity::error || settings.isEnabled(errmsg.severity))
+        errorLogger.reportErr(errmsg);
+}
+
+void CppCheck::checkConfigurations(const std::string &filename,
+                                   const simplecpp::TokenList &tokens1,
+                                   std::vector<std::string> &files,
+                                   Preprocessor &preprocessor,
+                                   const std::set<std::string> &configurations,
+                                   std::ofstream &fdump,
+                                   CheckUnusedFunctions &checkUnusedFunctions)
+{
+    const bool dump = (mSettings.dump || !mSettings.addons.empty()) && fdump.is_open();
+
+    // The dump file is written in order and bug hunting is not thread safe
+    const std::size_t configJobs = std::max(mSettings.configJobs, 1U);
+    std::size_t jobs = std::min<std::size_t>(configJobs, configurations.size());
+    if (!mSettings.force && mSettings.maxConfigs > 0)
+        jobs = std::min<std::size_t>(jobs, mSettings.maxConfigs);
+    if (dump || mSettings.bugHunting || mSettings.preprocessOnly)
+        jobs = 1;
+
+    // The threads that are not needed for the configurations analyze the
+    // function scopes in ValueFlow
+    const unsigned int valueFlowJobs = jobs > 0 ? static_cast<unsigned int>(configJobs / jobs) : 1U;
+
+    // The state below is protected by sync. The configurations are
+    // preprocessed in order, because the preprocessor is not thread safe
+    // and invalid configurations are not counted.
+    std::mutex sync;
+    std::condition_variable checkedChanged;
+    std::set<std::string>::const_iterator nextCfg = configurations.begin();
+    unsigned int checkCount = 0;
+    bool hasValidConfig = false;
+    bool stop = false;
+    std::list<std::string> configurationError;
+    std::vector<std::unique_ptr<ConfigurationResult>> results;
+    std::size_t reported = 0;
+    std::exception_ptr exception;
+    std::map<unsigned long long, std::string> preprocessedHashes;
+
+    // Preprocess the next configuration and create its tokens
+    auto nextConfiguration = [&]() -> ConfigurationResult * {
+        while (!stop && nextCfg != configurations.end()) {
+            const std::string &currCfg = *nextCfg++;
+
             // bail out if terminated
             if (Settings::terminated())
                 break;
 
             // Check only a few configurations (default 12), after that bail out, unless --force
             // was used.
-            if (!mSettings.force && ++checkCount > mSettings.maxConfigs)
+            if (!mSettings.force && ++checkCount > static_cast<unsigned int>(mSettings.maxConfigs))
                 break;
 
+            std::string currentConfig;
             if (!mSettings.userDefines.empty()) {
-                mCurrentConfig = mSettings.userDefines;
+                currentConfig = mSettings.userDefines;
                 const std::vector<std::string> v1(split(mSettings.userDefines, ";"));
                 for (const std::string &cfg: split(currCfg, ";")) {
                     if (std::find(v1.begin(), v1.end(), cfg) == v1.end()) {
-                        mCurrentConfig += ";" + cfg;
+                        currentConfig += ";" + cfg;
                     }
                 }
             } else {
-                mCurrentConfig = currCfg;
+                currentConfig = currCfg;
             }
 
             if (mSettings.preprocessOnly) {
-                Timer t("Preprocessor::getcode", mSettings.showtime, &s_timerResults);
-                std::string codeWithoutCfg = preprocessor.getcode(tokens1, mCurrentConfig, files, true);
+                Timer t("Preprocessor::getcode", mSettings.showtime, &mFileTimerResults);
+                std::string codeWithoutCfg = preprocessor.getcode(tokens1, currentConfig, files, true);
                 t.stop();
 
                 if (codeWithoutCfg.compare(0,5,"#file") == 0)
@@ -683,214 +957,267 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
                 continue;
             }
 
-            Tokenizer tokenizer(&mSettings, this);
+            // Progress is only reported when the configurations are checked one at a time
+            std::unique_ptr<ConfigurationResult> result(new ConfigurationResult(jobs == 1 ? this : nullptr));
+            result->cfg = currentConfig;
+            result->tokenizer.reset(new Tokenizer(&mSettings, result.get()));
+            Tokenizer &tokenizer = *result->tokenizer;
             tokenizer.setPreprocessor(&preprocessor);
+            tokenizer.setValueFlowJobs(valueFlowJobs);
             if (mSettings.showtime != SHOWTIME_MODES::SHOWTIME_NONE)
-                tokenizer.setTimerResults(&s_timerResults);
+                tokenizer.setTimerResults(&mFileTimerResults);
 
+            // Create tokens, skip configuration if failed. The tokens are
+            // created here because they refer to the shared file names.
             try {
-                // Create tokens, skip rest of iteration if failed
-                {
-                    Timer timer("Tokenizer::createTokens", mSettings.showtime, &s_timerResults);
-                    simplecpp::TokenList tokensP = preprocessor.preprocess(tokens1, mCurrentConfig, files, true);
+                Timer timer("Tokenizer::createTokens", mSettings.showtime, &mFileTimerResults);
+                timer.setDetail(currentConfig);
+                simplecpp::TokenList tokensP = preprocessor.preprocess(tokens1, currentConfig, files, true);
+
+                // Skip the configuration before it is tokenized if an earlier
+                // configuration has the same preprocessed code
+                std::map<unsigned long long, std::string>::const_iterator sameCode = preprocessedHashes.end();
+                if (mSettings.force || mSettings.maxConfigs > 1) {
+                    const std::pair<std::map<unsigned long long, std::string>::const_iterator, bool> inserted =
+                        preprocessedHashes.insert(std::make_pair(Preprocessor::calculateHash(tokensP), currentConfig));
+                    if (!inserted.second)
+                        sameCode = inserted.first;
+                }
+                if (sameCode != preprocessedHashes.end()) {
+                    result->purged = true;
+                    result->samePreprocessedCode = true;
+                    result->sameCodeAs = sameCode->second;
+                    for (const simplecpp::Token *tok = tokensP.cfront(); tok; tok = tok->next)
+                        ++result->skippedTokens;
+                    result->checked = true;
+                } else {
                     tokenizer.createTokens(std::move(tokensP));
+                    if (mSettings.showtime != SHOWTIME_MODES::SHOWTIME_NONE)
+                        timer.setTokens(tokenizer.list.countTokens());
                 }
                 hasValidConfig = true;
 
                 // If only errors are printed, print filename after the check
-                if (!mSettings.quiet && (!mCurrentConfig.empty() || checkCount > 1)) {
+                if (!mSettings.quiet && (!currentConfig.empty() || checkCount > 1)) {
                     std::string fixedpath = Path::simplifyPath(filename);
                     fixedpath = Path::toNativeSeparators(fixedpath);
-                    mErrorLogger.reportOut("Checking " + fixedpath + ": " + mCurrentConfig + "...");
+                    result->reportOut("Checking " + fixedpath + ": " + currentConfig + "...");
                 }
+            } catch (const simplecpp::Output &o) {
+                // #error etc during preprocessing
+                configurationError.push_back((currentConfig.empty() ? "\'\'" : currentConfig) + " : [" + o.location.file() + ':' + MathLib::toString(o.location.line) + "] " + o.msg);
+                --checkCount; // don't count invalid configurations
+                continue;
+            } catch (const InternalError &e) {
+                reportInternalError(e, tokenizer, filename, mSettings, *result);
+                result->tokenizer.reset();
+                result->checked = true;
+            } catch (...) {
+                result->exception = std::current_exception();
+                result->tokenizer.reset();
+                result->checked = true;
+                stop = true;
+            }
 
-                if (!tokenizer.tokens())
-                    continue;
-
-                // skip rest of iteration if just checking configuration
-                if (mSettings.checkConfiguration)
-                    continue;
-
-                // Check raw tokens
-                checkRawTokens(tokenizer);
-
-                // Simplify tokens into normal form, skip rest of iteration if failed
-                Timer timer2("Tokenizer::simplifyTokens1", mSettings.showtime, &s_timerResults);
-                bool result = tokenizer.simplifyTokens1(mCurrentConfig);
-                timer2.stop();
-                if (!result)
-                    continue;
-
-                // dump xml if --dump
-                if ((mSettings.dump || !mSettings.addons.empty()) && fdump.is_open()) {
-                    fdump << "<dump cfg=\"" << ErrorLogger::toxml(mCurrentConfig) << "\">" << std::endl;
-                    fdump << "  <standards>" << std::endl;
-                    fdump << "    <c version=\"" << mSettings.standards.getC() << "\"/>" << std::endl;
-                    fdump << "    <cpp version=\"" << mSettings.standards.getCPP() << "\"/>" << std::endl;
-                    fdump << "  </standards>" << std::endl;
-                    preprocessor.dump(fdump);
-                    tokenizer.dump(fdump);
-                    fdump << "</dump>" << std::endl;
-                }
+            results.push_back(std::move(result));
+            return results.back().get();
+        }
+        stop = true;
+        return nullptr;
+    };
 
-                // Skip if we already met the same simplified token list
-                if (mSettings.force || mSettings.maxConfigs > 1) {
-                    const unsigned long long checksum = tokenizer.list.calculateChecksum();
-                    if (checksums.find(checksum) != checksums.end()) {
-                        if (mSettings.debugwarnings)
-                            purgedConfigurationMessage(filename, mCurrentConfig);
-                        continue;
+    auto worker = [&]() {
+        std::unique_lock<std::mutex> lock(sync);
+        while (ConfigurationResult *result = nextConfiguration()) {
+            if (!result->checked) {
+                // Skip the configuration if an earlier configuration had the same simplified tokens
+                const std::size_t index = results.size() - 1U;
+                auto isDuplicate = [&](unsigned long long checksum) {
+                    std::unique_lock<std::mutex> checksumLock(sync);
+                    result->hasChecksum = true;
+                    result->checksum = checksum;
+                    checkedChanged.notify_all();
+                    for (std::size_t i = 0; i < index; ++i) {
+                        checkedChanged.wait(checksumLock, [&] {
+                            return results[i]->hasChecksum || results[i]->checked;
+                        });
+                        if (results[i]->hasChecksum && results[i]->checksum == checksum)
+                            return true;
                     }
-                    checksums.insert(checksum);
+                    return false;
+                };
+
+                lock.unlock();
+                try {
+                    checkConfiguration(*result, filename, dump ? &fdump : nullptr, isDuplicate);
+                } catch (...) {
+                    result->exception = std::current_exception();
                 }
+                result->tokenizer.reset();
+                lock.lock();
 
-                // Check normal tokens
-                checkNormalTokens(tokenizer);
-
-                // Analyze info..
-                if (!mSettings.buildDir.empty())
-                    checkUnusedFunctions.parseTokens(tokenizer, filename.c_str(), &mSettings);
-
-                // simplify more if required, skip rest of iteration if failed
-                if (mSimplify && hasRule("simple")) {
-                    std::cout << "Handling of \"simple\" rules is deprecated and will be removed in Cppcheck 2.5." << std::endl;
-
-                    // if further simplification fails then skip rest of iteration
-                    Timer timer3("Tokenizer::simplifyTokenList2", mSettings.showtime, &s_timerResults);
-                    result = tokenizer.simplifyTokenList2();
-                    timer3.stop();
-                    if (!result)
-                        continue;
+                result->checked = true;
+                if (result->exception)
+                    stop = true;
+                checkedChanged.notify_all();
+            }
 
-                    if (!Settings::terminated())
-                        executeRules("simple", tokenizer);
+            // Report the checked configurations in order
+            while (!exception && reported < results.size() && results[reported]->checked) {
+                ConfigurationResult &reportedResult = *results[reported++];
+                reportConfigurationResult(reportedResult);
+                if (reportedResult.purged && mSettings.debugwarnings) {
+                    purgedConfigurationMessage(filename, reportedResult.cfg);
+                    if (reportedResult.samePreprocessedCode) {
+                        const ErrorMessage::FileLocation loc(filename, 0, 0);
+                        const ErrorMessage errmsg(std::list<ErrorMessage::FileLocation>(1, loc),
+                                                  emptyString,
+                                                  Severity::debug,
+                                                  "The configuration '" + reportedResult.cfg + "' was not tokenized because its preprocessed code equals the configuration '" +
+                                                  reportedResult.sameCodeAs + "'. " + MathLib::toString(reportedResult.skippedTokens) + " tokens were not simplified and checked.",
+                                                  "debug",
+                                                  false);
+                        reportErr(errmsg);
+                    }
                 }
+                checkUnusedFunctions.addAnalyzerInfo(reportedResult.checkUnusedFunctions);
+                exception = reportedResult.exception;
+            }
+        }
+    };
 
-            } catch (const simplecpp::Output &o) {
-                // #error etc during preprocessing
-                configurationError.push_back((mCurrentConfig.empty() ? "\'\'" : mCurrentConfig) + " : [" + o.location.file() + ':' + MathLib::toString(o.location.line) + "] " + o.msg);
-                --checkCount; // don't count invalid configurations
-                continue;
+    // The threads are shown as threads of the same worker in the trace
+    const unsigned int traceWorker = Timer::traceWorker();
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < jobs; ++i) {
+        threads.emplace_back([&worker, traceWorker]() {
+            Timer::setTraceWorker(traceWorker);
+            worker();
+        });
+    }
+    worker();
+    for (std::thread &t : threads)
+        t.join();
 
-            } catch (const InternalError &e) {
-                std::list<ErrorMessage::FileLocation> locationList;
-                if (e.token) {
-                    ErrorMessage::FileLocation loc(e.token, &tokenizer.list);
-                    locationList.push_back(loc);
-                } else {
-                    ErrorMessage::FileLocation loc(tokenizer.list.getSourceFilePath(), 0, 0);
-                    ErrorMessage::FileLocation loc2(filename, 0, 0);
-                    locationList.push_back(loc2);
-                    locationList.push_back(loc);
-                }
-                ErrorMessage errmsg(locationList,
-                                    tokenizer.list.getSourceFilePath(),
-                                    Severity::error,
-                                    e.errorMessage,
-                                    e.id,
-                                    false);
+    if (exception)
+        std::rethrow_exception(exception);
 
-                if (errmsg.severity == Severity::error || mSettings.isEnabled(errmsg.severity))
-                    reportErr(errmsg);
-            }
-        }
+    if (!hasValidConfig && configurations.size() > 1 && mSettings.isEnabled(Settings::INFORMATION)) {
+        std::string msg;
+        msg = "This file is not analyzed. Cppcheck failed to extract a valid configuration. Use -v for more details.";
+        msg += "\nThis file is not analyzed. Cppcheck failed to extract a valid configuration. The tested configurations have these preprocessor errors:";
+        for (const std::string &s : configurationError)
+            msg += '\n' + s;
 
-        if (!hasValidConfig && configurations.size() > 1 && mSettings.isEnabled(Settings::INFORMATION)) {
-            std::string msg;
-            msg = "This file is not analyzed. Cppcheck failed to extract a valid configuration. Use -v for more details.";
-            msg += "\nThis file is not analyzed. Cppcheck failed to extract a valid configuration. The tested configurations have these preprocessor errors:";
-            for (const std::string &s : configurationError)
-                msg += '\n' + s;
+        std::list<ErrorMessage::FileLocation> locationList;
+        ErrorMessage::FileLocation loc;
+        loc.setfile(Path::toNativeSeparators(filename));
+        locationList.push_back(loc);
+        ErrorMessage errmsg(locationList,
+                            loc.getfile(),
+                            Severity::information,
+                            msg,
+                            "noValidConfiguration",
+                            false);
+        reportErr(errmsg);
+    }
+}
 
-            std::list<ErrorMessage::FileLocation> locationList;
-            ErrorMessage::FileLocation loc;
-            loc.setfile(Path::toNativeSeparators(filename));
-            locationList.push_back(loc);
-            ErrorMessage errmsg(locationList,
-                                loc.getfile(),
-                                Severity::information,
-                                msg,
-                                "noValidConfiguration",
-                                false);
-            reportErr(errmsg);
-        }
+void CppCheck::checkConfiguration(ConfigurationResult &result,
+                                  const std::string &filename,
+                                  std::ofstream *fdump,
+                                  const std::function<bool(unsigned long long)> &isDuplicate)
+{
+    Tokenizer &tokenizer = *result.tokenizer;
 
-        // dumped all configs, close root </dumps> element now
-        if ((mSettings.dump || !mSettings.addons.empty()) && fdump.is_open())
-            fdump << "</dumps>" << std::endl;
+    Timer configurationTimer("CppCheck::checkConfiguration", SHOWTIME_MODES::SHOWTIME_NONE);
+    configurationTimer.setDetail(result.cfg);
 
-        if (!mSettings.addons.empty()) {
-            fdump.close();
+    try {
+        if (!tokenizer.tokens())
+            return;
 
-            for (const std::string &addon : mSettings.addons) {
-                struct AddonInfo addonInfo;
-                const std::string &failedToGetAddonInfo = addonInfo.getAddonInfo(addon, mSettings.exename);
-                if (!failedToGetAddonInfo.empty()) {
-                    reportOut(failedToGetAddonInfo);
-                    mExitCode = 1;
-                    continue;
-                }
-                const std::string results =
-                    executeAddon(addonInfo, mSettings.addonPython, dumpFile, mExecuteCommand);
-                std::istringstream istr(results);
-                std::string line;
+        // Check raw tokens
+        checkRawTokens(tokenizer, result);
 
-                while (std::getline(istr, line)) {
-                    if (line.compare(0,1,"{") != 0)
-                        continue;
+        // Simplify tokens into normal form, skip rest of iteration if failed
+        Timer timer2("Tokenizer::simplifyTokens1", mSettings.showtime, &mFileTimerResults);
+        bool ok = tokenizer.simplifyTokens1(result.cfg);
+        if (mSettings.showtime != SHOWTIME_MODES::SHOWTIME_NONE)
+            timer2.setTokens(tokenizer.list.countTokens());
+        timer2.stop();
+        if (!ok)
+            return;
 
-                    picojson::value res;
-                    std::istringstream istr2(line);
-                    istr2 >> res;
-                    if (!res.is<picojson::object>())
-                        continue;
+        // dump xml if --dump
+        if (fdump) {
+            *fdump << "<dump cfg=\"" << ErrorLogger::toxml(result.cfg) << "\">" << std::endl;
+            *fdump << "  <standards>" << std::endl;
+            *fdump << "    <c version=\"" << mSettings.standards.getC() << "\"/>" << std::endl;
+            *fdump << "    <cpp version=\"" << mSettings.standards.getCPP() << "\"/>" << std::endl;
+            *fdump << "  </standards>" << std::endl;
+            tokenizer.getPreprocessor()->dump(*fdump);
+            tokenizer.dump(*fdump);
+            *fdump << "</dump>" << std::endl;
+        }
 
-                    picojson::object obj = res.get<picojson::object>();
+        // Skip if we already met the same simplified token list
+        if (mSettings.force || mSettings.maxConfigs > 1) {
+            if (isDuplicate(tokenizer.list.calculateChecksum())) {
+                result.purged = true;
+                return;
+            }
+        }
 
-                    const std::string fileName = obj["file"].get<std::string>();
-                    const int64_t lineNumber = obj["linenr"].get<int64_t>();
-                    const int64_t column = obj["column"].get<int64_t>();
+        // Check normal tokens
+        checkNormalTokens(tokenizer, result);
 
-                    ErrorMessage errmsg;
+        // Analyze info..
+        if (!mSettings.buildDir.empty())
+            result.checkUnusedFunctions.parseTokens(tokenizer, filename.c_str(), &mSettings);
 
-                    errmsg.callStack.emplace_back(ErrorMessage::FileLocation(fileName, lineNumber, column));
+        // simplify more if required, skip rest of iteration if failed
+        if (mSimplify && hasRule("simple")) {
+            std::cout << "Handling of \"simple\" rules is deprecated and will be removed in Cppcheck 2.5." << std::endl;
 
-                    errmsg.id = obj["addon"].get<std::string>() + "-" + obj["errorId"].get<std::string>();
-                    const std::string text = obj["message"].get<std::string>();
-                    errmsg.setmsg(text);
-                    const std::string severity = obj["severity"].get<std::string>();
-                    errmsg.severity = Severity::fromString(severity);
-                    if (errmsg.severity == Severity::SeverityType::none)
-                        continue;
-                    errmsg.file0 = fileName;
+            // if further simplification fails then skip rest of iteration
+            Timer timer3("Tokenizer::simplifyTokenList2", mSettings.showtime, &mFileTimerResults);
+            ok = tokenizer.simplifyTokenList2();
+            timer3.stop();
+            if (!ok)
+                return;
 
-                    reportErr(errmsg);
-                }
-            }
-            std::remove(dumpFile.c_str());
+            if (!Settings::terminated())
+                executeRules("simple", tokenizer, result);
         }
 
-    } catch (const std::runtime_error &e) {
-        internalError(filename, e.what());
-    } catch (const std::bad_alloc &e) {
-        internalError(filename, e.what());
     } catch (const InternalError &e) {
-        internalError(filename, e.errorMessage);
-        mExitCode=1; // e.g. reflect a syntax error
+        reportInternalError(e, tokenizer, filename, mSettings, result);
     }
+}
 
-    mAnalyzerInformation.setFileInfo("CheckUnusedFunctions", checkUnusedFunctions.analyzerInfo());
-    mAnalyzerInformation.close();
-
-    // In jointSuppressionReport mode, unmatched suppressions are
-    // collected after all files are processed
-    if (!mSettings.jointSuppressionReport && (mSettings.isEnabled(Settings::INFORMATION) || mSettings.checkConfiguration)) {
-        reportUnmatchedSuppressions(mSettings.nomsg.getUnmatchedLocalSuppressions(filename, isUnusedFunctionCheckEnabled()));
+void CppCheck::reportConfigurationResult(ConfigurationResult &result)
+{
+    for (const ConfigurationResult::Message &message : result.messages) {
+        switch (message.type) {
+        case ConfigurationResult::Message::Out:
+            mErrorLogger.reportOut(message.str);
+            break;
+        case ConfigurationResult::Message::Err:
+            reportErr(message.errmsg);
+            break;
+        case ConfigurationResult::Message::BugHunting:
+            bughuntingReport(message.str);
+            break;
+        }
     }
+    result.messages.clear();
 
-    mErrorList.clear();
-
-    return mExitCode;
+    for (const std::pair<std::string, Check::FileInfo *> &fi : result.fileInfo) {
+        mFileInfo.push_back(fi.second);
+        mAnalyzerInformation.setFileInfo(fi.first, mAnalyzerInformation.isBinary() ? fi.second->toBinary() : fi.second->toString());
+    }
+    result.fileInfo.clear();
 }
 
 void CppCheck::internalError(const std::string &filename, const std::string &msg)
@@ -919,21 +1246,23 @@ void CppCheck::internalError(const std::string &filename, const std::string &msg
 //---------------------------------------------------------------------------
 // CppCheck - A function that checks a raw token list
 //---------------------------------------------------------------------------
-void CppCheck::checkRawTokens(const Tokenizer &tokenizer)
+void CppCheck::checkRawTokens(const Tokenizer &tokenizer, ErrorLogger &errorLogger)
 {
     // Execute rules for "raw" code
-    executeRules("raw", tokenizer);
+    executeRules("raw", tokenizer, errorLogger);
 }
 
 //---------------------------------------------------------------------------
 // CppCheck - A function that checks a normal token list
 //---------------------------------------------------------------------------
 
-void CppCheck::checkNormalTokens(const Tokenizer &tokenizer)
+void CppCheck::checkNormalTokens(const Tokenizer &tokenizer, ConfigurationResult &result)
 {
     if (mSettings.bugHunting)
-        ExprEngine::runChecks(this, &tokenizer, &mSettings);
+        ExprEngine::runChecks(&result, &tokenizer, &mSettings);
     else {
+        const std::size_t tokens = mSettings.showtime != SHOWTIME_MODES::SHOWTIME_NONE ? tokenizer.list.countTokens() : 0;
+
         // call all "runChecks" in all registered Check classes
         for (Check *check : Check::instances()) {
             if (Settings::terminated())
@@ -942,8 +1271,9 @@ void CppCheck::checkNormalTokens(const Tokenizer &tokenizer)
             if (Tokenizer::isMaxTime())
                 return;
 
-            Timer timerRunChecks(check->name() + "::runChecks", mSettings.showtime, &s_timerResults);
-            check->runChecks(&tokenizer, &mSettings, this);
+            Timer timerRunChecks(check->name() + "::runChecks", mSettings.showtime, &mFileTimerResults);
+            timerRunChecks.setTokens(tokens);
+            check->runChecks(&tokenizer, &mSettings, &result);
         }
 
         if (mSettings.clang)
@@ -953,20 +1283,16 @@ void CppCheck::checkNormalTokens(const Tokenizer &tokenizer)
         // Analyse the tokens..
 
         CTU::FileInfo *fi1 = CTU::getFileInfo(&tokenizer);
-        if (fi1) {
-            mFileInfo.push_back(fi1);
-            mAnalyzerInformation.setFileInfo("ctu", fi1->toString());
-        }
+        if (fi1)
+            result.fileInfo.emplace_back("ctu", fi1);
 
         for (const Check *check : Check::instances()) {
             Check::FileInfo *fi = check->getFileInfo(&tokenizer, &mSettings);
-            if (fi != nullptr) {
-                mFileInfo.push_back(fi);
-                mAnalyzerInformation.setFileInfo(check->name(), fi->toString());
-            }
+            if (fi != nullptr)
+                result.fileInfo.emplace_back(check->name(), fi);
         }
 
-        executeRules("normal", tokenizer);
+        executeRules("normal", tokenizer, result);
     }
 }
 
@@ -1120,10 +1446,11 @@ static const char * pcreErrorCodeToString(const int pcreExecRet)
 #endif // HAVE_RULES
 
 
-void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &tokenizer)
+void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &tokenizer, ErrorLogger &errorLogger)
 {
     (void)tokenlist;
     (void)tokenizer;
+    (void)errorLogger;
 
 #ifdef HAVE_RULES
     // There is no rule to execute
@@ -1153,7 +1480,7 @@ void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &token
                                           "pcre_compile",
                                           false);
 
-                reportErr(errmsg);
+                errorLogger.reportErr(errmsg);
             }
             continue;
         }
@@ -1174,7 +1501,7 @@ void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &token
                                       "pcre_study",
                                       false);
 
-            reportErr(errmsg);
+            errorLogger.reportErr(errmsg);
             // pcre_compile() worked, but pcre_study() returned an error. Free the resources allocated by pcre_compile().
             pcre_free(re);
             continue;
@@ -1197,7 +1524,7 @@ void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &token
                                               "pcre_exec",
                                               false);
 
-                    reportErr(errmsg);
+                    errorLogger.reportErr(errmsg);
                 }
                 break;
             }
@@ -1233,7 +1560,7 @@ void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &token
             const ErrorMessage errmsg(callStack, tokenizer.list.getSourceFilePath(), rule.severity, summary, rule.id, false);
 
             // Report error
-            reportErr(errmsg);
+            errorLogger.reportErr(errmsg);
         }
 
         pcre_free(re);
@@ -1252,6 +1579,16 @@ Settings &CppCheck::settings()
     return mSettings;
 }
 
+simplecpp::HeaderCache *CppCheck::headerCache()
+{
+    if (!mHeaderCache) {
+        mOwnHeaderCache.reset(new simplecpp::HeaderCache);
+        mOwnHeaderCache->setDirectory(mSettings.buildDir);
+        mHeaderCache = mOwnHeaderCache.get();
+    }
+    return mHeaderCache;
+}
+
 void CppCheck::tooManyConfigsError(const std::string &file, const std::size_t numberOfConfigurations)
 {
     if (!mSettings.isEnabled(Settings::INFORMATION) && !mTooManyConfigs)
@@ -1331,7 +1668,7 @@ void CppCheck::reportErr(const ErrorMessage &msg)
         return;
 
     // Alert only about unique errors
-    if (std::find(mErrorList.begin(), mErrorList.end(), errmsg) != mErrorList.end())
+    if (mErrorList.contains(msg, mSettings.verbose))
         return;
 
     const Suppressions::ErrorMessage errorMessage = msg.toSuppressionsErrorMessage();
@@ -1352,7 +1689,7 @@ void CppCheck::reportErr(const ErrorMessage &msg)
         mExitCode = 1;
     }
 
-    mErrorList.push_back(errmsg);
+    mErrorList.insert(msg, mSettings.verbose);
 
     mErrorLogger.reportErr(msg);
     mAnalyzerInformation.reportErr(msg, mSettings.verbose);
@@ -1506,17 +1843,137 @@ bool CppCheck::analyseWholeProgram()
     return errors && (mExitCode > 0);
 }
 
+namespace {
+    /** Buffers the messages of a whole program analysis until they can be reported in order */
+    class WholeProgramResult : public ErrorLogger {
+    public:
+        void reportOut(const std::string &outmsg) OVERRIDE {
+            messages.emplace_back(outmsg);
+        }
+
+        void reportErr(const ErrorMessage &msg) OVERRIDE {
+            messages.emplace_back(msg);
+        }
+
+        void bughuntingReport(const std::string & /*str*/) OVERRIDE {}
+
+        struct Message {
+            explicit Message(const std::string &s) : isError(false), str(s) {}
+            explicit Message(const ErrorMessage &msg) : isError(true), errmsg(msg) {}
+
+            bool isError;
+            std::string str;
+            ErrorMessage errmsg;
+        };
+
+        std::vector<Message> messages;
+    };
+
+    /** Analyzer info of one file */
+    struct AnalyzerInfoFile {
+        ~AnalyzerInfoFile() {
+            for (Check::FileInfo *fi : fileInfo)
+                delete fi;
+        }
+
+        CTU::FileInfo ctuFileInfo;
+        std::list<Check::FileInfo*> fileInfo;
+    };
+}
+
+static void loadAnalyzerInfoXml(const std::string &data, AnalyzerInfoFile &analyzerInfoFile)
+{
+    tinyxml2::XMLDocument doc;
+    if (doc.Parse(data.c_str(), data.size()) != tinyxml2::XML_SUCCESS)
+        return;
+
+    const tinyxml2::XMLElement * const rootNode = doc.FirstChildElement();
+    if (rootNode == nullptr)
+        return;
+
+    for (const tinyxml2::XMLElement *e = rootNode->FirstChildElement(); e; e = e->NextSiblingElement()) {
+        if (std::strcmp(e->Name(), "FileInfo") != 0)
+            continue;
+        const char *checkClassAttr = e->Attribute("check");
+        if (!checkClassAttr)
+            continue;
+        if (std::strcmp(checkClassAttr, "ctu") == 0) {
+            analyzerInfoFile.ctuFileInfo.loadFromXml(e);
+            continue;
+        }
+        for (Check *check : Check::instances()) {
+            if (checkClassAttr == check->name())
+                analyzerInfoFile.fileInfo.push_back(check->loadFileInfoFromXml(e));
+        }
+    }
+}
+
+static void loadAnalyzerInfoBinary(const std::string &data, AnalyzerInfoFile &analyzerInfoFile)
+{
+    unsigned long long checksum = 0;
+    std::list<std::pair<std::string, std::string>> fileInfo;
+    if (!AnalyzerInformation::parseBinary(data, checksum, nullptr, &fileInfo))
+        return;
+
+    for (const std::pair<std::string, std::string> &fi : fileInfo) {
+        const char * const begin = fi.second.data();
+        const char * const end = begin + fi.second.size();
+        if (fi.first == "ctu") {
+            analyzerInfoFile.ctuFileInfo.loadFromBinary(begin, end);
+            continue;
+        }
+        for (Check *check : Check::instances()) {
+            if (fi.first == check->name())
+                analyzerInfoFile.fileInfo.push_back(check->loadFileInfoFromBinary(begin, end));
+        }
+    }
+}
+
+/**
+ * Run the tasks 0..count-1 with up to jobs threads. If a task throws, the
+ * remaining tasks are not started and the exception is rethrown.
+ */
+static void runTasks(std::size_t jobs, std::size_t count, const std::function<void(std::size_t)> &task)
+{
+    std::atomic<std::size_t> next(0);
+    std::mutex sync;
+    std::exception_ptr exception;
+
+    const auto worker = [&]() {
+        for (std::size_t i = next++; i < count; i = next++) {
+            try {
+                task(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(sync);
+                if (!exception)
+                    exception = std::current_exception();
+                next = count;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < std::min(jobs, count); ++i)
+        threads.emplace_back(worker);
+    worker();
+    for (std::thread &t : threads)
+        t.join();
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
 void CppCheck::analyseWholeProgram(const std::string &buildDir, const std::map<std::string, std::size_t> &files)
 {
     (void)files;
     if (buildDir.empty())
         return;
-    if (mSettings.isEnabled(Settings::UNUSED_FUNCTION))
-        CheckUnusedFunctions::analyseWholeProgram(this, buildDir);
-    std::list<Check::FileInfo*> fileInfoList;
-    CTU::FileInfo ctuFileInfo;
+
+    const std::size_t jobs = std::max(mSettings.jobs, 1U);
+    std::mutex progressSync;
 
     // Load all analyzer info data..
+    std::vector<std::string> xmlfiles;
     const std::string filesTxt(buildDir + "/files.txt");
     std::ifstream fin(filesTxt);
     std::string filesTxtLine;
@@ -1527,46 +1984,87 @@ void CppCheck::analyseWholeProgram(const std::string &buildDir, const std::map<s
         const std::string::size_type lastColon = filesTxtLine.rfind(':');
         if (firstColon == lastColon)
             continue;
-        const std::string xmlfile = buildDir + '/' + filesTxtLine.substr(0,firstColon);
+        xmlfiles.push_back(buildDir + '/' + filesTxtLine.substr(0,firstColon));
         //const std::string sourcefile = filesTxtLine.substr(lastColon+1);
+    }
 
-        tinyxml2::XMLDocument doc;
-        const tinyxml2::XMLError error = doc.LoadFile(xmlfile.c_str());
-        if (error != tinyxml2::XML_SUCCESS)
-            continue;
-
-        const tinyxml2::XMLElement * const rootNode = doc.FirstChildElement();
-        if (rootNode == nullptr)
-            continue;
-
-        for (const tinyxml2::XMLElement *e = rootNode->FirstChildElement(); e; e = e->NextSiblingElement()) {
-            if (std::strcmp(e->Name(), "FileInfo") != 0)
-                continue;
-            const char *checkClassAttr = e->Attribute("check");
-            if (!checkClassAttr)
-                continue;
-            if (std::strcmp(checkClassAttr, "ctu") == 0) {
-                ctuFileInfo.loadFromXml(e);
-                continue;
+    // The files are loaded in parallel, their file info is merged in the order of files.txt
+    std::vector<AnalyzerInfoFile> analyzerInfoFiles(xmlfiles.size());
+    {
+        Timer timer("CppCheck::analyseWholeProgram (load)", mSettings.showtime, &s_timerResults);
+        std::atomic<std::size_t> loaded(0);
+        runTasks(jobs, xmlfiles.size(), [&](std::size_t i) {
+            std::string data;
+            if (AnalyzerInformation::loadFile(xmlfiles[i], data)) {
+                if (AnalyzerInformation::isBinaryFile(data))
+                    loadAnalyzerInfoBinary(data, analyzerInfoFiles[i]);
+                else
+                    loadAnalyzerInfoXml(data, analyzerInfoFiles[i]);
             }
-            for (Check *check : Check::instances()) {
-                if (checkClassAttr == check->name())
-                    fileInfoList.push_back(check->loadFileInfoFromXml(e));
+
+            if (mSettings.reportProgress) {
+                const std::size_t count = ++loaded;
+                std::lock_guard<std::mutex> lock(progressSync);
+                reportProgress(buildDir, "Whole program analysis (load)", 100 * count / xmlfiles.size());
             }
-        }
+        });
     }
 
+    std::list<Check::FileInfo*> fileInfoList;
+    CTU::FileInfo ctuFileInfo;
+    for (AnalyzerInfoFile &analyzerInfoFile : analyzerInfoFiles) {
+        ctuFileInfo.functionCalls.splice(ctuFileInfo.functionCalls.end(), analyzerInfoFile.ctuFileInfo.functionCalls);
+        ctuFileInfo.nestedCalls.splice(ctuFileInfo.nestedCalls.end(), analyzerInfoFile.ctuFileInfo.nestedCalls);
+        fileInfoList.splice(fileInfoList.end(), analyzerInfoFile.fileInfo);
+    }
+    analyzerInfoFiles.clear();
+
     // Set CTU max depth
     CTU::maxCtuDepth = mSettings.maxCtuDepth;
 
-    // Analyse the tokens
-    for (Check *check : Check::instances())
-        check->analyseWholeProgram(&ctuFileInfo, fileInfoList, mSettings, *this);
+    // The checks analyse the whole program in parallel. The unused
+    // functions are analysed first, then the checks in the order of
+    // Check::instances(). Their messages are reported in that order.
+    const bool unusedFunctions = mSettings.isEnabled(Settings::UNUSED_FUNCTION);
+    const std::vector<Check *> checks(Check::instances().begin(), Check::instances().end());
+    const std::size_t analyses = checks.size() + (unusedFunctions ? 1 : 0);
+    std::vector<WholeProgramResult> results(analyses);
+    std::atomic<std::size_t> analysed(0);
+    runTasks(jobs, analyses, [&](std::size_t i) {
+        if (unusedFunctions && i == 0) {
+            Timer timer("CheckUnusedFunctions::analyseWholeProgram (build dir)", mSettings.showtime, &s_timerResults);
+            CheckUnusedFunctions::analyseWholeProgram(&results[i], buildDir);
+        } else {
+            Check *check = checks[unusedFunctions ? i - 1 : i];
+            Timer timer(check->name() + "::analyseWholeProgram", mSettings.showtime, &s_timerResults);
+            check->analyseWholeProgram(&ctuFileInfo, fileInfoList, mSettings, results[i]);
+        }
+
+        if (mSettings.reportProgress) {
+            const std::size_t count = ++analysed;
+            std::lock_guard<std::mutex> lock(progressSync);
+            reportProgress(buildDir, "Whole program analysis", 100 * count / analyses);
+        }
+    });
+
+    for (const WholeProgramResult &result : results) {
+        for (const WholeProgramResult::Message &message : result.messages) {
+            if (message.isError)
+                reportErr(message.errmsg);
+            else
+                reportOut(message.str);
+        }
+    }
 
     for (Check::FileInfo *fi : fileInfoList)
         delete fi;
 }
 
+TimerResults &CppCheck::timerResults()
+{
+    return s_timerResults;
+}
+
 bool CppCheck::isUnusedFunctionCheckEnabled() const
 {
     return (mSettings.jobs == 1 && mSettings.isEnabled(Settings::UNUSED_FUNCTION));
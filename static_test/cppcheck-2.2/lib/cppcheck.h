@@ -27,15 +27,25 @@
 #include "errorlogger.h"
 #include "importproject.h"
 #include "settings.h"
+#include "timer.h"
 
 #include <cstddef>
 #include <functional>
 #include <istream>
 #include <list>
 #include <map>
+#include <memory>
+#include <set>
 #include <string>
+#include <vector>
 
+class CheckUnusedFunctions;
+class Preprocessor;
 class Tokenizer;
+namespace simplecpp {
+    class HeaderCache;
+    class TokenList;
+}
 
 /// @addtogroup Core
 /// @{
@@ -96,6 +106,16 @@ public:
      */
     Settings &settings();
 
+    /**
+     * @brief Share a cache of tokenized headers with other instances,
+     * for instance the threads that check the files in parallel. The
+     * caller owns the cache, it must outlive this instance. By default
+     * each instance creates its own cache when the first file is checked.
+     */
+    void setHeaderCache(simplecpp::HeaderCache *headerCache) {
+        mHeaderCache = headerCache;
+    }
+
     /**
      * @brief Returns current version number as a string.
      * @return version, e.g. "1.38"
@@ -149,11 +169,22 @@ public:
      * and if it's possible at all */
     bool isUnusedFunctionCheckEnabled() const;
 
+    /** @brief Were the results of the last checked file read from the build dir? */
+    bool usedCachedResults() const {
+        return mUsedCachedResults;
+    }
+
+    /** @brief Timing results of all the files checked in this process (--showtime) */
+    static TimerResults &timerResults();
+
 private:
 
     /** Are there "simple" rules */
     bool hasRule(const std::string &tokenlist) const;
 
+    /** @brief Cache of tokenized headers, it is created on first use */
+    simplecpp::HeaderCache *headerCache();
+
     /** @brief There has been an internal error => Report information message */
     void internalError(const std::string &filename, const std::string &msg);
 
@@ -161,29 +192,72 @@ private:
      * @brief Check a file using stream
      * @param filename file name
      * @param cfgname  cfg name
-     * @param fileStream stream the file content can be read from
+     * @param fileStream stream the file content can be read from, nullptr to read the file
+     * @param path path of the file that is read when there is no fileStream, filename is used in the results
      * @return number of errors found
      */
-    unsigned int checkFile(const std::string& filename, const std::string &cfgname, std::istream& fileStream);
+    unsigned int checkFile(const std::string& filename, const std::string &cfgname, std::istream* fileStream, const std::string &path);
+
+    /** @brief Tokens and buffered results of one configuration */
+    class ConfigurationResult;
+
+    /**
+     * @brief Check the configurations of a file. The configurations are
+     * preprocessed one at a time. Their tokens are simplified and checked
+     * by up to Settings::configJobs threads, and the results are reported
+     * in the order of the configurations.
+     * @param filename file name
+     * @param tokens1 raw tokens of the file
+     * @param files file names used by the tokens
+     * @param preprocessor preprocessor that has loaded the included files
+     * @param configurations configurations to check
+     * @param fdump dump file
+     * @param checkUnusedFunctions collects the analyzer info of unused functions
+     */
+    void checkConfigurations(const std::string &filename,
+                             const simplecpp::TokenList &tokens1,
+                             std::vector<std::string> &files,
+                             Preprocessor &preprocessor,
+                             const std::set<std::string> &configurations,
+                             std::ofstream &fdump,
+                             CheckUnusedFunctions &checkUnusedFunctions);
+
+    /**
+     * @brief Simplify and check the tokens of one configuration
+     * @param result tokens of the configuration, the results are buffered here
+     * @param filename file name
+     * @param fdump dump file, nullptr if no dump is written
+     * @param isDuplicate returns true if an earlier configuration has the given checksum of the simplified tokens
+     */
+    void checkConfiguration(ConfigurationResult &result,
+                            const std::string &filename,
+                            std::ofstream *fdump,
+                            const std::function<bool(unsigned long long)> &isDuplicate);
+
+    /** @brief Report the buffered results of a configuration */
+    void reportConfigurationResult(ConfigurationResult &result);
 
     /**
      * @brief Check raw tokens
      * @param tokenizer tokenizer instance
+     * @param errorLogger the errors are reported here
      */
-    void checkRawTokens(const Tokenizer &tokenizer);
+    void checkRawTokens(const Tokenizer &tokenizer, ErrorLogger &errorLogger);
 
     /**
      * @brief Check normal tokens
      * @param tokenizer tokenizer instance
+     * @param result the errors and the file info are reported here
      */
-    void checkNormalTokens(const Tokenizer &tokenizer);
+    void checkNormalTokens(const Tokenizer &tokenizer, ConfigurationResult &result);
 
     /**
      * @brief Execute rules, if any
      * @param tokenlist token list to use (normal / simple)
      * @param tokenizer tokenizer
+     * @param errorLogger the errors are reported here
      */
-    void executeRules(const std::string &tokenlist, const Tokenizer &tokenizer);
+    void executeRules(const std::string &tokenlist, const Tokenizer &tokenizer, ErrorLogger &errorLogger);
 
     /**
      * @brief Errors and warnings are directed here.
@@ -203,7 +277,7 @@ private:
 
     void bughuntingReport(const std::string &str) OVERRIDE;
 
-    std::list<std::string> mErrorList;
+    ErrorMessageSet mErrorList;
     Settings mSettings;
 
     void reportProgress(const std::string &filename, const char stage[], const std::size_t value) OVERRIDE;
@@ -215,9 +289,6 @@ private:
 
     ErrorLogger &mErrorLogger;
 
-    /** @brief Current preprocessor configuration */
-    std::string mCurrentConfig;
-
     unsigned int mExitCode;
 
     bool mSuppressInternalErrorFound;
@@ -227,6 +298,9 @@ private:
     /** Are there too many configs? */
     bool mTooManyConfigs;
 
+    /** The results of the last checked file were read from the build dir */
+    bool mUsedCachedResults;
+
     /** Simplify code? true by default */
     bool mSimplify;
 
@@ -235,6 +309,15 @@ private:
 
     AnalyzerInformation mAnalyzerInformation;
 
+    /** Timing results of the file that is checked, they are added to timerResults() when the file is done */
+    TimerResults mFileTimerResults;
+
+    /** Tokenized headers, shared by the files that are checked */
+    simplecpp::HeaderCache *mHeaderCache;
+
+    /** The header cache when it is not shared */
+    std::unique_ptr<simplecpp::HeaderCache> mOwnHeaderCache;
+
     /** Callback for executing a shell command (exe, args, output) */
     std::function<bool(std::string,std::vector<std::string>,std::string,std::string*)> mExecuteCommand;
 };
@@ -23,8 +23,10 @@
 #include "settings.h"
 #include "symboldatabase.h"
 #include "tokenize.h"
+#include "utils.h"
 
 #include <tinyxml2.h>
+#include <cstdint>
 #include <iterator>  // back_inserter
 //---------------------------------------------------------------------------
 
@@ -268,6 +270,189 @@ std::list<CTU::FileInfo::UnsafeUsage> CTU::loadUnsafeUsageListFromXml(const tiny
     return ret;
 }
 
+std::string CTU::FileInfo::toBinary() const
+{
+    if (functionCalls.empty() && nestedCalls.empty())
+        return std::string();
+
+    std::string buffer;
+    appendBinary(buffer, static_cast<std::uint32_t>(functionCalls.size()));
+    for (const CTU::FileInfo::FunctionCall &functionCall : functionCalls)
+        functionCall.writeBinary(buffer);
+    appendBinary(buffer, static_cast<std::uint32_t>(nestedCalls.size()));
+    for (const CTU::FileInfo::NestedCall &nestedCall : nestedCalls)
+        nestedCall.writeBinary(buffer);
+    return buffer;
+}
+
+static void writeLocationBinary(std::string &buffer, const CTU::FileInfo::Location &location)
+{
+    appendBinary(buffer, location.fileName);
+    appendBinary(buffer, static_cast<std::int32_t>(location.lineNumber));
+    appendBinary(buffer, static_cast<std::int32_t>(location.column));
+}
+
+static bool loadLocationFromBinary(const char *&data, const char *end, CTU::FileInfo::Location &location)
+{
+    std::int32_t lineNumber = 0;
+    std::int32_t column = 0;
+    if (!readBinary(data, end, location.fileName) ||
+        !readBinary(data, end, lineNumber) ||
+        !readBinary(data, end, column))
+        return false;
+    location.lineNumber = lineNumber;
+    location.column = column;
+    return true;
+}
+
+void CTU::FileInfo::CallBase::writeBaseBinary(std::string &buffer) const
+{
+    appendBinary(buffer, callId);
+    appendBinary(buffer, static_cast<std::int32_t>(callArgNr));
+    appendBinary(buffer, callFunctionName);
+    writeLocationBinary(buffer, location);
+}
+
+bool CTU::FileInfo::CallBase::loadBaseFromBinary(const char *&data, const char *end)
+{
+    std::int32_t argNr = 0;
+    if (!readBinary(data, end, callId) ||
+        !readBinary(data, end, argNr) ||
+        !readBinary(data, end, callFunctionName) ||
+        !loadLocationFromBinary(data, end, location))
+        return false;
+    callArgNr = argNr;
+    return true;
+}
+
+void CTU::FileInfo::FunctionCall::writeBinary(std::string &buffer) const
+{
+    writeBaseBinary(buffer);
+    appendBinary(buffer, callArgumentExpression);
+    appendBinary(buffer, static_cast<std::int64_t>(callArgValue));
+    appendBinary(buffer, static_cast<std::int32_t>(callValueType));
+    appendBinary(buffer, static_cast<std::uint8_t>(warning));
+    appendBinary(buffer, static_cast<std::uint32_t>(callValuePath.size()));
+    for (const ErrorMessage::FileLocation &loc : callValuePath) {
+        appendBinary(buffer, loc.getfile(false));
+        appendBinary(buffer, static_cast<std::int32_t>(loc.line));
+        appendBinary(buffer, static_cast<std::uint32_t>(loc.column));
+        appendBinary(buffer, loc.getinfo());
+    }
+}
+
+bool CTU::FileInfo::FunctionCall::loadFromBinary(const char *&data, const char *end)
+{
+    std::int64_t argValue = 0;
+    std::int32_t valueType = 0;
+    std::uint8_t w = 0;
+    std::uint32_t pathSize = 0;
+    if (!loadBaseFromBinary(data, end) ||
+        !readBinary(data, end, callArgumentExpression) ||
+        !readBinary(data, end, argValue) ||
+        !readBinary(data, end, valueType) ||
+        !readBinary(data, end, w) ||
+        !readBinary(data, end, pathSize))
+        return false;
+    callArgValue = argValue;
+    callValueType = static_cast<ValueFlow::Value::ValueType>(valueType);
+    warning = (w != 0);
+    callValuePath.clear();
+    for (std::uint32_t i = 0; i < pathSize; ++i) {
+        std::string file, info;
+        std::int32_t line = 0;
+        std::uint32_t column = 0;
+        if (!readBinary(data, end, file) ||
+            !readBinary(data, end, line) ||
+            !readBinary(data, end, column) ||
+            !readBinary(data, end, info))
+            return false;
+        ErrorMessage::FileLocation loc;
+        loc.setfile(file);
+        loc.line = line;
+        loc.column = column;
+        loc.setinfo(info);
+        callValuePath.push_back(loc);
+    }
+    return true;
+}
+
+void CTU::FileInfo::NestedCall::writeBinary(std::string &buffer) const
+{
+    writeBaseBinary(buffer);
+    appendBinary(buffer, myId);
+    appendBinary(buffer, static_cast<std::int32_t>(myArgNr));
+}
+
+bool CTU::FileInfo::NestedCall::loadFromBinary(const char *&data, const char *end)
+{
+    std::int32_t argNr = 0;
+    if (!loadBaseFromBinary(data, end) ||
+        !readBinary(data, end, myId) ||
+        !readBinary(data, end, argNr))
+        return false;
+    myArgNr = argNr;
+    return true;
+}
+
+bool CTU::FileInfo::loadFromBinary(const char *data, const char *end)
+{
+    std::uint32_t count = 0;
+    if (!readBinary(data, end, count))
+        return false;
+    for (std::uint32_t i = 0; i < count; ++i) {
+        FunctionCall functionCall;
+        if (!functionCall.loadFromBinary(data, end))
+            return false;
+        functionCalls.push_back(functionCall);
+    }
+    if (!readBinary(data, end, count))
+        return false;
+    for (std::uint32_t i = 0; i < count; ++i) {
+        NestedCall nestedCall;
+        if (!nestedCall.loadFromBinary(data, end))
+            return false;
+        nestedCalls.push_back(nestedCall);
+    }
+    return true;
+}
+
+std::string CTU::toBinary(const std::list<CTU::FileInfo::UnsafeUsage> &unsafeUsage)
+{
+    std::string buffer;
+    appendBinary(buffer, static_cast<std::uint32_t>(unsafeUsage.size()));
+    for (const CTU::FileInfo::UnsafeUsage &u : unsafeUsage) {
+        appendBinary(buffer, u.myId);
+        appendBinary(buffer, static_cast<std::int32_t>(u.myArgNr));
+        appendBinary(buffer, u.myArgumentName);
+        writeLocationBinary(buffer, u.location);
+        appendBinary(buffer, static_cast<std::int64_t>(u.value));
+    }
+    return buffer;
+}
+
+bool CTU::loadUnsafeUsageListFromBinary(const char *&data, const char *end, std::list<CTU::FileInfo::UnsafeUsage> &unsafeUsage)
+{
+    std::uint32_t count = 0;
+    if (!readBinary(data, end, count))
+        return false;
+    for (std::uint32_t i = 0; i < count; ++i) {
+        FileInfo::UnsafeUsage u;
+        std::int32_t argNr = 0;
+        std::int64_t value = 0;
+        if (!readBinary(data, end, u.myId) ||
+            !readBinary(data, end, argNr) ||
+            !readBinary(data, end, u.myArgumentName) ||
+            !loadLocationFromBinary(data, end, u.location) ||
+            !readBinary(data, end, value))
+            return false;
+        u.myArgNr = argNr;
+        u.value = value;
+        unsafeUsage.push_back(u);
+    }
+    return true;
+}
+
 static int isCallFunction(const Scope *scope, int argnr, const Token **tok)
 {
     const Variable * const argvar = scope->function->getArgumentVar(argnr);
@@ -41,6 +41,7 @@ namespace CTU {
         enum class InvalidValueType { null, uninit, bufferOverflow };
 
         std::string toString() const OVERRIDE;
+        std::string toBinary() const OVERRIDE;
 
         struct Location {
             Location() = default;
@@ -77,6 +78,8 @@ namespace CTU {
         protected:
             std::string toBaseXmlString() const;
             bool loadBaseFromXml(const tinyxml2::XMLElement *xmlElement);
+            void writeBaseBinary(std::string &buffer) const;
+            bool loadBaseFromBinary(const char *&data, const char *end);
         };
 
         class FunctionCall : public CallBase {
@@ -89,6 +92,8 @@ namespace CTU {
 
             std::string toXmlString() const;
             bool loadFromXml(const tinyxml2::XMLElement *xmlElement);
+            void writeBinary(std::string &buffer) const;
+            bool loadFromBinary(const char *&data, const char *end);
         };
 
         class NestedCall : public CallBase {
@@ -105,6 +110,8 @@ namespace CTU {
 
             std::string toXmlString() const;
             bool loadFromXml(const tinyxml2::XMLElement *xmlElement);
+            void writeBinary(std::string &buffer) const;
+            bool loadFromBinary(const char *&data, const char *end);
 
             std::string myId;
             nonneg int myArgNr;
@@ -114,6 +121,7 @@ namespace CTU {
         std::list<NestedCall> nestedCalls;
 
         void loadFromXml(const tinyxml2::XMLElement *xmlElement);
+        bool loadFromBinary(const char *data, const char *end);
         std::map<std::string, std::list<const CallBase *>> getCallsMap() const;
 
         std::list<ErrorMessage::FileLocation> getErrorPath(InvalidValueType invalidValue,
@@ -136,6 +144,10 @@ namespace CTU {
     CPPCHECKLIB std::list<FileInfo::UnsafeUsage> getUnsafeUsage(const Tokenizer *tokenizer, const Settings *settings, const Check *check, bool (*isUnsafeUsage)(const Check *check, const Token *argtok, MathLib::bigint *value));
 
     CPPCHECKLIB std::list<FileInfo::UnsafeUsage> loadUnsafeUsageListFromXml(const tinyxml2::XMLElement *xmlElement);
+
+    CPPCHECKLIB std::string toBinary(const std::list<FileInfo::UnsafeUsage> &unsafeUsage);
+
+    CPPCHECKLIB bool loadUnsafeUsageListFromBinary(const char *&data, const char *end, std::list<FileInfo::UnsafeUsage> &unsafeUsage);
 }
 
 /// @}
@@ -29,6 +29,8 @@
 #include <array>
 #include <cassert>
 #include <cctype>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <iomanip>
@@ -378,6 +380,64 @@ bool ErrorMessage::deserialize(const std::string &data)
     return true;
 }
 
+void ErrorMessage::serializeBinary(std::string &buffer) const
+{
+    appendBinary(buffer, id);
+    appendBinary(buffer, static_cast<std::int32_t>(severity));
+    appendBinary(buffer, cwe.id);
+    appendBinary(buffer, static_cast<std::uint64_t>(hash));
+    appendBinary(buffer, static_cast<std::uint8_t>(inconclusive));
+    appendBinary(buffer, fixInvalidChars(mShortMessage));
+    appendBinary(buffer, fixInvalidChars(mVerboseMessage));
+    appendBinary(buffer, static_cast<std::uint32_t>(callStack.size()));
+    for (const ErrorMessage::FileLocation &loc : callStack) {
+        appendBinary(buffer, static_cast<std::int32_t>(loc.line));
+        appendBinary(buffer, static_cast<std::uint32_t>(loc.column));
+        appendBinary(buffer, loc.getfile(false));
+        appendBinary(buffer, loc.getOrigFile(false));
+        appendBinary(buffer, loc.getinfo());
+    }
+}
+
+bool ErrorMessage::deserializeBinary(const char *&data, const char *end)
+{
+    callStack.clear();
+
+    std::int32_t sev = 0;
+    std::uint64_t h = 0;
+    std::uint8_t inconcl = 0;
+    std::uint32_t stackSize = 0;
+    if (!readBinary(data, end, id) ||
+        !readBinary(data, end, sev) ||
+        !readBinary(data, end, cwe.id) ||
+        !readBinary(data, end, h) ||
+        !readBinary(data, end, inconcl) ||
+        !readBinary(data, end, mShortMessage) ||
+        !readBinary(data, end, mVerboseMessage) ||
+        !readBinary(data, end, stackSize))
+        return false;
+    severity = static_cast<Severity::SeverityType>(sev);
+    hash = static_cast<std::size_t>(h);
+    inconclusive = (inconcl != 0);
+
+    for (std::uint32_t i = 0; i < stackSize; ++i) {
+        std::int32_t line = 0;
+        std::uint32_t column = 0;
+        std::string file, origFile, info;
+        if (!readBinary(data, end, line) ||
+            !readBinary(data, end, column) ||
+            !readBinary(data, end, file) ||
+            !readBinary(data, end, origFile) ||
+            !readBinary(data, end, info))
+            return false;
+        ErrorMessage::FileLocation loc(origFile, info, line, column);
+        loc.setfile(file);
+        callStack.push_back(loc);
+    }
+
+    return true;
+}
+
 std::string ErrorMessage::getXMLHeader()
 {
     tinyxml2::XMLPrinter printer;
@@ -671,6 +731,45 @@ std::string ErrorMessage::FileLocation::stringify() const
     return oss.str();
 }
 
+static void combineHash(std::size_t &seed, std::size_t value)
+{
+    seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+ErrorMessageSet::Key ErrorMessageSet::makeKey(const ErrorMessage &msg, bool verbose)
+{
+    Key key;
+    key.id = msg.id;
+    key.severity = msg.severity;
+    key.inconclusive = msg.inconclusive;
+    key.locations.reserve(msg.callStack.size());
+    for (const ErrorMessage::FileLocation &loc : msg.callStack)
+        key.locations.emplace_back(loc.getfile(false), loc.line);
+    key.text = verbose ? msg.verboseMessage() : msg.shortMessage();
+
+    const std::hash<std::string> stringHash;
+    key.hash = stringHash(key.text);
+    combineHash(key.hash, stringHash(key.id));
+    combineHash(key.hash, key.severity);
+    combineHash(key.hash, key.inconclusive);
+    for (const std::pair<std::string, int> &loc : key.locations) {
+        combineHash(key.hash, stringHash(loc.first));
+        combineHash(key.hash, loc.second);
+    }
+
+    return key;
+}
+
+bool ErrorMessageSet::insert(const ErrorMessage &msg, bool verbose)
+{
+    return mMessages.insert(makeKey(msg, verbose)).second;
+}
+
+bool ErrorMessageSet::contains(const ErrorMessage &msg, bool verbose) const
+{
+    return mMessages.find(makeKey(msg, verbose)) != mMessages.end();
+}
+
 std::string ErrorLogger::toxml(const std::string &str)
 {
     std::ostringstream xml;
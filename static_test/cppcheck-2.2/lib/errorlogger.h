@@ -29,6 +29,7 @@
 #include <fstream>
 #include <list>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -182,6 +183,21 @@ public:
     std::string serialize() const;
     bool deserialize(const std::string &data);
 
+    /**
+     * Append the message in a compact binary format to buffer. The data is
+     * in native byte order, it is meant for passing messages between
+     * processes of the same cppcheck binary.
+     */
+    void serializeBinary(std::string &buffer) const;
+
+    /**
+     * Read a message written by serializeBinary().
+     * @param data start of the data, it is moved past the message
+     * @param end end of the data
+     * @return false if the data is truncated
+     */
+    bool deserializeBinary(const char *&data, const char *end);
+
     std::list<FileLocation> callStack;
     std::string id;
 
@@ -241,6 +257,66 @@ private:
     std::string mSymbolNames;
 };
 
+/**
+ * @brief Set of reported error messages, used to report every message once.
+ * Two messages are the same if they have the same id, severity,
+ * inconclusive flag, locations (file and line) and message text.
+ */
+class CPPCHECKLIB ErrorMessageSet {
+public:
+    /**
+     * Add a message to the set.
+     * @param msg the message
+     * @param verbose compare the verbose message instead of the short message
+     * @return true if the message was added, false if it was in the set already
+     */
+    bool insert(const ErrorMessage &msg, bool verbose);
+
+    /**
+     * Is the message in the set?
+     * @param msg the message
+     * @param verbose compare the verbose message instead of the short message
+     */
+    bool contains(const ErrorMessage &msg, bool verbose) const;
+
+    void clear() {
+        mMessages.clear();
+    }
+
+    std::size_t size() const {
+        return mMessages.size();
+    }
+
+private:
+    struct Key {
+        std::string id;
+        Severity::SeverityType severity;
+        bool inconclusive;
+        std::vector<std::pair<std::string, int>> locations;
+        std::string text;
+        std::size_t hash;
+
+        bool operator==(const Key &other) const {
+            return hash == other.hash &&
+                   severity == other.severity &&
+                   inconclusive == other.inconclusive &&
+                   id == other.id &&
+                   text == other.text &&
+                   locations == other.locations;
+        }
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key &key) const {
+            return key.hash;
+        }
+    };
+
+    static Key makeKey(const ErrorMessage &msg, bool verbose);
+
+    std::unordered_set<Key, KeyHash> mMessages;
+};
+
 /**
  * @brief This is an interface, which the class responsible of error logging
  * should implement.
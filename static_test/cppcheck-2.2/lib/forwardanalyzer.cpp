@@ -3,18 +3,93 @@
 #include "settings.h"
 #include "symboldatabase.h"
 #include "token.h"
+#include "tokenlist.h"
 #include "valueptr.h"
 
 #include <algorithm>
 #include <functional>
+#include <tuple>
+#include <utility>
+
+ForwardAnalysisBudget::Usage::Usage(ForwardAnalysisBudget &budget)
+    : mBudget(budget), mTokens(0), mForks(0), mExceeded(false)
+{}
+
+bool ForwardAnalysisBudget::Usage::visit()
+{
+    const std::size_t tokens = mTokens.fetch_add(1, std::memory_order_relaxed) + 1;
+    const int maxTokens = mBudget.mSettings->maxValueFlowTokens;
+    if (maxTokens > 0 && tokens > static_cast<std::size_t>(maxTokens))
+        mExceeded = true;
+    // Looking at the clock for every token would be too slow
+    else if (tokens % 1024 == 0)
+        mBudget.checkTime();
+    return !exceeded();
+}
+
+bool ForwardAnalysisBudget::Usage::fork()
+{
+    const std::size_t forks = mForks.fetch_add(1, std::memory_order_relaxed) + 1;
+    const int maxForks = mBudget.mSettings->maxValueFlowForks;
+    if (maxForks > 0 && forks > static_cast<std::size_t>(maxForks))
+        mExceeded = true;
+    else
+        mBudget.checkTime();
+    return !exceeded();
+}
+
+bool ForwardAnalysisBudget::Usage::exceeded() const
+{
+    return mExceeded.load(std::memory_order_relaxed) || mBudget.mTimeExceeded.load(std::memory_order_relaxed);
+}
+
+ForwardAnalysisBudget::ForwardAnalysisBudget(const Settings* settings)
+    : mSettings(settings)
+    , mStopTime(std::chrono::steady_clock::now() + std::chrono::seconds(settings->maxValueFlowTime))
+    , mTimeExceeded(false)
+{}
+
+ForwardAnalysisBudget::Usage *ForwardAnalysisBudget::usage(const Token* tok)
+{
+    const Scope* scope = tok ? tok->scope() : nullptr;
+    while (scope && scope->type != Scope::eFunction)
+        scope = scope->nestedIn;
+    std::lock_guard<std::mutex> lock(mMutex);
+    std::map<const Scope*, Usage>::iterator it = mUsage.find(scope);
+    if (it == mUsage.end())
+        it = mUsage.emplace(std::piecewise_construct, std::forward_as_tuple(scope), std::forward_as_tuple(*this)).first;
+    return &it->second;
+}
+
+bool ForwardAnalysisBudget::checkTime()
+{
+    if (!timeExceeded() && mSettings->maxValueFlowTime > 0 && std::chrono::steady_clock::now() >= mStopTime)
+        mTimeExceeded = true;
+    return timeExceeded();
+}
+
+std::vector<const Scope*> ForwardAnalysisBudget::exceededFunctions() const
+{
+    std::vector<const Scope*> functions;
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (const std::pair<const Scope* const, Usage> &u : mUsage) {
+        if (u.first && u.second.mExceeded)
+            functions.push_back(u.first);
+    }
+    std::sort(functions.begin(), functions.end(), [](const Scope* a, const Scope* b) {
+        return a->bodyStart->index() < b->bodyStart->index();
+    });
+    return functions;
+}
 
 struct ForwardTraversal {
     enum class Progress { Continue, Break, Skip };
-    ForwardTraversal(const ValuePtr<ForwardAnalyzer>& analyzer, const Settings* settings)
-        : analyzer(analyzer), settings(settings), actions(ForwardAnalyzer::Action::None), analyzeOnly(false)
+    ForwardTraversal(const ValuePtr<ForwardAnalyzer>& analyzer, const Settings* settings, ForwardAnalysisBudget::Usage* budget)
+        : analyzer(analyzer), settings(settings), budget(budget), actions(ForwardAnalyzer::Action::None), analyzeOnly(false)
     {}
     ValuePtr<ForwardAnalyzer> analyzer;
     const Settings* settings;
+    ForwardAnalysisBudget::Usage* budget;
     ForwardAnalyzer::Action actions;
     bool analyzeOnly;
 
@@ -23,8 +98,23 @@ struct ForwardTraversal {
         return actions.isModified();
     }
 
+    /** Has the function exceeded its budget? Then the analysis is less precise but faster */
+    bool isOverBudget() const {
+        return budget && budget->exceeded();
+    }
+
+    ForwardAnalyzer::Action analyze(const Token* tok) {
+        if (budget)
+            budget->visit();
+        return analyzer->analyze(tok);
+    }
+
     std::pair<bool, bool> evalCond(const Token* tok) {
-        std::vector<int> result = analyzer->evaluate(tok);
+        std::vector<int> result;
+        if (!isOverBudget())
+            result = analyzer->evaluate(tok);
+        else if (tok->hasKnownIntValue())
+            result.push_back(static_cast<int>(tok->getKnownIntValue()));
         bool checkThen = std::any_of(result.begin(), result.end(), [](int x) {
             return x;
         });
@@ -124,7 +214,7 @@ struct ForwardTraversal {
     }
 
     Progress update(Token* tok) {
-        ForwardAnalyzer::Action action = analyzer->analyze(tok);
+        ForwardAnalyzer::Action action = analyze(tok);
         actions |= action;
         if (!action.isNone() && !analyzeOnly)
             analyzer->update(tok, action);
@@ -155,7 +245,7 @@ struct ForwardTraversal {
     template <class T>
     T* findRange(T* start, const Token* end, std::function<bool(ForwardAnalyzer::Action)> pred) {
         for (T* tok = start; tok && tok != end; tok = tok->next()) {
-            ForwardAnalyzer::Action action = analyzer->analyze(tok);
+            ForwardAnalyzer::Action action = analyze(tok);
             if (pred(action))
                 return tok;
         }
@@ -165,7 +255,7 @@ struct ForwardTraversal {
     ForwardAnalyzer::Action analyzeRecursive(const Token* start) {
         ForwardAnalyzer::Action result = ForwardAnalyzer::Action::None;
         std::function<Progress(const Token *)> f = [&](const Token* tok) {
-            result = analyzer->analyze(tok);
+            result = analyze(tok);
             if (result.isModified() || result.isInconclusive())
                 return Progress::Break;
             return Progress::Continue;
@@ -177,7 +267,7 @@ struct ForwardTraversal {
     ForwardAnalyzer::Action analyzeRange(const Token* start, const Token* end) {
         ForwardAnalyzer::Action result = ForwardAnalyzer::Action::None;
         for (const Token* tok = start; tok && tok != end; tok = tok->next()) {
-            ForwardAnalyzer::Action action = analyzer->analyze(tok);
+            ForwardAnalyzer::Action action = analyze(tok);
             if (action.isModified() || action.isInconclusive())
                 return action;
             result = action;
@@ -186,7 +276,11 @@ struct ForwardTraversal {
     }
 
     void forkScope(Token* endBlock, bool isModified = false) {
+        if (isOverBudget())
+            return;
         if (analyzer->updateScope(endBlock, isModified)) {
+            if (budget && !budget->fork())
+                return;
             ForwardTraversal ft = *this;
             ft.updateRange(endBlock->link(), endBlock);
         }
@@ -322,7 +416,7 @@ struct ForwardTraversal {
                     if (!condTok->hasKnownIntValue() || inLoop) {
                         if (!analyzer->lowerToPossible())
                             return Progress::Break;
-                    } else if (condTok->values().front().intvalue == inElse) {
+                    } else if (condTok->getKnownIntValue() == inElse) {
                         return Progress::Break;
                     }
                     // Handle for loop
@@ -570,9 +664,13 @@ struct ForwardTraversal {
 ForwardAnalyzer::Action valueFlowGenericForward(Token* start,
         const Token* end,
         const ValuePtr<ForwardAnalyzer>& fa,
+        const TokenList* tokenlist,
         const Settings* settings)
 {
-    ForwardTraversal ft{fa, settings};
+    ForwardAnalysisBudget* budget = tokenlist ? tokenlist->getForwardAnalysisBudget() : nullptr;
+    if (budget)
+        budget->checkTime();
+    ForwardTraversal ft{fa, settings, budget ? budget->usage(start) : nullptr};
     ft.updateRange(start, end);
     return ft.actions;
 }
@@ -19,10 +19,19 @@
 #ifndef forwardanalyzerH
 #define forwardanalyzerH
 
+#include "config.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <mutex>
 #include <vector>
 
+class Scope;
 class Settings;
 class Token;
+class TokenList;
 template <class T> class ValuePtr;
 
 struct ForwardAnalyzer {
@@ -113,9 +122,67 @@ struct ForwardAnalyzer {
     virtual ~ForwardAnalyzer() {}
 };
 
+/**
+ * Budget of the forward analysis of the values in one file. The visited
+ * tokens and the forked scopes are counted per function. When the budget
+ * of a function or the time budget of the file is exceeded, the forward
+ * analysis in the function no longer forks scopes and only uses known
+ * values to evaluate conditions. That is less precise, but the cost is
+ * linear in the number of tokens.
+ */
+class CPPCHECKLIB ForwardAnalysisBudget {
+public:
+    /** Budget usage of one function */
+    class CPPCHECKLIB Usage {
+    public:
+        explicit Usage(ForwardAnalysisBudget &budget);
+
+        /** Count a visited token. @return false if the budget is exceeded */
+        bool visit();
+
+        /** Count a forked scope. @return false if the budget is exceeded */
+        bool fork();
+
+        /** Is the budget of the function or the time budget of the file exceeded? */
+        bool exceeded() const;
+
+    private:
+        friend class ForwardAnalysisBudget;
+
+        ForwardAnalysisBudget &mBudget;
+        std::atomic<std::size_t> mTokens;
+        std::atomic<std::size_t> mForks;
+        std::atomic<bool> mExceeded;
+    };
+
+    explicit ForwardAnalysisBudget(const Settings* settings);
+
+    /** @return the usage of the function that contains the token */
+    Usage *usage(const Token* tok);
+
+    /** Look at the clock. @return true if the time budget is exceeded */
+    bool checkTime();
+
+    /** Was the time budget exceeded when the clock was last looked at? */
+    bool timeExceeded() const {
+        return mTimeExceeded.load(std::memory_order_relaxed);
+    }
+
+    /** @return the functions that exceeded their budget, in the order of the code */
+    std::vector<const Scope*> exceededFunctions() const;
+
+private:
+    const Settings* mSettings;
+    std::chrono::steady_clock::time_point mStopTime;
+    std::atomic<bool> mTimeExceeded;
+    mutable std::mutex mMutex;
+    std::map<const Scope*, Usage> mUsage;
+};
+
 ForwardAnalyzer::Action valueFlowGenericForward(Token* start,
         const Token* end,
         const ValuePtr<ForwardAnalyzer>& fa,
+        const TokenList* tokenlist,
         const Settings* settings);
 
 #endif
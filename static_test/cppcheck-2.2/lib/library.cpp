@@ -56,7 +56,7 @@ static void gettokenlistfromvalid(const std::string& valid, TokenList& tokenList
     }
 }
 
-Library::Library() : mAllocId(0)
+Library::Library() : mAllocId(0), mIndexedContainers(0)
 {
 }
 
@@ -171,7 +171,7 @@ Library::Error Library::load(const tinyxml2::XMLDocument &doc)
             int allocationId = 0;
             for (const tinyxml2::XMLElement *memorynode = node->FirstChildElement(); memorynode; memorynode = memorynode->NextSiblingElement()) {
                 if (strcmp(memorynode->Name(),"dealloc")==0) {
-                    const std::map<std::string, AllocFunc>::const_iterator it = mDealloc.find(memorynode->GetText());
+                    const std::unordered_map<std::string, AllocFunc>::const_iterator it = mDealloc.find(memorynode->GetText());
                     if (it != mDealloc.end()) {
                         allocationId = it->second.groupId;
                         break;
@@ -625,6 +625,8 @@ Library::Error Library::load(const tinyxml2::XMLDocument &doc)
         else
             unknown_elements.insert(nodename);
     }
+    indexContainers();
+    indexDefines();
     if (!unknown_elements.empty()) {
         std::string str;
         for (std::set<std::string>::const_iterator i = unknown_elements.begin(); i != unknown_elements.end();) {
@@ -1000,7 +1002,7 @@ bool Library::isnullargbad(const Token *ftok, int argnr) const
     if (!arg) {
         // scan format string argument should not be null
         const std::string funcname = getFunctionName(ftok);
-        const std::map<std::string, Function>::const_iterator it = functions.find(funcname);
+        const std::unordered_map<std::string, Function>::const_iterator it = functions.find(funcname);
         if (it != functions.cend() && it->second.formatstr && it->second.formatstr_scan)
             return true;
     }
@@ -1013,7 +1015,7 @@ bool Library::isuninitargbad(const Token *ftok, int argnr, int indirect, bool *h
     if (!arg) {
         // non-scan format string argument should not be uninitialized
         const std::string funcname = getFunctionName(ftok);
-        const std::map<std::string, Function>::const_iterator it = functions.find(funcname);
+        const std::unordered_map<std::string, Function>::const_iterator it = functions.find(funcname);
         if (it != functions.cend() && it->second.formatstr && !it->second.formatstr_scan)
             return true;
     }
@@ -1027,21 +1029,24 @@ bool Library::isuninitargbad(const Token *ftok, int argnr, int indirect, bool *h
 const Library::AllocFunc* Library::getAllocFuncInfo(const Token *tok) const
 {
     const std::string funcname = getFunctionName(tok);
-    return isNotLibraryFunction(tok) && functions.find(funcname) != functions.end() ? nullptr : getAllocDealloc(mAlloc, funcname);
+    const AllocFunc *af = getAllocDealloc(mAlloc, funcname);
+    return af && functions.find(funcname) != functions.end() && isNotLibraryFunction(tok) ? nullptr : af;
 }
 
 /** get deallocation info for function */
 const Library::AllocFunc* Library::getDeallocFuncInfo(const Token *tok) const
 {
     const std::string funcname = getFunctionName(tok);
-    return isNotLibraryFunction(tok) && functions.find(funcname) != functions.end() ? nullptr : getAllocDealloc(mDealloc, funcname);
+    const AllocFunc *af = getAllocDealloc(mDealloc, funcname);
+    return af && functions.find(funcname) != functions.end() && isNotLibraryFunction(tok) ? nullptr : af;
 }
 
 /** get reallocation info for function */
 const Library::AllocFunc* Library::getReallocFuncInfo(const Token *tok) const
 {
     const std::string funcname = getFunctionName(tok);
-    return isNotLibraryFunction(tok) && functions.find(funcname) != functions.end() ? nullptr : getAllocDealloc(mRealloc, funcname);
+    const AllocFunc *af = getAllocDealloc(mRealloc, funcname);
+    return af && functions.find(funcname) != functions.end() && isNotLibraryFunction(tok) ? nullptr : af;
 }
 
 /** get allocation id for function */
@@ -1068,16 +1073,15 @@ int Library::getReallocId(const Token *tok, int arg) const
 
 const Library::ArgumentChecks * Library::getarg(const Token *ftok, int argnr) const
 {
-    if (isNotLibraryFunction(ftok))
+    const Function *func;
+    getLibraryFunctionName(ftok, &func);
+    if (!func)
         return nullptr;
-    const std::map<std::string, Function>::const_iterator it1 = functions.find(getFunctionName(ftok));
-    if (it1 == functions.cend())
-        return nullptr;
-    const std::map<int,ArgumentChecks>::const_iterator it2 = it1->second.argumentChecks.find(argnr);
-    if (it2 != it1->second.argumentChecks.cend())
+    const std::map<int,ArgumentChecks>::const_iterator it2 = func->argumentChecks.find(argnr);
+    if (it2 != func->argumentChecks.cend())
         return &it2->second;
-    const std::map<int,ArgumentChecks>::const_iterator it3 = it1->second.argumentChecks.find(-1);
-    if (it3 != it1->second.argumentChecks.cend())
+    const std::map<int,ArgumentChecks>::const_iterator it3 = func->argumentChecks.find(-1);
+    if (it3 != func->argumentChecks.cend())
         return &it3->second;
     return nullptr;
 }
@@ -1121,27 +1125,130 @@ bool Library::isScopeNoReturn(const Token *end, std::string *unknownFunc) const
     return false;
 }
 
-const Library::Container* Library::detectContainer(const Token* typeStart, bool iterator) const
+void Library::indexContainers()
 {
+    mContainerStarts.clear();
+    mIndexedContainers = containers.size();
     for (std::map<std::string, Container>::const_iterator i = containers.begin(); i != containers.end(); ++i) {
-        const Container& container = i->second;
-        if (container.startPattern.empty())
+        const std::string &startPattern = i->second.startPattern;
+        if (startPattern.empty())
             continue;
+        std::string first = startPattern.substr(0, startPattern.find(' '));
+        if (first.find_first_of("%|!") != std::string::npos || (first.size() > 1 && first[0] == '['))
+            first.clear();
+        mContainerStarts[first].push_back(i->first);
+    }
+}
+
+void Library::indexDefines()
+{
+    for (std::size_t i = mDefineUses.size(); i < defines.size(); ++i) {
+        const std::string &def = defines[i];
+        const std::string::size_type pos = def.find_first_of(" (");
+        mDefineIndexes[def.substr(0, pos)].push_back(i);
+
+        DefineUses uses;
+        const std::string::size_type hash = def.find('#');
+        uses.pastes = hash != std::string::npos && def.find('#', hash + 1) != std::string::npos;
+        const std::string::size_type valuePos = (pos == std::string::npos) ? def.size() : def.find(' ', pos);
+        for (std::string::size_type p = valuePos; p < def.size();) {
+            const unsigned char c = def[p];
+            if (std::isalpha(c) || c == '_') {
+                const std::string::size_type start = p;
+                while (p < def.size() && (std::isalnum((unsigned char)def[p]) || def[p] == '_'))
+                    ++p;
+                uses.names.push_back(def.substr(start, p - start));
+            } else if (std::isdigit(c)) {
+                while (p < def.size() && (std::isalnum((unsigned char)def[p]) || def[p] == '_' || def[p] == '.'))
+                    ++p;
+            } else {
+                ++p;
+            }
+        }
+        mDefineUses.push_back(uses);
+    }
+}
 
-        if (!Token::Match(typeStart, container.startPattern2.c_str()))
+std::vector<std::size_t> Library::getUsedDefines(const std::set<std::string> &names) const
+{
+    std::vector<std::size_t> ret;
+
+    // Defines that are added after the library is loaded are not indexed.
+    // A define that pastes tokens can create any name.
+    bool all = mDefineUses.size() != defines.size();
+
+    std::vector<bool> used(defines.size(), false);
+    std::vector<const std::string *> todo;
+    for (const std::string &name : names)
+        todo.push_back(&name);
+    while (!all && !todo.empty()) {
+        const std::unordered_map<std::string, std::vector<std::size_t>>::const_iterator it = mDefineIndexes.find(*todo.back());
+        todo.pop_back();
+        if (it == mDefineIndexes.end())
             continue;
+        for (std::size_t i : it->second) {
+            if (used[i])
+                continue;
+            used[i] = true;
+            all |= mDefineUses[i].pastes;
+            for (const std::string &name : mDefineUses[i].names)
+                todo.push_back(&name);
+        }
+    }
+
+    for (std::size_t i = 0; i < defines.size(); ++i) {
+        if (all || used[i])
+            ret.push_back(i);
+    }
+    return ret;
+}
 
-        if (!iterator && container.endPattern.empty()) // If endPattern is undefined, it will always match, but itEndPattern has to be defined.
-            return &container;
+static bool matchContainer(const Library::Container &container, const Token* typeStart, bool iterator)
+{
+    if (!Token::Match(typeStart, container.startPattern2.c_str()))
+        return false;
 
-        for (const Token* tok = typeStart; tok && !tok->varId(); tok = tok->next()) {
-            if (tok->link()) {
-                const std::string& endPattern = iterator ? container.itEndPattern : container.endPattern;
-                if (Token::Match(tok->link(), endPattern.c_str()))
-                    return &container;
-                break;
-            }
+    if (!iterator && container.endPattern.empty()) // If endPattern is undefined, it will always match, but itEndPattern has to be defined.
+        return true;
+
+    for (const Token* tok = typeStart; tok && !tok->varId(); tok = tok->next()) {
+        if (tok->link()) {
+            const std::string& endPattern = iterator ? container.itEndPattern : container.endPattern;
+            return Token::Match(tok->link(), endPattern.c_str());
+        }
+    }
+    return false;
+}
+
+const Library::Container* Library::detectContainer(const Token* typeStart, bool iterator) const
+{
+    if (!typeStart)
+        return nullptr;
+
+    // Containers that are added after the library is loaded are not indexed
+    if (mIndexedContainers != containers.size()) {
+        for (std::map<std::string, Container>::const_iterator i = containers.begin(); i != containers.end(); ++i) {
+            if (!i->second.startPattern.empty() && matchContainer(i->second, typeStart, iterator))
+                return &i->second;
         }
+        return nullptr;
+    }
+
+    // Only the containers whose start pattern begins with this token can
+    // match. They are tried in the order of their ids, merged with the
+    // containers whose pattern begins with a wildcard.
+    static const std::vector<std::string> noIds;
+    const std::unordered_map<std::string, std::vector<std::string>>::const_iterator it1 = mContainerStarts.find(typeStart->str());
+    const std::unordered_map<std::string, std::vector<std::string>>::const_iterator it2 = mContainerStarts.find(emptyString);
+    const std::vector<std::string> &ids1 = (it1 != mContainerStarts.end()) ? it1->second : noIds;
+    const std::vector<std::string> &ids2 = (it2 != mContainerStarts.end() && !typeStart->str().empty()) ? it2->second : noIds;
+    std::vector<std::string>::const_iterator id1 = ids1.begin();
+    std::vector<std::string>::const_iterator id2 = ids2.begin();
+    while (id1 != ids1.end() || id2 != ids2.end()) {
+        const std::string &id = (id2 == ids2.end() || (id1 != ids1.end() && *id1 < *id2)) ? *id1++ : *id2++;
+        const std::map<std::string, Container>::const_iterator i = containers.find(id);
+        if (i != containers.end() && matchContainer(i->second, typeStart, iterator))
+            return &i->second;
     }
     return nullptr;
 }
@@ -1165,28 +1272,24 @@ bool Library::isContainerYield(const Token * const cond, Library::Container::Yie
     return false;
 }
 
-// returns true if ftok is not a library function
-bool Library::isNotLibraryFunction(const Token *ftok) const
+// returns true if the function or variable of ftok rules out a library function
+static bool isNotLibraryFunctionToken(const Token *ftok)
 {
     if (ftok->function() && ftok->function()->nestedIn && ftok->function()->nestedIn->type != Scope::eGlobal)
         return true;
 
     // variables are not library functions.
-    if (ftok->varId())
-        return true;
-
-    return !matchArguments(ftok, getFunctionName(ftok));
+    return ftok->varId() != 0;
 }
 
-bool Library::matchArguments(const Token *ftok, const std::string &functionName) const
+static bool matchFunctionArguments(const Token *ftok, const Library::Function *func)
 {
     const int callargs = numberOfArguments(ftok);
-    const std::map<std::string, Function>::const_iterator it = functions.find(functionName);
-    if (it == functions.cend())
+    if (!func)
         return (callargs == 0);
     int args = 0;
     int firstOptionalArg = -1;
-    for (std::map<int, ArgumentChecks>::const_iterator it2 = it->second.argumentChecks.cbegin(); it2 != it->second.argumentChecks.cend(); ++it2) {
+    for (std::map<int, Library::ArgumentChecks>::const_iterator it2 = func->argumentChecks.cbegin(); it2 != func->argumentChecks.cend(); ++it2) {
         if (it2->first > args)
             args = it2->first;
         if (it2->second.optional && (firstOptionalArg == -1 || firstOptionalArg > it2->first))
@@ -1198,11 +1301,42 @@ bool Library::matchArguments(const Token *ftok, const std::string &functionName)
     return (firstOptionalArg < 0) ? args == callargs : (callargs >= firstOptionalArg-1 && callargs <= args);
 }
 
+// returns true if ftok is not a library function
+bool Library::isNotLibraryFunction(const Token *ftok) const
+{
+    if (isNotLibraryFunctionToken(ftok))
+        return true;
+
+    return !matchArguments(ftok, getFunctionName(ftok));
+}
+
+bool Library::matchArguments(const Token *ftok, const std::string &functionName) const
+{
+    const std::unordered_map<std::string, Function>::const_iterator it = functions.find(functionName);
+    return matchFunctionArguments(ftok, (it != functions.cend()) ? &it->second : nullptr);
+}
+
+std::string Library::getLibraryFunctionName(const Token *ftok, const Function **func) const
+{
+    *func = nullptr;
+    if (isNotLibraryFunctionToken(ftok))
+        return emptyString;
+    std::string name = getFunctionName(ftok);
+    const std::unordered_map<std::string, Function>::const_iterator it = functions.find(name);
+    if (!matchFunctionArguments(ftok, (it != functions.cend()) ? &it->second : nullptr))
+        return emptyString;
+    if (it != functions.cend())
+        *func = &it->second;
+    return name;
+}
+
 const Library::WarnInfo* Library::getWarnInfo(const Token* ftok) const
 {
-    if (isNotLibraryFunction(ftok))
+    const Function *func;
+    const std::string funcname = getLibraryFunctionName(ftok, &func);
+    if (funcname.empty())
         return nullptr;
-    std::map<std::string, WarnInfo>::const_iterator i = functionwarn.find(getFunctionName(ftok));
+    std::map<std::string, WarnInfo>::const_iterator i = functionwarn.find(funcname);
     if (i == functionwarn.cend())
         return nullptr;
     return &i->second;
@@ -1248,13 +1382,9 @@ bool Library::isCompliantValidationExpression(const char* p)
 
 bool Library::formatstr_function(const Token* ftok) const
 {
-    if (isNotLibraryFunction(ftok))
-        return false;
-
-    const std::map<std::string, Function>::const_iterator it = functions.find(getFunctionName(ftok));
-    if (it != functions.cend())
-        return it->second.formatstr;
-    return false;
+    const Function *func;
+    getLibraryFunctionName(ftok, &func);
+    return func && func->formatstr;
 }
 
 int Library::formatstr_argno(const Token* ftok) const
@@ -1280,65 +1410,66 @@ bool Library::formatstr_secure(const Token* ftok) const
 
 bool Library::isUseRetVal(const Token* ftok) const
 {
-    if (isNotLibraryFunction(ftok))
-        return false;
-    const std::map<std::string, Function>::const_iterator it = functions.find(getFunctionName(ftok));
-    if (it != functions.cend())
-        return it->second.useretval;
-    return false;
+    const Function *func;
+    getLibraryFunctionName(ftok, &func);
+    return func && func->useretval;
 }
 
 const std::string& Library::returnValue(const Token *ftok) const
 {
-    if (isNotLibraryFunction(ftok))
+    const Function *func;
+    const std::string funcname = getLibraryFunctionName(ftok, &func);
+    if (funcname.empty())
         return emptyString;
-    const std::map<std::string, std::string>::const_iterator it = mReturnValue.find(getFunctionName(ftok));
+    const std::unordered_map<std::string, std::string>::const_iterator it = mReturnValue.find(funcname);
     return it != mReturnValue.end() ? it->second : emptyString;
 }
 
 const std::string& Library::returnValueType(const Token *ftok) const
 {
-    if (isNotLibraryFunction(ftok))
+    const Function *func;
+    const std::string funcname = getLibraryFunctionName(ftok, &func);
+    if (funcname.empty())
         return emptyString;
-    const std::map<std::string, std::string>::const_iterator it = mReturnValueType.find(getFunctionName(ftok));
+    const std::unordered_map<std::string, std::string>::const_iterator it = mReturnValueType.find(funcname);
     return it != mReturnValueType.end() ? it->second : emptyString;
 }
 
 int Library::returnValueContainer(const Token *ftok) const
 {
-    if (isNotLibraryFunction(ftok))
+    const Function *func;
+    const std::string funcname = getLibraryFunctionName(ftok, &func);
+    if (funcname.empty())
         return -1;
-    const std::map<std::string, int>::const_iterator it = mReturnValueContainer.find(getFunctionName(ftok));
+    const std::unordered_map<std::string, int>::const_iterator it = mReturnValueContainer.find(funcname);
     return it != mReturnValueContainer.end() ? it->second : -1;
 }
 
 std::vector<MathLib::bigint> Library::unknownReturnValues(const Token *ftok) const
 {
-    if (isNotLibraryFunction(ftok))
+    const Function *func;
+    const std::string funcname = getLibraryFunctionName(ftok, &func);
+    if (funcname.empty())
         return std::vector<MathLib::bigint>();
-    const std::map<std::string, std::vector<MathLib::bigint>>::const_iterator it = mUnknownReturnValues.find(getFunctionName(ftok));
+    const std::unordered_map<std::string, std::vector<MathLib::bigint>>::const_iterator it = mUnknownReturnValues.find(funcname);
     return (it == mUnknownReturnValues.end()) ? std::vector<MathLib::bigint>() : it->second;
 }
 
 const Library::Function *Library::getFunction(const Token *ftok) const
 {
-    if (isNotLibraryFunction(ftok))
-        return nullptr;
-    const std::map<std::string, Function>::const_iterator it1 = functions.find(getFunctionName(ftok));
-    if (it1 == functions.cend())
-        return nullptr;
-    return &it1->second;
+    const Function *func;
+    getLibraryFunctionName(ftok, &func);
+    return func;
 }
 
 
 bool Library::hasminsize(const Token *ftok) const
 {
-    if (isNotLibraryFunction(ftok))
+    const Function *func;
+    getLibraryFunctionName(ftok, &func);
+    if (!func)
         return false;
-    const std::map<std::string, Function>::const_iterator it1 = functions.find(getFunctionName(ftok));
-    if (it1 == functions.cend())
-        return false;
-    for (std::map<int, ArgumentChecks>::const_iterator it2 = it1->second.argumentChecks.cbegin(); it2 != it1->second.argumentChecks.cend(); ++it2) {
+    for (std::map<int, ArgumentChecks>::const_iterator it2 = func->argumentChecks.cbegin(); it2 != func->argumentChecks.cend(); ++it2) {
         if (!it2->second.minsizes.empty())
             return true;
     }
@@ -1364,28 +1495,28 @@ Library::ArgumentChecks::Direction Library::getArgDirection(const Token* ftok, i
 
 bool Library::ignorefunction(const std::string& functionName) const
 {
-    const std::map<std::string, Function>::const_iterator it = functions.find(functionName);
+    const std::unordered_map<std::string, Function>::const_iterator it = functions.find(functionName);
     if (it != functions.cend())
         return it->second.ignore;
     return false;
 }
 bool Library::isUse(const std::string& functionName) const
 {
-    const std::map<std::string, Function>::const_iterator it = functions.find(functionName);
+    const std::unordered_map<std::string, Function>::const_iterator it = functions.find(functionName);
     if (it != functions.cend())
         return it->second.use;
     return false;
 }
 bool Library::isLeakIgnore(const std::string& functionName) const
 {
-    const  std::map<std::string, Function>::const_iterator it = functions.find(functionName);
+    const  std::unordered_map<std::string, Function>::const_iterator it = functions.find(functionName);
     if (it != functions.cend())
         return it->second.leakignore;
     return false;
 }
 bool Library::isFunctionConst(const std::string& functionName, bool pure) const
 {
-    const std::map<std::string, Function>::const_iterator it = functions.find(functionName);
+    const std::unordered_map<std::string, Function>::const_iterator it = functions.find(functionName);
     if (it != functions.cend())
         return pure ? it->second.ispure : it->second.isconst;
     return false;
@@ -1394,18 +1525,19 @@ bool Library::isFunctionConst(const Token *ftok) const
 {
     if (ftok->function() && ftok->function()->isAttributeConst())
         return true;
-    if (isNotLibraryFunction(ftok))
-        return false;
-    const std::map<std::string, Function>::const_iterator it = functions.find(getFunctionName(ftok));
-    return (it != functions.end() && it->second.isconst);
+    const Function *func;
+    getLibraryFunctionName(ftok, &func);
+    return func && func->isconst;
 }
 bool Library::isnoreturn(const Token *ftok) const
 {
     if (ftok->function() && ftok->function()->isAttributeNoreturn())
         return true;
-    if (isNotLibraryFunction(ftok))
+    const Function *func;
+    const std::string funcname = getLibraryFunctionName(ftok, &func);
+    if (funcname.empty())
         return false;
-    const std::map<std::string, bool>::const_iterator it = mNoReturn.find(getFunctionName(ftok));
+    const std::unordered_map<std::string, bool>::const_iterator it = mNoReturn.find(funcname);
     return (it != mNoReturn.end() && it->second);
 }
 
@@ -1413,9 +1545,11 @@ bool Library::isnotnoreturn(const Token *ftok) const
 {
     if (ftok->function() && ftok->function()->isAttributeNoreturn())
         return false;
-    if (isNotLibraryFunction(ftok))
+    const Function *func;
+    const std::string funcname = getLibraryFunctionName(ftok, &func);
+    if (funcname.empty())
         return false;
-    const std::map<std::string, bool>::const_iterator it = mNoReturn.find(getFunctionName(ftok));
+    const std::unordered_map<std::string, bool>::const_iterator it = mNoReturn.find(funcname);
     return (it != mNoReturn.end() && !it->second);
 }
 
@@ -30,6 +30,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -218,7 +219,7 @@ public:
             Yield yield;
         };
         std::string startPattern, startPattern2, endPattern, itEndPattern;
-        std::map<std::string, Function> functions;
+        std::unordered_map<std::string, Function> functions;
         int type_templateArgNo;
         int size_templateArgNo;
         bool arrayLike_indexOp;
@@ -230,14 +231,14 @@ public:
         bool unstableInsert;
 
         Action getAction(const std::string& function) const {
-            const std::map<std::string, Function>::const_iterator i = functions.find(function);
+            const std::unordered_map<std::string, Function>::const_iterator i = functions.find(function);
             if (i != functions.end())
                 return i->second.action;
             return Action::NO_ACTION;
         }
 
         Yield getYield(const std::string& function) const {
-            const std::map<std::string, Function>::const_iterator i = functions.find(function);
+            const std::unordered_map<std::string, Function>::const_iterator i = functions.find(function);
             if (i != functions.end())
                 return i->second.yield;
             return Yield::NO_YIELD;
@@ -315,7 +316,7 @@ public:
     };
 
     const Function *getFunction(const Token *ftok) const;
-    std::map<std::string, Function> functions;
+    std::unordered_map<std::string, Function> functions;
     bool isUse(const std::string& functionName) const;
     bool isLeakIgnore(const std::string& functionName) const;
     bool isFunctionConst(const std::string& functionName, bool pure) const;
@@ -421,6 +422,20 @@ public:
 
     std::vector<std::string> defines; // to provide some library defines
 
+    /** Is there a define for this macro name? */
+    bool isDefine(const std::string &name) const {
+        return mDefineIndexes.find(name) != mDefineIndexes.end();
+    }
+
+    /**
+     * Get the defines that code can expand when it uses the given macro
+     * names, directly or through the values of other defines. The other
+     * defines don't need to be given to the preprocessor.
+     * @param names macro names that are used in the code
+     * @return indexes in defines, in the order of defines
+     */
+    std::vector<std::size_t> getUsedDefines(const std::set<std::string> &names) const;
+
     std::set<std::string> smartPointers;
     bool isSmartPointer(const Token *tok) const;
 
@@ -430,7 +445,7 @@ public:
         enum { NO, BOOL, CHAR, SHORT, INT, LONG, LONGLONG } stdtype;
     };
     const struct PodType *podtype(const std::string &name) const {
-        const std::map<std::string, struct PodType>::const_iterator it = mPodTypes.find(name);
+        const std::unordered_map<std::string, struct PodType>::const_iterator it = mPodTypes.find(name);
         return (it != mPodTypes.end()) ? &(it->second) : nullptr;
     }
 
@@ -555,14 +570,14 @@ private:
     };
     int mAllocId;
     std::set<std::string> mFiles;
-    std::map<std::string, AllocFunc> mAlloc; // allocation functions
-    std::map<std::string, AllocFunc> mDealloc; // deallocation functions
-    std::map<std::string, AllocFunc> mRealloc; // reallocation functions
-    std::map<std::string, bool> mNoReturn; // is function noreturn?
-    std::map<std::string, std::string> mReturnValue;
-    std::map<std::string, std::string> mReturnValueType;
-    std::map<std::string, int> mReturnValueContainer;
-    std::map<std::string, std::vector<MathLib::bigint>> mUnknownReturnValues;
+    std::unordered_map<std::string, AllocFunc> mAlloc; // allocation functions
+    std::unordered_map<std::string, AllocFunc> mDealloc; // deallocation functions
+    std::unordered_map<std::string, AllocFunc> mRealloc; // reallocation functions
+    std::unordered_map<std::string, bool> mNoReturn; // is function noreturn?
+    std::unordered_map<std::string, std::string> mReturnValue;
+    std::unordered_map<std::string, std::string> mReturnValueType;
+    std::unordered_map<std::string, int> mReturnValueContainer;
+    std::unordered_map<std::string, std::vector<MathLib::bigint>> mUnknownReturnValues;
     std::map<std::string, bool> mReportErrors;
     std::map<std::string, bool> mProcessAfterCode;
     std::set<std::string> mMarkupExtensions; // file extensions of markup files
@@ -571,17 +586,40 @@ private:
     std::map<std::string, ExportedFunctions> mExporters; // keywords that export variables/functions to libraries (meta-code/macros)
     std::map<std::string, std::set<std::string> > mImporters; // keywords that import variables/functions
     std::map<std::string, int> mReflection; // invocation of reflection
-    std::map<std::string, struct PodType> mPodTypes; // pod types
+    std::unordered_map<std::string, struct PodType> mPodTypes; // pod types
     std::map<std::string, PlatformType> mPlatformTypes; // platform independent typedefs
     std::map<std::string, Platform> mPlatforms; // platform dependent typedefs
     std::map<std::pair<std::string,std::string>, TypeCheck> mTypeChecks;
+    std::unordered_map<std::string, std::vector<std::string>> mContainerStarts; // first token of the start pattern => sorted container ids, "" for patterns that don't start with a plain token
+    std::size_t mIndexedContainers; // number of containers in mContainerStarts
+    struct DefineUses {
+        std::vector<std::string> names; // names in the value
+        bool pastes;                    // value pastes tokens with ##
+    };
+    std::unordered_map<std::string, std::vector<std::size_t>> mDefineIndexes; // macro name => indexes in defines
+    std::vector<DefineUses> mDefineUses; // for each define
 
     const ArgumentChecks * getarg(const Token *ftok, int argnr) const;
 
     std::string getFunctionName(const Token *ftok, bool *error) const;
 
-    static const AllocFunc* getAllocDealloc(const std::map<std::string, AllocFunc> &data, const std::string &name) {
-        const std::map<std::string, AllocFunc>::const_iterator it = data.find(name);
+    /**
+     * Get the name of the library function that is called, the name
+     * is resolved and looked up only once.
+     * @param ftok function name token
+     * @param func the &lt;function&gt; configuration is returned here, nullptr if there is none
+     * @return function name or empty string if ftok is not a library function
+     */
+    std::string getLibraryFunctionName(const Token *ftok, const Function **func) const;
+
+    /** Index the containers by the first token of their start pattern */
+    void indexContainers();
+
+    /** Index the defines by macro name and the names their values use */
+    void indexDefines();
+
+    static const AllocFunc* getAllocDealloc(const std::unordered_map<std::string, AllocFunc> &data, const std::string &name) {
+        const std::unordered_map<std::string, AllocFunc>::const_iterator it = data.find(name);
         return (it == data.end()) ? nullptr : &it->second;
     }
 };
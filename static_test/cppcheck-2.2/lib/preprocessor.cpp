@@ -27,10 +27,13 @@
 #include "suppressions.h"
 
 #include <algorithm>
+#include <cctype>
 #include <cstdint>
 #include <cstring>
 #include <iterator> // back_inserter
+#include <set>
 #include <utility>
+#include <vector>
 
 static bool sameline(const simplecpp::Token *tok1, const simplecpp::Token *tok2)
 {
@@ -63,7 +66,7 @@ std::atomic<bool> Preprocessor::missingSystemIncludeFlag;
 
 char Preprocessor::macroChar = char(1);
 
-Preprocessor::Preprocessor(Settings& settings, ErrorLogger *errorLogger) : mSettings(settings), mErrorLogger(errorLogger)
+Preprocessor::Preprocessor(Settings& settings, ErrorLogger *errorLogger) : mSettings(settings), mErrorLogger(errorLogger), mHeaderCache(nullptr)
 {
 }
 
@@ -582,7 +585,55 @@ static void splitcfg(const std::string &cfg, std::list<std::string> &defines, co
     }
 }
 
-static simplecpp::DUI createDUI(const Settings &mSettings, const std::string &cfg, const std::string &filename)
+static void addNames(const std::string &str, std::set<std::string> &names)
+{
+    for (std::string::size_type pos = 0; pos < str.size();) {
+        if (std::isalpha((unsigned char)str[pos]) || str[pos] == '_') {
+            const std::string::size_type start = pos;
+            while (pos < str.size() && (std::isalnum((unsigned char)str[pos]) || str[pos] == '_'))
+                ++pos;
+            names.insert(str.substr(start, pos - start));
+        } else {
+            ++pos;
+        }
+    }
+}
+
+/**
+ * Get the library defines that the code can expand. windows.cfg has
+ * thousands of defines, parsing all of them for every configuration
+ * takes longer than preprocessing a small file.
+ */
+static std::vector<std::size_t> getUsedLibraryDefines(const Settings &mSettings, const std::string &cfg, const simplecpp::TokenList &tokens1, const std::map<std::string, simplecpp::TokenList *> &tokenLists)
+{
+    const Library &library = mSettings.library;
+    std::set<std::string> names;
+    addNames(mSettings.userDefines, names);
+    addNames(cfg, names);
+
+    std::vector<const simplecpp::TokenList *> lists(1, &tokens1);
+    for (const std::pair<const std::string, simplecpp::TokenList *> &tokenList : tokenLists) {
+        if (tokenList.second)
+            lists.push_back(tokenList.second);
+    }
+    for (const simplecpp::TokenList *tokenList : lists) {
+        for (const simplecpp::Token *tok = tokenList->cfront(); tok; tok = tok->next) {
+            if (tok->name) {
+                if (library.isDefine(tok->str()))
+                    names.insert(tok->str());
+            } else if (tok->op == '#' && tok->next && tok->next->op == '#') {
+                // pasted tokens can be any name
+                std::vector<std::size_t> all(library.defines.size());
+                for (std::size_t i = 0; i < all.size(); ++i)
+                    all[i] = i;
+                return all;
+            }
+        }
+    }
+    return library.getUsedDefines(names);
+}
+
+static simplecpp::DUI createDUI(const Settings &mSettings, const std::string &cfg, const std::string &filename, const std::vector<std::size_t> &libraryDefines)
 {
     simplecpp::DUI dui;
 
@@ -590,7 +641,8 @@ static simplecpp::DUI createDUI(const Settings &mSettings, const std::string &cf
     if (!cfg.empty())
         splitcfg(cfg, dui.defines, emptyString);
 
-    for (const std::string &def : mSettings.library.defines) {
+    for (std::size_t i : libraryDefines) {
+        const std::string &def = mSettings.library.defines[i];
         const std::string::size_type pos = def.find_first_of(" (");
         if (pos == std::string::npos) {
             dui.defines.push_back(def);
@@ -657,10 +709,11 @@ void Preprocessor::handleErrors(const simplecpp::OutputList& outputList, bool th
 
 bool Preprocessor::loadFiles(const simplecpp::TokenList &rawtokens, std::vector<std::string> &files)
 {
-    const simplecpp::DUI dui = createDUI(mSettings, emptyString, files[0]);
+    // simplecpp::load() doesn't use the defines
+    const simplecpp::DUI dui = createDUI(mSettings, emptyString, files[0], std::vector<std::size_t>());
 
     simplecpp::OutputList outputList;
-    mTokenLists = simplecpp::load(rawtokens, files, dui, &outputList);
+    mTokenLists = simplecpp::load(rawtokens, files, dui, &outputList, mHeaderCache);
     handleErrors(outputList, false);
     return !hasErrors(outputList);
 }
@@ -695,7 +748,7 @@ void Preprocessor::setPlatformInfo(simplecpp::TokenList *tokens) const
 
 simplecpp::TokenList Preprocessor::preprocess(const simplecpp::TokenList &tokens1, const std::string &cfg, std::vector<std::string> &files, bool throwError)
 {
-    const simplecpp::DUI dui = createDUI(mSettings, cfg, files[0]);
+    const simplecpp::DUI dui = createDUI(mSettings, cfg, files[0], getUsedLibraryDefines(mSettings, cfg, tokens1, mTokenLists));
 
     simplecpp::OutputList outputList;
     std::list<simplecpp::MacroUsage> macroUsage;
@@ -989,6 +1042,35 @@ unsigned int Preprocessor::calculateChecksum(const simplecpp::TokenList &tokens1
     return crc32(ostr.str());
 }
 
+static void fnv1a(unsigned long long &hash, const char *data, std::size_t size)
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 0x100000001b3ULL;
+    }
+}
+
+static void fnv1a(unsigned long long &hash, unsigned int value)
+{
+    char data[sizeof(value)];
+    std::memcpy(data, &value, sizeof(value));
+    fnv1a(hash, data, sizeof(data));
+}
+
+unsigned long long Preprocessor::calculateHash(const simplecpp::TokenList &tokens)
+{
+    unsigned long long hash = 0xcbf29ce484222325ULL;
+    for (const simplecpp::Token *tok = tokens.cfront(); tok; tok = tok->next) {
+        fnv1a(hash, tok->location.fileIndex);
+        fnv1a(hash, tok->location.line);
+        fnv1a(hash, tok->location.col);
+        // the terminating '\0' separates the strings
+        fnv1a(hash, tok->str().c_str(), tok->str().size() + 1U);
+        fnv1a(hash, tok->macro.c_str(), tok->macro.size() + 1U);
+    }
+    return hash;
+}
+
 void Preprocessor::simplifyPragmaAsm(simplecpp::TokenList *tokenList)
 {
     Preprocessor::simplifyPragmaAsmPrivate(tokenList);
@@ -88,6 +88,11 @@ public:
     static std::atomic<bool> missingIncludeFlag;
     static std::atomic<bool> missingSystemIncludeFlag;
 
+    /** Use a cache of tokenized headers when the included files are loaded, nullptr to tokenize them every time */
+    void setHeaderCache(simplecpp::HeaderCache *headerCache) {
+        mHeaderCache = headerCache;
+    }
+
     void inlineSuppressions(const simplecpp::TokenList &tokens);
 
     void setDirectives(const simplecpp::TokenList &tokens);
@@ -178,6 +183,16 @@ public:
      */
     unsigned int calculateChecksum(const simplecpp::TokenList &tokens1, const std::string &toolinfo) const;
 
+    /**
+     * Calculate a 64 bit hash of preprocessed tokens. The strings, the
+     * locations and the macros of the tokens are hashed, so tokens with
+     * the same hash are tokenized and simplified the same way.
+     *
+     * @param tokens     Preprocessed tokens
+     * @return FNV-1a hash
+     */
+    static unsigned long long calculateHash(const simplecpp::TokenList &tokens);
+
     void simplifyPragmaAsm(simplecpp::TokenList *tokenList);
 
 private:
@@ -215,6 +230,8 @@ private:
     Settings& mSettings;
     ErrorLogger *mErrorLogger;
 
+    simplecpp::HeaderCache *mHeaderCache;
+
     /** list of all directives met while preprocessing file */
     std::list<Directive> mDirectives;
 
@@ -5,16 +5,33 @@
 #include "symboldatabase.h"
 #include <algorithm>
 #include <cassert>
+#include <limits>
 #include <memory>
+#include <vector>
+
+const ProgramMemory::Map &ProgramMemory::values() const
+{
+    static const Map emptyValues;
+    return mValues ? *mValues : emptyValues;
+}
+
+ProgramMemory::Map &ProgramMemory::modifiableValues()
+{
+    if (!mValues)
+        mValues = std::make_shared<Map>();
+    else if (mValues.use_count() > 1)
+        mValues = std::make_shared<Map>(*mValues);
+    return *mValues;
+}
 
 void ProgramMemory::setValue(nonneg int varid, const ValueFlow::Value &value)
 {
-    values[varid] = value;
+    modifiableValues()[varid] = value;
 }
 const ValueFlow::Value* ProgramMemory::getValue(nonneg int varid) const
 {
-    const ProgramMemory::Map::const_iterator it = values.find(varid);
-    const bool found = it != values.end() && !it->second.isImpossible();
+    const ProgramMemory::Map::const_iterator it = values().find(varid);
+    const bool found = it != values().end() && !it->second.isImpossible();
     if (found)
         return &it->second;
     else
@@ -33,7 +50,7 @@ bool ProgramMemory::getIntValue(nonneg int varid, MathLib::bigint* result) const
 
 void ProgramMemory::setIntValue(nonneg int varid, MathLib::bigint value)
 {
-    values[varid] = ValueFlow::Value(value);
+    modifiableValues()[varid] = ValueFlow::Value(value);
 }
 
 bool ProgramMemory::getTokValue(nonneg int varid, const Token** result) const
@@ -58,39 +75,59 @@ bool ProgramMemory::getContainerSizeValue(nonneg int varid, MathLib::bigint* res
 
 void ProgramMemory::setUnknown(nonneg int varid)
 {
-    values[varid].valueType = ValueFlow::Value::ValueType::UNINIT;
+    modifiableValues()[varid].valueType = ValueFlow::Value::ValueType::UNINIT;
 }
 
-bool ProgramMemory::hasValue(nonneg int varid)
+bool ProgramMemory::hasValue(nonneg int varid) const
 {
-    return values.find(varid) != values.end();
+    return values().find(varid) != values().end();
 }
 
 void ProgramMemory::swap(ProgramMemory &pm)
 {
-    values.swap(pm.values);
+    mValues.swap(pm.mValues);
 }
 
 void ProgramMemory::clear()
 {
-    values.clear();
+    mValues.reset();
 }
 
 bool ProgramMemory::empty() const
 {
-    return values.empty();
+    return values().empty();
 }
 
 void ProgramMemory::replace(const ProgramMemory &pm)
 {
-    for (auto&& p:pm.values)
-        values[p.first] = p.second;
+    if (pm.empty() || pm.mValues == mValues)
+        return;
+    Map &v = modifiableValues();
+    for (auto&& p:pm.values())
+        v[p.first] = p.second;
 }
 
 void ProgramMemory::insert(const ProgramMemory &pm)
 {
-    for (auto&& p:pm.values)
-        values.insert(p);
+    if (pm.empty() || pm.mValues == mValues)
+        return;
+    Map &v = modifiableValues();
+    for (auto&& p:pm.values())
+        v.insert(p);
+}
+
+void ProgramMemory::eraseIf(const std::function<bool(nonneg int varid)> &pred)
+{
+    std::vector<nonneg int> varids;
+    for (auto&& p:values()) {
+        if (pred(p.first))
+            varids.push_back(p.first);
+    }
+    if (varids.empty())
+        return;
+    Map &v = modifiableValues();
+    for (nonneg int varid : varids)
+        v.erase(varid);
 }
 
 bool conditionIsFalse(const Token *condition, const ProgramMemory &programMemory)
@@ -194,7 +231,7 @@ static void fillProgramMemoryFromConditions(ProgramMemory& pm, const Token* tok,
     fillProgramMemoryFromConditions(pm, tok->scope(), tok, settings);
 }
 
-static void fillProgramMemoryFromAssignments(ProgramMemory& pm, const Token* tok, const ProgramMemory& state, ProgramMemory::Map vars)
+static void fillProgramMemoryFromAssignments(ProgramMemory& pm, const Token* tok, const ProgramMemory& state, const ProgramMemory::Map& vars)
 {
     int indentlevel = 0;
     for (const Token *tok2 = tok; tok2; tok2 = tok2->previous()) {
@@ -249,13 +286,9 @@ static void fillProgramMemoryFromAssignments(ProgramMemory& pm, const Token* tok
 
 static void removeModifiedVars(ProgramMemory& pm, const Token* tok, const Token* origin)
 {
-    for (auto i = pm.values.begin(), last = pm.values.end(); i != last;) {
-        if (isVariableChanged(origin, tok, i->first, false, nullptr, true)) {
-            i = pm.values.erase(i);
-        } else {
-            ++i;
-        }
-    }
+    pm.eraseIf([&](nonneg int varid) {
+        return isVariableChanged(origin, tok, varid, false, nullptr, true);
+    });
 }
 
 static ProgramMemory getInitialProgramState(const Token* tok,
@@ -275,7 +308,7 @@ static ProgramMemory getInitialProgramState(const Token* tok,
 void ProgramMemoryState::insert(const ProgramMemory &pm, const Token* origin)
 {
     if (origin)
-        for (auto&& p:pm.values)
+        for (auto&& p:pm.values())
             origins.insert(std::make_pair(p.first, origin));
     state.insert(pm);
 }
@@ -283,12 +316,13 @@ void ProgramMemoryState::insert(const ProgramMemory &pm, const Token* origin)
 void ProgramMemoryState::replace(const ProgramMemory &pm, const Token* origin)
 {
     if (origin)
-        for (auto&& p:pm.values)
+        for (auto&& p:pm.values())
             origins[p.first] = origin;
     state.replace(pm);
 }
 
-void ProgramMemoryState::addState(const Token* tok, const ProgramMemory::Map& vars)
+/** Get the program memory at tok from the given values and the conditions and assignments before tok */
+static ProgramMemory getStateAt(const Token* tok, const ProgramMemory::Map& vars)
 {
     ProgramMemory pm;
     fillProgramMemoryFromConditions(pm, tok, nullptr);
@@ -302,7 +336,12 @@ void ProgramMemoryState::addState(const Token* tok, const ProgramMemory::Map& va
     }
     local = pm;
     fillProgramMemoryFromAssignments(pm, tok, local, vars);
-    replace(pm, tok);
+    return pm;
+}
+
+void ProgramMemoryState::addState(const Token* tok, const ProgramMemory::Map& vars)
+{
+    replace(getStateAt(tok, vars), tok);
 }
 
 void ProgramMemoryState::assume(const Token* tok, bool b)
@@ -312,24 +351,33 @@ void ProgramMemoryState::assume(const Token* tok, bool b)
     insert(pm, tok);
 }
 
+bool ProgramMemoryState::isModified(nonneg int varid, const Token* tok) const
+{
+    const std::map<nonneg int, const Token*>::const_iterator it = origins.find(varid);
+    return it != origins.end() && isVariableChanged(it->second, tok, varid, false, nullptr, true);
+}
+
 void ProgramMemoryState::removeModifiedVars(const Token* tok)
 {
-    for (auto i = state.values.begin(), last = state.values.end(); i != last;) {
-        if (isVariableChanged(origins[i->first], tok, i->first, false, nullptr, true)) {
-            origins.erase(i->first);
-            i = state.values.erase(i);
-        } else {
-            ++i;
-        }
-    }
+    state.eraseIf([&](nonneg int varid) {
+        if (!isModified(varid, tok))
+            return false;
+        origins.erase(varid);
+        return true;
+    });
 }
 
 ProgramMemory ProgramMemoryState::get(const Token *tok, const ProgramMemory::Map& vars) const
 {
-    ProgramMemoryState local = *this;
-    local.addState(tok, vars);
-    local.removeModifiedVars(tok);
-    return local.state;
+    // Same as addState() and removeModifiedVars() on a copy of this state. The
+    // values from addState() get tok as origin, so they are never removed.
+    const ProgramMemory pm = getStateAt(tok, vars);
+    ProgramMemory result = state;
+    result.eraseIf([&](nonneg int varid) {
+        return !pm.hasValue(varid) && isModified(varid, tok);
+    });
+    result.replace(pm);
+    return result;
 }
 
 ProgramMemory getProgramMemory(const Token *tok, const ProgramMemory::Map& vars)
@@ -5,14 +5,22 @@
 #include "utils.h"
 #include "valueflow.h" // needed for alias
 #include "mathlib.h"
+#include <functional>
 #include <map>
+#include <memory>
 #include <unordered_map>
 
 class Token;
 
+/**
+ * The values of the variables at some point in the program. Copies share
+ * the values until one of them is changed, so the program memory can be
+ * copied cheaply each time a condition is evaluated.
+ */
 struct ProgramMemory {
     using Map = std::unordered_map<nonneg int, ValueFlow::Value>;
-    Map values;
+
+    const Map &values() const;
 
     void setValue(nonneg int varid, const ValueFlow::Value &value);
     const ValueFlow::Value* getValue(nonneg int varid) const;
@@ -25,7 +33,7 @@ struct ProgramMemory {
     void setUnknown(nonneg int varid);
 
     bool getTokValue(nonneg int varid, const Token** result) const;
-    bool hasValue(nonneg int varid);
+    bool hasValue(nonneg int varid) const;
 
     void swap(ProgramMemory &pm);
 
@@ -36,6 +44,15 @@ struct ProgramMemory {
     void replace(const ProgramMemory &pm);
 
     void insert(const ProgramMemory &pm);
+
+    /** Remove the values of the variables for which the predicate returns true */
+    void eraseIf(const std::function<bool(nonneg int varid)> &pred);
+
+private:
+    /** Get the values for modification, they are copied first if they are shared with another program memory */
+    Map &modifiableValues();
+
+    std::shared_ptr<Map> mValues;
 };
 
 struct ProgramMemoryState {
@@ -51,6 +68,9 @@ struct ProgramMemoryState {
 
     void removeModifiedVars(const Token* tok);
 
+    /** Is the variable changed between its origin and tok? */
+    bool isModified(nonneg int varid, const Token* tok) const;
+
     ProgramMemory get(const Token *tok, const ProgramMemory::Map& vars) const;
 
 };
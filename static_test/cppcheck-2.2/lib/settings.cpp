@@ -31,6 +31,7 @@ const char Settings::SafeChecks::XmlExternalVariables[] = "external-variables";
 Settings::Settings()
     : mEnabled(0),
       bugHunting(false),
+      buildDirFormat(BuildDirFormat::XML),
       checkAllConfigurations(true),
       checkConfiguration(false),
       checkHeaders(true),
@@ -39,6 +40,7 @@ Settings::Settings()
       clang(false),
       clangExecutable("clang"),
       clangTidy(false),
+      configJobs(0),
       daca(false),
       debugBugHunting(false),
       debugnormal(false),
@@ -48,6 +50,7 @@ Settings::Settings()
       dump(false),
       enforcedLang(None),
       exceptionHandling(false),
+      executor(ExecutorType::Process),
       exitCode(0),
       experimental(false),
       force(false),
@@ -59,6 +62,9 @@ Settings::Settings()
       maxConfigs(12),
       maxCtuDepth(2),
       maxTemplateRecursion(100),
+      maxValueFlowForks(0),
+      maxValueFlowTime(0),
+      maxValueFlowTokens(0),
       preprocessOnly(false),
       quiet(false),
       relativePaths(false),
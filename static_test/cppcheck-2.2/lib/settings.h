@@ -89,6 +89,14 @@ public:
     /** @brief --cppcheck-build-dir */
     std::string buildDir;
 
+    enum class BuildDirFormat {
+        XML, Binary
+    };
+
+    /** @brief Format of the analyzer info files in the build dir
+        (--cppcheck-build-dir-format=xml|binary) */
+    BuildDirFormat buildDirFormat;
+
     /** @brief check all configurations (false if -D or --max-configs is used */
     bool checkAllConfigurations;
 
@@ -124,6 +132,12 @@ public:
     /** @brief include paths excluded from checking the configuration */
     std::set<std::string> configExcludePaths;
 
+    /** @brief How many threads check the configurations of one file
+        at the same time (--config-jobs). Default is 0, the command line
+        client then uses the -j threads that are not needed for the
+        files and CppCheck checks one configuration at a time. */
+    unsigned int configJobs;
+
     /** @brief Are we running from DACA script? */
     bool daca;
 
@@ -156,6 +170,14 @@ public:
     /** @brief Is --exception-handling given */
     bool exceptionHandling;
 
+    enum class ExecutorType {
+        Process, Thread
+    };
+
+    /** @brief How -j jobs are run (--executor=process|thread). Only
+        used on platforms that support fork() */
+    ExecutorType executor;
+
     // argv[0]
     std::string exename;
 
@@ -223,6 +245,23 @@ public:
     /** @brief max template recursion */
     int maxTemplateRecursion;
 
+    /** @brief Maximum number of scopes forked by the forward analysis of
+        the values in one function. When it is exceeded, the rest of the
+        function is analyzed with less precision. 0 means no limit.
+        (--max-valueflow-forks=N) */
+    int maxValueFlowForks;
+
+    /** @brief Maximum time in seconds for the ValueFlow analysis of one
+        file. When it is exceeded, the rest of the file is analyzed with
+        less precision. 0 means no limit. (--max-valueflow-time=N) */
+    int maxValueFlowTime;
+
+    /** @brief Maximum number of tokens visited by the forward analysis of
+        the values in one function. When it is exceeded, the rest of the
+        function is analyzed with less precision. 0 means no limit.
+        (--max-valueflow-tokens=N) */
+    int maxValueFlowTokens;
+
     /** @brief suppress exitcode */
     Suppressions nofail;
 
@@ -318,6 +357,11 @@ public:
     /** @brief show timing information (--showtime=file|summary|top5) */
     SHOWTIME_MODES showtime;
 
+    /** @brief Write the timing results of each file and the totals to this
+        file, as CSV if it ends with ".csv" and as JSON otherwise
+        (--showtime-output=&lt;file&gt;). Requires --showtime. */
+    std::string showtimeOutput;
+
     /** Struct contains standards settings */
     Standards standards;
 
@@ -329,6 +373,10 @@ public:
      *  text mode, e.g. "{file}:{line} {info}" */
     std::string templateLocation;
 
+    /** @brief Write the timed phases of the analysis as a Chrome trace
+        event JSON file (--trace-output=&lt;file&gt;) */
+    std::string traceOutput;
+
     /** @brief defines given by the user */
     std::string userDefines;
 
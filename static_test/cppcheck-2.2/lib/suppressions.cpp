@@ -42,6 +42,19 @@ static bool isAcceptedErrorIdChar(char c)
     }
 }
 
+/** Does the suppression match only errors with this id? */
+static bool isExactErrorId(const std::string &errorId)
+{
+    return !errorId.empty() && errorId.find_first_of("?*") == std::string::npos;
+}
+
+/** matchglob() treats '/' and '\\' as the same character */
+static std::string fileNameKey(std::string fileName)
+{
+    std::replace(fileName.begin(), fileName.end(), '\\', '/');
+    return fileName;
+}
+
 std::string Suppressions::parseFile(std::istream &istr)
 {
     // Change '\r' to '\n' in the istr
@@ -237,8 +250,15 @@ std::string Suppressions::addSuppression(const Suppressions::Suppression &suppre
     if (!isValidGlobPattern(suppression.fileName))
         return "Failed to add suppression. Invalid glob pattern '" + suppression.fileName + "'.";
 
+    const std::size_t index = mSuppressions.size();
     mSuppressions.push_back(suppression);
 
+    IdSuppressions &idSuppressions = isExactErrorId(suppression.errorId) ? mIdSuppressions[suppression.errorId] : mGlobIdSuppressions;
+    if (suppression.isLocal())
+        idSuppressions.files[fileNameKey(suppression.fileName)].push_back(index);
+    else
+        idSuppressions.others.push_back(index);
+
     return "";
 }
 
@@ -340,30 +360,53 @@ std::string Suppressions::Suppression::getText() const
     return ret;
 }
 
-bool Suppressions::isSuppressed(const Suppressions::ErrorMessage &errmsg)
+bool Suppressions::isSuppressed(const Suppressions::ErrorMessage &errmsg, bool localOnly)
 {
-    const bool unmatchedSuppression(errmsg.errorId == "unmatchedSuppression");
-    for (Suppression &s : mSuppressions) {
-        if (unmatchedSuppression && s.errorId != errmsg.errorId)
-            continue;
-        if (s.isMatch(errmsg))
-            return true;
+    // Candidate suppressions, each list is in the order the suppressions were added
+    const std::vector<std::size_t> *candidates[4] = {nullptr, nullptr, nullptr, nullptr};
+    int numberOfCandidates = 0;
+    const std::string fileKey = fileNameKey(errmsg.getFileName());
+    const auto addCandidates = [&](const IdSuppressions &idSuppressions) {
+        const auto it = idSuppressions.files.find(fileKey);
+        if (it != idSuppressions.files.end())
+            candidates[numberOfCandidates++] = &it->second;
+        if (!localOnly && !idSuppressions.others.empty())
+            candidates[numberOfCandidates++] = &idSuppressions.others;
+    };
+
+    const auto it = mIdSuppressions.find(errmsg.errorId);
+    if (it != mIdSuppressions.end())
+        addCandidates(it->second);
+    // unmatchedSuppression can only be suppressed by its exact id
+    if (errmsg.errorId != "unmatchedSuppression")
+        addCandidates(mGlobIdSuppressions);
+
+    // Only the first matching suppression is marked as matched
+    std::size_t first = mSuppressions.size();
+    for (int i = 0; i < numberOfCandidates; ++i) {
+        for (const std::size_t index : *candidates[i]) {
+            if (index >= first)
+                break;
+            if (mSuppressions[index].isSuppressed(errmsg)) {
+                first = index;
+                break;
+            }
+        }
     }
-    return false;
+    if (first == mSuppressions.size())
+        return false;
+    mSuppressions[first].matched = true;
+    return true;
+}
+
+bool Suppressions::isSuppressed(const Suppressions::ErrorMessage &errmsg)
+{
+    return isSuppressed(errmsg, false);
 }
 
 bool Suppressions::isSuppressedLocal(const Suppressions::ErrorMessage &errmsg)
 {
-    const bool unmatchedSuppression(errmsg.errorId == "unmatchedSuppression");
-    for (Suppression &s : mSuppressions) {
-        if (!s.isLocal())
-            continue;
-        if (unmatchedSuppression && s.errorId != errmsg.errorId)
-            continue;
-        if (s.isMatch(errmsg))
-            return true;
-    }
-    return false;
+    return isSuppressed(errmsg, true);
 }
 
 void Suppressions::dump(std::ostream & out) const
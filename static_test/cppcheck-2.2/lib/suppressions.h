@@ -25,6 +25,7 @@
 #include <istream>
 #include <list>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 /// @addtogroup Core
@@ -180,8 +181,30 @@ public:
     std::list<Suppression> getUnmatchedGlobalSuppressions(const bool unusedFunctionChecking) const;
 
 private:
+    /** @brief Indexes of the suppressions of one error id, in the order they were added */
+    struct IdSuppressions {
+        /** suppressions for an exact file name, the key uses '/' as path separator */
+        std::unordered_map<std::string, std::vector<std::size_t>> files;
+        /** suppressions without file name or with a glob pattern as file name */
+        std::vector<std::size_t> others;
+    };
+
+    /**
+     * @brief Find the first suppression that matches the error and mark it as matched.
+     * @param errmsg error message
+     * @param localOnly only use suppressions for an exact file name
+     * @return true if this error is suppressed.
+     */
+    bool isSuppressed(const ErrorMessage &errmsg, bool localOnly);
+
     /** @brief List of error which the user doesn't want to see. */
-    std::list<Suppression> mSuppressions;
+    std::vector<Suppression> mSuppressions;
+
+    /** @brief Suppressions with an exact error id */
+    std::unordered_map<std::string, IdSuppressions> mIdSuppressions;
+
+    /** @brief Suppressions without error id or with a glob pattern as error id */
+    IdSuppressions mGlobIdSuppressions;
 };
 
 /// @}
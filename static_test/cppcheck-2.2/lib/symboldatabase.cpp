@@ -37,6 +37,7 @@
 #include <iomanip>
 #include <iostream>
 #include <unordered_map>
+#include <unordered_set>
 //---------------------------------------------------------------------------
 
 SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger)
@@ -287,13 +288,13 @@ void SymbolDatabase::createSymbolDatabaseFindAllScopes()
 
                 if (new_scope->type == Scope::eEnum) {
                     tok2 = new_scope->addEnum(tok, mTokenizer->isCPP());
-                    scope->nestedList.push_back(new_scope);
+                    scope->addNestedScope(new_scope);
 
                     if (!tok2)
                         mTokenizer->syntaxError(tok);
                 } else {
                     // make the new scope the current scope
-                    scope->nestedList.push_back(new_scope);
+                    scope->addNestedScope(new_scope);
                     scope = new_scope;
                 }
 
@@ -323,7 +324,7 @@ void SymbolDatabase::createSymbolDatabaseFindAllScopes()
             }
 
             // make the new scope the current scope
-            scope->nestedList.push_back(new_scope);
+            scope->addNestedScope(new_scope);
             scope = &scopeList.back();
 
             tok = tok2;
@@ -412,7 +413,7 @@ void SymbolDatabase::createSymbolDatabaseFindAllScopes()
             }
 
             // make the new scope the current scope
-            scope->nestedList.push_back(new_scope);
+            scope->addNestedScope(new_scope);
             scope = new_scope;
 
             tok = tok2;
@@ -446,7 +447,7 @@ void SymbolDatabase::createSymbolDatabaseFindAllScopes()
             }
 
             // make the new scope the current scope
-            scope->nestedList.push_back(new_scope);
+            scope->addNestedScope(new_scope);
             scope = new_scope;
 
             tok = tok2;
@@ -658,7 +659,7 @@ void SymbolDatabase::createSymbolDatabaseFindAllScopes()
                     scopeList.emplace_back(this, tok, scope, Scope::eTry, tok1);
 
                 tok = tok1;
-                scope->nestedList.push_back(&scopeList.back());
+                scope->addNestedScope(&scopeList.back());
                 scope = &scopeList.back();
             } else if (tok->isKeyword() && Token::Match(tok, "if|for|while|catch|switch (") && Token::simpleMatch(tok->next()->link(), ") {")) {
                 const Token *scopeStartTok = tok->next()->link()->next();
@@ -673,7 +674,7 @@ void SymbolDatabase::createSymbolDatabaseFindAllScopes()
                 } else // if (tok->str() == "switch")
                     scopeList.emplace_back(this, tok, scope, Scope::eSwitch, scopeStartTok);
 
-                scope->nestedList.push_back(&scopeList.back());
+                scope->addNestedScope(&scopeList.back());
                 scope = &scopeList.back();
                 if (scope->type == Scope::eFor)
                     scope->checkVariable(tok->tokAt(2), AccessControl::Local, mSettings); // check for variable declaration and add it to new scope if found
@@ -693,7 +694,7 @@ void SymbolDatabase::createSymbolDatabaseFindAllScopes()
             } else if (tok->str() == "{") {
                 if (isExecutableScope(tok)) {
                     scopeList.emplace_back(this, tok, scope, Scope::eUnconditional, tok);
-                    scope->nestedList.push_back(&scopeList.back());
+                    scope->addNestedScope(&scopeList.back());
                     scope = &scopeList.back();
                 } else {
                     tok = tok->link();
@@ -760,7 +761,7 @@ void SymbolDatabase::createSymbolDatabaseVariableInfo()
 
     // fill in function arguments
     for (Scope& scope : scopeList) {
-        std::list<Function>::iterator func;
+        ChunkedList<Function>::iterator func;
 
         for (func = scope.functionList.begin(); func != scope.functionList.end(); ++func) {
             // add arguments
@@ -776,7 +777,7 @@ void SymbolDatabase::createSymbolDatabaseCopyAndMoveConstructors()
         if (!scope.isClassOrStruct())
             continue;
 
-        std::list<Function>::iterator func;
+        ChunkedList<Function>::iterator func;
         for (func = scope.functionList.begin(); func != scope.functionList.end(); ++func) {
             if (!func->isConstructor() || func->minArgCount() != 1)
                 continue;
@@ -818,7 +819,7 @@ void SymbolDatabase::createSymbolDatabaseFunctionReturnTypes()
 {
     // fill in function return types
     for (Scope& scope : scopeList) {
-        std::list<Function>::iterator func;
+        ChunkedList<Function>::iterator func;
 
         for (func = scope.functionList.begin(); func != scope.functionList.end(); ++func) {
             // add return types
@@ -862,7 +863,7 @@ void SymbolDatabase::createSymbolDatabaseNeedInitialization()
                     // check for default constructor
                     bool hasDefaultConstructor = false;
 
-                    std::list<Function>::const_iterator func;
+                    ChunkedList<Function>::const_iterator func;
 
                     for (func = scope.functionList.begin(); func != scope.functionList.end(); ++func) {
                         if (func->type == Function::eConstructor) {
@@ -891,7 +892,7 @@ void SymbolDatabase::createSymbolDatabaseNeedInitialization()
                         bool needInitialization = false;
                         bool unknown = false;
 
-                        std::list<Variable>::const_iterator var;
+                        ChunkedList<Variable>::const_iterator var;
                         for (var = scope.varlist.begin(); var != scope.varlist.end() && !needInitialization; ++var) {
                             if (var->isClass()) {
                                 if (var->type()) {
@@ -942,7 +943,7 @@ void SymbolDatabase::createSymbolDatabaseVariableSymbolTable()
     // check all scopes for variables
     for (Scope& scope : scopeList) {
         // add all variables
-        for (std::list<Variable>::iterator var = scope.varlist.begin(); var != scope.varlist.end(); ++var) {
+        for (ChunkedList<Variable>::iterator var = scope.varlist.begin(); var != scope.varlist.end(); ++var) {
             const unsigned int varId = var->declarationId();
             if (varId)
                 mVariableList[varId] = &(*var);
@@ -956,7 +957,7 @@ void SymbolDatabase::createSymbolDatabaseVariableSymbolTable()
 
         // add all function parameters
         for (Function& func : scope.functionList) {
-            for (std::list<Variable>::iterator arg = func.argumentList.begin(); arg != func.argumentList.end(); ++arg) {
+            for (ChunkedList<Variable>::iterator arg = func.argumentList.begin(); arg != func.argumentList.end(); ++arg) {
                 // check for named parameters
                 if (arg->nameToken() && arg->declarationId()) {
                     const unsigned int declarationId = arg->declarationId();
@@ -1001,8 +1002,15 @@ void SymbolDatabase::createSymbolDatabaseVariableSymbolTable()
 
 void SymbolDatabase::createSymbolDatabaseSetScopePointers()
 {
+    // The scope of the '{' of each nested scope
+    std::unordered_map<const Token *, const Scope *> nestedScopeStarts;
+    for (const Scope &scope : scopeList) {
+        for (const Scope *nestedScope : scope.nestedList)
+            nestedScopeStarts.emplace(nestedScope->bodyStart, &scope);
+    }
+
     // Set scope pointers
-    for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+    for (ChunkedList<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
         Token* start = const_cast<Token*>(it->bodyStart);
         Token* end = const_cast<Token*>(it->bodyEnd);
         if (it->type == Scope::eGlobal) {
@@ -1016,20 +1024,13 @@ void SymbolDatabase::createSymbolDatabaseSetScopePointers()
 
         for (Token* tok = start; tok != end; tok = tok->next()) {
             if (start != end && tok->str() == "{") {
-                bool isEndOfScope = false;
-                for (std::list<Scope*>::const_iterator innerScope = it->nestedList.begin(); innerScope != it->nestedList.end(); ++innerScope) {
-                    if (tok == (*innerScope)->bodyStart) { // Is begin of inner scope
-                        tok = tok->link();
-                        if (tok->next() == end || !tok->next()) {
-                            isEndOfScope = true;
-                            break;
-                        }
-                        tok = tok->next();
+                const std::unordered_map<const Token *, const Scope *>::const_iterator innerScope = nestedScopeStarts.find(tok);
+                if (innerScope != nestedScopeStarts.end() && innerScope->second == &*it) { // Is begin of inner scope
+                    tok = tok->link();
+                    if (tok->next() == end || !tok->next())
                         break;
-                    }
+                    tok = tok->next();
                 }
-                if (isEndOfScope)
-                    break;
             }
             tok->scope(&*it);
         }
@@ -1040,8 +1041,8 @@ void SymbolDatabase::createSymbolDatabaseSetFunctionPointers(bool firstPass)
 {
     if (firstPass) {
         // Set function definition and declaration pointers
-        for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
-            for (std::list<Function>::const_iterator func = it->functionList.begin(); func != it->functionList.end(); ++func) {
+        for (ChunkedList<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+            for (ChunkedList<Function>::const_iterator func = it->functionList.begin(); func != it->functionList.end(); ++func) {
                 if (func->tokenDef)
                     const_cast<Token *>(func->tokenDef)->function(&*func);
 
@@ -1077,8 +1078,8 @@ void SymbolDatabase::createSymbolDatabaseSetFunctionPointers(bool firstPass)
     }
 
     // Set C++ 11 delegate constructor function call pointers
-    for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
-        for (std::list<Function>::const_iterator func = it->functionList.begin(); func != it->functionList.end(); ++func) {
+    for (ChunkedList<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+        for (ChunkedList<Function>::const_iterator func = it->functionList.begin(); func != it->functionList.end(); ++func) {
             // look for initializer list
             if (func->isConstructor() && func->functionScope && func->functionScope->functionOf && func->arg) {
                 const Token * tok = func->arg->link()->next();
@@ -1262,18 +1263,26 @@ void SymbolDatabase::createSymbolDatabaseSetVariablePointers()
 
 void SymbolDatabase::createSymbolDatabaseEnums()
 {
+    // Only these names can be enumerators
+    std::unordered_set<std::string> enumeratorNames;
+
     // fill in enumerators in enum
-    for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+    for (ChunkedList<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
         if (it->type != Scope::eEnum)
             continue;
 
         // add enumerators to enumerator tokens
-        for (Enumerator & i : it->enumeratorList)
+        for (Enumerator & i : it->enumeratorList) {
             const_cast<Token *>(i.name)->enumerator(&i);
+            enumeratorNames.insert(i.name->str());
+        }
     }
 
+    if (enumeratorNames.empty())
+        return;
+
     // fill in enumerator values
-    for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+    for (ChunkedList<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
         if (it->type != Scope::eEnum)
             continue;
 
@@ -1285,7 +1294,7 @@ void SymbolDatabase::createSymbolDatabaseEnums()
                 if (!enumerator.end)
                     mTokenizer->syntaxError(enumerator.start);
                 for (const Token * tok3 = enumerator.start; tok3 && tok3 != enumerator.end->next(); tok3 = tok3->next()) {
-                    if (tok3->tokType() == Token::eName) {
+                    if (tok3->tokType() == Token::eName && enumeratorNames.count(tok3->str())) {
                         const Enumerator * e = findEnumerator(tok3);
                         if (e)
                             const_cast<Token *>(tok3)->enumerator(e);
@@ -1317,7 +1326,7 @@ void SymbolDatabase::createSymbolDatabaseEnums()
 
     // find enumerators
     for (const Token* tok = mTokenizer->list.front(); tok != mTokenizer->list.back(); tok = tok->next()) {
-        if (tok->tokType() != Token::eName)
+        if (tok->tokType() != Token::eName || !enumeratorNames.count(tok->str()))
             continue;
         const Enumerator * enumerator = findEnumerator(tok);
         if (enumerator)
@@ -2645,7 +2654,7 @@ void SymbolDatabase::addClassFunction(Scope **scope, const Token **tok, const To
     if (!tok1)
         return;
 
-    std::list<Scope>::iterator it1;
+    ChunkedList<Scope>::iterator it1;
 
     // search for match
     for (it1 = scopeList.begin(); it1 != scopeList.end(); ++it1) {
@@ -2808,7 +2817,7 @@ void SymbolDatabase::addNewFunction(Scope **scope, const Token **tok)
             return;
         }
 
-        (*scope)->nestedList.push_back(newScope);
+        (*scope)->addNestedScope(newScope);
         *scope = newScope;
         *tok = tok1;
     } else {
@@ -3226,14 +3235,14 @@ void SymbolDatabase::printOut(const char *title) const
     if (title)
         std::cout << "\n### " << title << " ###\n";
 
-    for (std::list<Scope>::const_iterator scope = scopeList.begin(); scope != scopeList.end(); ++scope) {
+    for (ChunkedList<Scope>::const_iterator scope = scopeList.begin(); scope != scopeList.end(); ++scope) {
         std::cout << "Scope: " << &*scope << " " << scope->type << std::endl;
         std::cout << "    className: " << scope->className << std::endl;
         std::cout << "    classDef: " << tokenToString(scope->classDef, mTokenizer) << std::endl;
         std::cout << "    bodyStart: " << tokenToString(scope->bodyStart, mTokenizer) << std::endl;
         std::cout << "    bodyEnd: " << tokenToString(scope->bodyEnd, mTokenizer) << std::endl;
 
-        std::list<Function>::const_iterator func;
+        ChunkedList<Function>::const_iterator func;
 
         // find the function body if not implemented inline
         for (func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
@@ -3315,7 +3324,7 @@ void SymbolDatabase::printOut(const char *title) const
             std::cout << "        nestedIn: " << scopeToString(func->nestedIn, mTokenizer) << std::endl;
             std::cout << "        functionScope: " << scopeToString(func->functionScope, mTokenizer) << std::endl;
 
-            std::list<Variable>::const_iterator var;
+            ChunkedList<Variable>::const_iterator var;
 
             for (var = func->argumentList.begin(); var != func->argumentList.end(); ++var) {
                 std::cout << "        Variable: " << &*var << std::endl;
@@ -3323,7 +3332,7 @@ void SymbolDatabase::printOut(const char *title) const
             }
         }
 
-        std::list<Variable>::const_iterator var;
+        ChunkedList<Variable>::const_iterator var;
 
         for (var = scope->varlist.begin(); var != scope->varlist.end(); ++var) {
             std::cout << "    Variable: " << &*var << std::endl;
@@ -3401,7 +3410,7 @@ void SymbolDatabase::printOut(const char *title) const
         std::cout << std::endl;
     }
 
-    for (std::list<Type>::const_iterator type = typeList.begin(); type != typeList.end(); ++type) {
+    for (ChunkedList<Type>::const_iterator type = typeList.begin(); type != typeList.end(); ++type) {
         std::cout << "Type: " << &(*type) << std::endl;
         std::cout << "    name: " << type->name() << std::endl;
         std::cout << "    classDef: " << tokenToString(type->classDef, mTokenizer) << std::endl;
@@ -3476,7 +3485,7 @@ void SymbolDatabase::printXml(std::ostream &out) const
 
     // Scopes..
     out << "  <scopes>" << std::endl;
-    for (std::list<Scope>::const_iterator scope = scopeList.begin(); scope != scopeList.end(); ++scope) {
+    for (ChunkedList<Scope>::const_iterator scope = scopeList.begin(); scope != scopeList.end(); ++scope) {
         out << "    <scope";
         out << " id=\"" << &*scope << "\"";
         out << " type=\"" << scope->type << "\"";
@@ -3496,7 +3505,7 @@ void SymbolDatabase::printXml(std::ostream &out) const
             out << '>' << std::endl;
             if (!scope->functionList.empty()) {
                 out << "      <functionList>" << std::endl;
-                for (std::list<Function>::const_iterator function = scope->functionList.begin(); function != scope->functionList.end(); ++function) {
+                for (ChunkedList<Function>::const_iterator function = scope->functionList.begin(); function != scope->functionList.end(); ++function) {
                     out << "        <function id=\"" << &*function << "\" tokenDef=\"" << function->tokenDef << "\" name=\"" << ErrorLogger::toxml(function->name()) << '\"';
                     out << " type=\"" << (function->type == Function::eConstructor? "Constructor" :
                                           function->type == Function::eCopyConstructor ? "CopyConstructor" :
@@ -3530,7 +3539,7 @@ void SymbolDatabase::printXml(std::ostream &out) const
             }
             if (!scope->varlist.empty()) {
                 out << "      <varlist>" << std::endl;
-                for (std::list<Variable>::const_iterator var = scope->varlist.begin(); var != scope->varlist.end(); ++var)
+                for (ChunkedList<Variable>::const_iterator var = scope->varlist.begin(); var != scope->varlist.end(); ++var)
                     out << "        <var id=\""   << &*var << "\"/>" << std::endl;
                 out << "      </varlist>" << std::endl;
             }
@@ -3808,7 +3817,7 @@ const Function * Function::getOverriddenFunctionRecursive(const ::Type* baseType
 
 const Variable* Function::getArgumentVar(nonneg int num) const
 {
-    for (std::list<Variable>::const_iterator i = argumentList.begin(); i != argumentList.end(); ++i) {
+    for (ChunkedList<Variable>::const_iterator i = argumentList.begin(); i != argumentList.end(); ++i) {
         if (i->index() == num)
             return (&*i);
         else if (i->index() > num)
@@ -3887,7 +3896,7 @@ Scope::Scope(const SymbolDatabase *check_, const Token *classDef_, const Scope *
 bool Scope::hasDefaultConstructor() const
 {
     if (numConstructors) {
-        std::list<Function>::const_iterator func;
+        ChunkedList<Function>::const_iterator func;
 
         for (func = functionList.begin(); func != functionList.end(); ++func) {
             if (func->type == Function::eConstructor && func->argCount() == 0)
@@ -4115,7 +4124,7 @@ const Token *Scope::checkVariable(const Token *tok, AccessControl varaccess, con
 
 const Variable *Scope::getVariable(const std::string &varname) const
 {
-    std::list<Variable>::const_iterator iter;
+    ChunkedList<Variable>::const_iterator iter;
 
     for (iter = varlist.begin(); iter != varlist.end(); ++iter) {
         if (iter->name() == varname)
@@ -4644,19 +4653,18 @@ static std::string getTypeString(const Token *typeToken)
     return "";
 }
 
-const Function* Scope::findFunction(const Token *tok, bool requireConst) const
+const std::vector<const Function *> &Scope::findFunctionCandidates(const std::string & name, nonneg int args, bool isCall) const
 {
-    const bool isCall = Token::Match(tok->next(), "(|{");
-
-    const std::vector<const Token *> arguments = getArguments(tok);
+    std::vector<FunctionCandidates> &cached = mFunctionCandidates[name];
+    for (const FunctionCandidates &candidates : cached) {
+        if (candidates.args == args && candidates.isCall == isCall)
+            return candidates.functions;
+    }
 
     std::vector<const Function *> matches;
 
-    // find all the possible functions that could match
-    const std::size_t args = arguments.size();
-
     auto addMatchingFunctions = [&](const Scope *scope) {
-        for (std::multimap<std::string, const Function *>::const_iterator it = scope->functionMap.find(tok->str()); it != scope->functionMap.cend() && it->first == tok->str(); ++it) {
+        for (std::multimap<std::string, const Function *>::const_iterator it = scope->functionMap.find(name); it != scope->functionMap.cend() && it->first == name; ++it) {
             const Function *func = it->second;
             if (!isCall || args == func->argCount() ||
                 (func->isVariadic() && args >= (func->argCount() - 1)) ||
@@ -4675,7 +4683,26 @@ const Function* Scope::findFunction(const Token *tok, bool requireConst) const
     }
 
     // check in base classes
-    findFunctionInBase(tok->str(), args, matches);
+    findFunctionInBase(name, args, matches);
+
+    cached.push_back(FunctionCandidates{args, isCall, std::move(matches)});
+    return cached.back().functions;
+}
+
+const Function* Scope::findFunction(const Token *tok, bool requireConst) const
+{
+    const bool isCall = Token::Match(tok->next(), "(|{");
+
+    const std::vector<const Token *> arguments = getArguments(tok);
+
+    // find all the possible functions that could match
+    const std::size_t args = arguments.size();
+
+    const std::vector<const Function *> &candidates = findFunctionCandidates(tok->str(), args, isCall);
+    if (candidates.empty())
+        return nullptr;
+
+    std::vector<const Function *> matches(candidates);
 
     // Non-call => Do not match parameters
     if (!isCall) {
@@ -4959,7 +4986,7 @@ const Function* SymbolDatabase::findFunction(const Token *tok) const
 
 const Scope *SymbolDatabase::findScopeByName(const std::string& name) const
 {
-    for (std::list<Scope>::const_iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+    for (ChunkedList<Scope>::const_iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
         if (it->className == name)
             return &*it;
     }
@@ -4968,27 +4995,32 @@ const Scope *SymbolDatabase::findScopeByName(const std::string& name) const
 
 //---------------------------------------------------------------------------
 
-Scope *Scope::findInNestedList(const std::string & name)
+void Scope::addNestedScope(Scope *scope)
 {
-    std::list<Scope *>::iterator it;
+    nestedList.push_back(scope);
 
-    for (it = nestedList.begin(); it != nestedList.end(); ++it) {
-        if ((*it)->className == name)
-            return (*it);
-    }
-    return nullptr;
+    std::pair<Scope *, Scope *> &nested = mNestedScopeMap[scope->className];
+    if (!nested.first)
+        nested.first = scope;
+    if (!nested.second && scope->type != eFunction)
+        nested.second = scope;
 }
 
 //---------------------------------------------------------------------------
 
-const Scope *Scope::findRecordInNestedList(const std::string & name) const
+Scope *Scope::findInNestedList(const std::string & name)
 {
-    std::list<Scope *>::const_iterator it;
+    const std::unordered_map<std::string, std::pair<Scope *, Scope *>>::const_iterator it = mNestedScopeMap.find(name);
+    return it != mNestedScopeMap.end() ? it->second.first : nullptr;
+}
 
-    for (it = nestedList.begin(); it != nestedList.end(); ++it) {
-        if ((*it)->className == name && (*it)->type != eFunction)
-            return (*it);
-    }
+//---------------------------------------------------------------------------
+
+const Scope *Scope::findRecordInNestedList(const std::string & name) const
+{
+    const std::unordered_map<std::string, std::pair<Scope *, Scope *>>::const_iterator it = mNestedScopeMap.find(name);
+    if (it != mNestedScopeMap.end() && it->second.second)
+        return it->second.second;
 
     const Type * nested_type = findType(name);
 
@@ -5033,15 +5065,12 @@ const Type* Scope::findType(const std::string & name) const
 
 Scope *Scope::findInNestedListRecursive(const std::string & name)
 {
-    std::list<Scope *>::iterator it;
-
-    for (it = nestedList.begin(); it != nestedList.end(); ++it) {
-        if ((*it)->className == name)
-            return (*it);
-    }
+    Scope *nested = findInNestedList(name);
+    if (nested)
+        return nested;
 
-    for (it = nestedList.begin(); it != nestedList.end(); ++it) {
-        Scope *child = (*it)->findInNestedListRecursive(name);
+    for (Scope *scope : nestedList) {
+        Scope *child = scope->findInNestedListRecursive(name);
         if (child)
             return child;
     }
@@ -5052,7 +5081,7 @@ Scope *Scope::findInNestedListRecursive(const std::string & name)
 
 const Function *Scope::getDestructor() const
 {
-    std::list<Function>::const_iterator it;
+    ChunkedList<Function>::const_iterator it;
     for (it = functionList.begin(); it != functionList.end(); ++it) {
         if (it->type == Function::eDestructor)
             return &(*it);
@@ -5544,7 +5573,7 @@ void SymbolDatabase::setValueType(Token *tok, const ValueType &valuetype)
             const Scope *typeScope = vt1->typeScope;
             if (!typeScope)
                 return;
-            for (std::list<Variable>::const_iterator it = typeScope->varlist.begin(); it != typeScope->varlist.end(); ++it) {
+            for (ChunkedList<Variable>::const_iterator it = typeScope->varlist.begin(); it != typeScope->varlist.end(); ++it) {
                 if (it->nameToken()->str() == name) {
                     var = &*it;
                     break;
@@ -6149,7 +6178,7 @@ void SymbolDatabase::setValueTypeInTokenList(bool reportDebugWarnings, Token *to
                         tok->astOperand1()->astOperand1()->valueType() &&
                         tok->astOperand1()->astOperand1()->valueType()->container) {
                         const Library::Container *cont = tok->astOperand1()->astOperand1()->valueType()->container;
-                        const std::map<std::string, Library::Container::Function>::const_iterator it = cont->functions.find(tok->astOperand1()->astOperand2()->str());
+                        const std::unordered_map<std::string, Library::Container::Function>::const_iterator it = cont->functions.find(tok->astOperand1()->astOperand2()->str());
                         if (it != cont->functions.end()) {
                             if (it->second.yield == Library::Container::Yield::START_ITERATOR ||
                                 it->second.yield == Library::Container::Yield::END_ITERATOR ||
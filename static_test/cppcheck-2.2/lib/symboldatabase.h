@@ -21,6 +21,7 @@
 #define symboldatabaseH
 //---------------------------------------------------------------------------
 
+#include "chunkedlist.h"
 #include "config.h"
 #include "library.h"
 #include "mathlib.h"
@@ -32,6 +33,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -886,7 +888,7 @@ public:
     const ::Type *retType;            ///< function return type
     const Scope *functionScope;       ///< scope of function body
     const Scope* nestedIn;            ///< Scope the function is declared in
-    std::list<Variable> argumentList; ///< argument list
+    ChunkedList<Variable> argumentList; ///< argument list
     nonneg int initArgCount;        ///< number of args with default values
     Type type;                        ///< constructor, destructor, ...
     AccessControl access;             ///< public/protected/private
@@ -1000,9 +1002,9 @@ public:
     const Token *classDef;   ///< class/struct/union/namespace token
     const Token *bodyStart;  ///< '{' token
     const Token *bodyEnd;    ///< '}' token
-    std::list<Function> functionList;
+    ChunkedList<Function> functionList;
     std::multimap<std::string, const Function *> functionMap;
-    std::list<Variable> varlist;
+    ChunkedList<Variable> varlist;
     const Scope *nestedIn;
     std::list<Scope *> nestedList;
     nonneg int numConstructors;
@@ -1084,6 +1086,12 @@ public:
      */
     const Function *findFunction(const Token *tok, bool requireConst=false) const;
 
+    /**
+     * @brief add a scope to the nested list
+     * @param scope nested scope, its name and type must be set
+     */
+    void addNestedScope(Scope *scope);
+
     /**
      * @brief find if name is in nested list
      * @param name name of nested scope
@@ -1156,6 +1164,28 @@ private:
     bool isVariableDeclaration(const Token* const tok, const Token*& vartok, const Token*& typetok) const;
 
     void findFunctionInBase(const std::string & name, nonneg int args, std::vector<const Function *> & matches) const;
+
+    /**
+     * @brief get the functions that findFunction() scores for a call
+     * @param name function name
+     * @param args number of arguments
+     * @param isCall is it a function call, otherwise the number of arguments of the functions in this scope are not checked
+     * @return the functions of this scope, of the anonymous namespaces in it and of the base classes
+     */
+    const std::vector<const Function *> &findFunctionCandidates(const std::string & name, nonneg int args, bool isCall) const;
+
+    struct FunctionCandidates {
+        nonneg int args;
+        bool isCall;
+        std::vector<const Function *> functions;
+    };
+
+    /** Cache of findFunctionCandidates() by function name. The functions
+        of the scopes do not change once the symbol database is created. */
+    mutable std::unordered_map<std::string, std::vector<FunctionCandidates>> mFunctionCandidates;
+
+    /** The first nested scope and the first nested scope that is not a function for each name */
+    std::unordered_map<std::string, std::pair<Scope *, Scope *>> mNestedScopeMap;
 };
 
 enum class Reference {
@@ -1265,7 +1295,7 @@ public:
     ~SymbolDatabase();
 
     /** @brief Information about all namespaces/classes/structrues */
-    std::list<Scope> scopeList;
+    ChunkedList<Scope> scopeList;
 
     /** @brief Fast access to function scopes */
     std::vector<const Scope *> functionScopes;
@@ -1274,7 +1304,7 @@ public:
     std::vector<const Scope *> classAndStructScopes;
 
     /** @brief Fast access to types */
-    std::list<Type> typeList;
+    ChunkedList<Type> typeList;
 
     /**
      * @brief find a variable type if it's a user defined type
@@ -1404,7 +1434,7 @@ private:
     std::vector<const Variable *> mVariableList;
 
     /** list for missing types */
-    std::list<Type> mBlankTypes;
+    ChunkedList<Type> mBlankTypes;
 
     bool mIsCpp;
     ValueType::Sign mDefaultSignedness;
@@ -18,14 +18,25 @@
 
 #include "timer.h"
 
+#include "utils.h"
+
+#include <picojson.h>
+
 #include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <set>
 #include <utility>
 #include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
 /*
     TODO:
     - rename "file" to "single"
-    - synchronise map access in multithreaded mode or disable timing
     - add unit tests
         - for --showtime (needs input file)
         - for Timer* classes
@@ -39,15 +50,50 @@ namespace {
     }
 }
 
+static Timer::AllocationCounter allocationCounter = nullptr;
+
+static TimerTrace *timerTrace = nullptr;
+
+static thread_local unsigned int traceWorkerId = 0;
+
+/** Id of the current thread in the trace */
+static unsigned int traceThreadId()
+{
+    static std::atomic<unsigned int> nextId(1);
+    static thread_local unsigned int id = nextId++;
+    return id;
+}
+
+/** Peak memory usage of the process so far in bytes, 0 if it is not known */
+static std::uint64_t peakMemory()
+{
+#ifdef _WIN32
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#ifdef __APPLE__
+    return usage.ru_maxrss;
+#else
+    return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
 void TimerResults::showResults(SHOWTIME_MODES mode) const
 {
-    if (mode == SHOWTIME_MODES::SHOWTIME_NONE)
+    if (mode != SHOWTIME_MODES::SHOWTIME_SUMMARY && mode != SHOWTIME_MODES::SHOWTIME_TOP5)
         return;
 
     std::cout << std::endl;
     TimerResultsData overallData;
 
-    std::vector<dataElementType> data(mResults.begin(), mResults.end());
+    std::vector<dataElementType> data;
+    {
+        std::lock_guard<std::mutex> l(mResultsSync);
+        data.assign(mResults.begin(), mResults.end());
+    }
     std::sort(data.begin(), data.end(), more_second_sec);
 
     size_t ordinal = 1; // maybe it would be nice to have an ordinal in output later!
@@ -65,21 +111,324 @@ void TimerResults::showResults(SHOWTIME_MODES mode) const
     std::cout << "Overall time: " << secOverall << "s" << std::endl;
 }
 
-void TimerResults::addResults(const std::string& str, std::clock_t clocks)
+void TimerResults::addResults(const std::string& str, const TimerResultsData &data)
+{
+    std::lock_guard<std::mutex> l(mResultsSync);
+    mResults[str].add(data);
+}
+
+void TimerResults::addFileResults(const std::string &file, const TimerResults &fileResults, bool keepPerFile)
+{
+    ResultMap results;
+    {
+        std::lock_guard<std::mutex> l(fileResults.mResultsSync);
+        results = fileResults.mResults;
+    }
+    std::lock_guard<std::mutex> l(mResultsSync);
+    for (const std::pair<const std::string, TimerResultsData> &result : results)
+        mResults[result.first].add(result.second);
+    if (keepPerFile)
+        mFileResults.emplace_back(file, std::move(results));
+}
+
+void TimerResults::merge(const TimerResults &other)
+{
+    ResultMap results;
+    std::vector<std::pair<std::string, ResultMap>> fileResults;
+    {
+        std::lock_guard<std::mutex> l(other.mResultsSync);
+        results = other.mResults;
+        fileResults = other.mFileResults;
+    }
+    std::lock_guard<std::mutex> l(mResultsSync);
+    for (const std::pair<const std::string, TimerResultsData> &result : results)
+        mResults[result.first].add(result.second);
+    for (std::pair<std::string, ResultMap> &file : fileResults)
+        mFileResults.push_back(std::move(file));
+}
+
+void TimerResults::clear()
+{
+    std::lock_guard<std::mutex> l(mResultsSync);
+    mResults.clear();
+    mFileResults.clear();
+}
+
+bool TimerResults::empty() const
+{
+    std::lock_guard<std::mutex> l(mResultsSync);
+    return mResults.empty() && mFileResults.empty();
+}
+
+static picojson::value toJson(const TimerResultsData &data)
+{
+    picojson::object obj;
+    obj["calls"] = picojson::value(static_cast<double>(data.mNumberOfResults));
+    obj["cpu"] = picojson::value(data.seconds());
+    obj["wall"] = picojson::value(data.wallSeconds());
+    obj["peakMemoryIncrease"] = picojson::value(static_cast<double>(data.mPeakMemoryIncrease));
+    obj["allocations"] = picojson::value(static_cast<double>(data.mAllocations));
+    obj["tokens"] = picojson::value(static_cast<double>(data.mTokens));
+    return picojson::value(obj);
+}
+
+static std::string csvField(const std::string &str)
+{
+    std::string ret("\"");
+    for (const char c : str) {
+        if (c == '"')
+            ret += '"';
+        ret += c;
+    }
+    return ret + '"';
+}
+
+static void writeCsv(std::ostream &out, const std::string &file, const std::string &phase, const TimerResultsData &data)
+{
+    out << csvField(file) << ',' << csvField(phase) << ','
+        << data.mNumberOfResults << ','
+        << data.seconds() << ','
+        << data.wallSeconds() << ','
+        << data.mPeakMemoryIncrease << ','
+        << data.mAllocations << ','
+        << data.mTokens << '\n';
+}
+
+bool TimerResults::writeResults(const std::string &filename) const
+{
+    std::ofstream fout(filename);
+    if (!fout.is_open())
+        return false;
+
+    std::lock_guard<std::mutex> l(mResultsSync);
+    if (endsWith(filename, ".csv", 4)) {
+        // The totals have an empty file name
+        fout << "file,phase,calls,cpu,wall,peakMemoryIncrease,allocations,tokens\n";
+        for (const std::pair<std::string, ResultMap> &file : mFileResults) {
+            for (const std::pair<const std::string, TimerResultsData> &result : file.second)
+                writeCsv(fout, file.first, result.first, result.second);
+        }
+        for (const std::pair<const std::string, TimerResultsData> &result : mResults)
+            writeCsv(fout, emptyString, result.first, result.second);
+    } else {
+        picojson::array files;
+        for (const std::pair<std::string, ResultMap> &file : mFileResults) {
+            picojson::object phases;
+            for (const std::pair<const std::string, TimerResultsData> &result : file.second)
+                phases[result.first] = toJson(result.second);
+            picojson::object obj;
+            obj["file"] = picojson::value(file.first);
+            obj["phases"] = picojson::value(phases);
+            files.push_back(picojson::value(obj));
+        }
+        picojson::object total;
+        for (const std::pair<const std::string, TimerResultsData> &result : mResults)
+            total[result.first] = toJson(result.second);
+        picojson::object obj;
+        obj["files"] = picojson::value(files);
+        obj["total"] = picojson::value(total);
+        fout << picojson::value(obj).serialize(true);
+    }
+    return fout.good();
+}
+
+static void serializeBinary(std::string &buffer, const std::map<std::string, TimerResultsData> &results)
+{
+    appendBinary(buffer, static_cast<std::uint32_t>(results.size()));
+    for (const std::pair<const std::string, TimerResultsData> &result : results) {
+        appendBinary(buffer, result.first);
+        appendBinary(buffer, static_cast<std::int64_t>(result.second.mClocks));
+        appendBinary(buffer, static_cast<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(result.second.mWallTime).count()));
+        appendBinary(buffer, result.second.mPeakMemoryIncrease);
+        appendBinary(buffer, result.second.mAllocations);
+        appendBinary(buffer, result.second.mTokens);
+        appendBinary(buffer, static_cast<std::int64_t>(result.second.mNumberOfResults));
+    }
+}
+
+static bool deserializeBinary(const char *&data, const char *end, std::map<std::string, TimerResultsData> &results)
+{
+    std::uint32_t size = 0;
+    if (!readBinary(data, end, size))
+        return false;
+    for (std::uint32_t i = 0; i < size; ++i) {
+        std::string name;
+        std::int64_t clocks = 0;
+        std::int64_t wallTime = 0;
+        std::int64_t numberOfResults = 0;
+        TimerResultsData result;
+        if (!readBinary(data, end, name) ||
+            !readBinary(data, end, clocks) ||
+            !readBinary(data, end, wallTime) ||
+            !readBinary(data, end, result.mPeakMemoryIncrease) ||
+            !readBinary(data, end, result.mAllocations) ||
+            !readBinary(data, end, result.mTokens) ||
+            !readBinary(data, end, numberOfResults))
+            return false;
+        result.mClocks = static_cast<std::clock_t>(clocks);
+        result.mWallTime = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(wallTime));
+        result.mNumberOfResults = static_cast<long>(numberOfResults);
+        results[name].add(result);
+    }
+    return true;
+}
+
+void TimerResults::serializeBinary(std::string &buffer) const
+{
+    std::lock_guard<std::mutex> l(mResultsSync);
+    ::serializeBinary(buffer, mResults);
+    appendBinary(buffer, static_cast<std::uint32_t>(mFileResults.size()));
+    for (const std::pair<std::string, ResultMap> &file : mFileResults) {
+        appendBinary(buffer, file.first);
+        ::serializeBinary(buffer, file.second);
+    }
+}
+
+bool TimerResults::deserializeBinary(const char *&data, const char *end)
+{
+    std::lock_guard<std::mutex> l(mResultsSync);
+    std::uint32_t files = 0;
+    if (!::deserializeBinary(data, end, mResults) || !readBinary(data, end, files))
+        return false;
+    for (std::uint32_t i = 0; i < files; ++i) {
+        std::string file;
+        ResultMap results;
+        if (!readBinary(data, end, file) || !::deserializeBinary(data, end, results))
+            return false;
+        mFileResults.emplace_back(file, std::move(results));
+    }
+    return true;
+}
+
+void TimerTrace::addEvent(const Event &event)
+{
+    std::lock_guard<std::mutex> l(mEventsSync);
+    mEvents.push_back(event);
+}
+
+void TimerTrace::merge(const TimerTrace &other)
+{
+    std::vector<Event> events;
+    {
+        std::lock_guard<std::mutex> l(other.mEventsSync);
+        events = other.mEvents;
+    }
+    std::lock_guard<std::mutex> l(mEventsSync);
+    mEvents.insert(mEvents.end(), events.begin(), events.end());
+}
+
+void TimerTrace::clear()
+{
+    std::lock_guard<std::mutex> l(mEventsSync);
+    mEvents.clear();
+}
+
+bool TimerTrace::empty() const
+{
+    std::lock_guard<std::mutex> l(mEventsSync);
+    return mEvents.empty();
+}
+
+bool TimerTrace::write(const std::string &filename) const
+{
+    std::ofstream fout(filename);
+    if (!fout.is_open())
+        return false;
+
+    std::lock_guard<std::mutex> l(mEventsSync);
+
+    // The timestamps are in microseconds since the first event. They are written
+    // as fixed point numbers, 6 significant digits would round after 1 second
+    std::int64_t first = 0;
+    std::set<unsigned int> workers;
+    for (const Event &event : mEvents) {
+        if (workers.empty() || event.start < first)
+            first = event.start;
+        workers.insert(event.worker);
+    }
+
+    // The events are written one per line, the trace of a large project has many of them
+    fout << std::fixed << std::setprecision(3);
+    fout << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    const char *separator = "\n";
+    for (const unsigned int worker : workers) {
+        const std::string name = worker == 0 ? std::string("cppcheck") : ("worker " + std::to_string(worker));
+        fout << separator << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << worker
+             << ",\"tid\":0,\"args\":{\"name\":" << picojson::value(name).serialize() << "}}";
+        separator = ",\n";
+    }
+    for (const Event &event : mEvents) {
+        fout << separator << "{\"name\":" << picojson::value(event.name).serialize()
+             << ",\"cat\":\"cppcheck\",\"ph\":\"X\""
+             << ",\"ts\":" << (event.start - first) / 1000.0
+             << ",\"dur\":" << event.duration / 1000.0
+             << ",\"pid\":" << event.worker
+             << ",\"tid\":" << event.thread;
+        if (!event.detail.empty())
+            fout << ",\"args\":{\"detail\":" << picojson::value(event.detail).serialize() << '}';
+        fout << '}';
+        separator = ",\n";
+    }
+    fout << "\n]}\n";
+    return fout.good();
+}
+
+void TimerTrace::serializeBinary(std::string &buffer) const
+{
+    std::lock_guard<std::mutex> l(mEventsSync);
+    appendBinary(buffer, static_cast<std::uint32_t>(mEvents.size()));
+    for (const Event &event : mEvents) {
+        appendBinary(buffer, event.name);
+        appendBinary(buffer, event.detail);
+        appendBinary(buffer, event.start);
+        appendBinary(buffer, event.duration);
+        appendBinary(buffer, static_cast<std::uint32_t>(event.worker));
+        appendBinary(buffer, static_cast<std::uint32_t>(event.thread));
+    }
+}
+
+bool TimerTrace::deserializeBinary(const char *&data, const char *end)
 {
-    mResults[str].mClocks += clocks;
-    mResults[str].mNumberOfResults++;
+    std::lock_guard<std::mutex> l(mEventsSync);
+    std::uint32_t size = 0;
+    if (!readBinary(data, end, size))
+        return false;
+    for (std::uint32_t i = 0; i < size; ++i) {
+        Event event;
+        std::uint32_t worker = 0;
+        std::uint32_t thread = 0;
+        if (!readBinary(data, end, event.name) ||
+            !readBinary(data, end, event.detail) ||
+            !readBinary(data, end, event.start) ||
+            !readBinary(data, end, event.duration) ||
+            !readBinary(data, end, worker) ||
+            !readBinary(data, end, thread))
+            return false;
+        event.worker = worker;
+        event.thread = thread;
+        mEvents.push_back(std::move(event));
+    }
+    return true;
 }
 
 Timer::Timer(const std::string& str, SHOWTIME_MODES showtimeMode, TimerResultsIntf* timerResults)
     : mStr(str)
     , mTimerResults(timerResults)
+    , mTrace(timerTrace)
     , mStart(0)
+    , mPeakMemoryStart(0)
+    , mAllocationsStart(0)
+    , mTokens(0)
     , mShowTimeMode(showtimeMode)
     , mStopped(false)
 {
-    if (showtimeMode != SHOWTIME_MODES::SHOWTIME_NONE)
+    if (showtimeMode != SHOWTIME_MODES::SHOWTIME_NONE) {
+        mPeakMemoryStart = peakMemory();
+        mAllocationsStart = allocationCounter ? allocationCounter() : 0;
         mStart = std::clock();
+    }
+    if (showtimeMode != SHOWTIME_MODES::SHOWTIME_NONE || mTrace)
+        mWallStart = std::chrono::steady_clock::now();
 }
 
 Timer::~Timer()
@@ -89,18 +438,59 @@ Timer::~Timer()
 
 void Timer::stop()
 {
+    if (mTrace && !mStopped) {
+        TimerTrace::Event event;
+        event.name = mStr;
+        event.detail = mDetail;
+        event.start = std::chrono::duration_cast<std::chrono::nanoseconds>(mWallStart.time_since_epoch()).count();
+        event.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - mWallStart).count();
+        event.worker = traceWorkerId;
+        event.thread = traceThreadId();
+        mTrace->addEvent(event);
+    }
+
     if ((mShowTimeMode != SHOWTIME_MODES::SHOWTIME_NONE) && !mStopped) {
         const std::clock_t end = std::clock();
-        const std::clock_t diff = end - mStart;
+        TimerResultsData data;
+        data.mClocks = end - mStart;
+        data.mWallTime = std::chrono::steady_clock::now() - mWallStart;
+        data.mPeakMemoryIncrease = peakMemory() - mPeakMemoryStart;
+        data.mAllocations = (allocationCounter ? allocationCounter() : 0) - mAllocationsStart;
+        data.mTokens = mTokens;
+        data.mNumberOfResults = 1;
 
         if (mShowTimeMode == SHOWTIME_MODES::SHOWTIME_FILE) {
-            const double sec = (double)diff / CLOCKS_PER_SEC;
+            const double sec = (double)data.mClocks / CLOCKS_PER_SEC;
             std::cout << mStr << ": " << sec << "s" << std::endl;
-        } else {
-            if (mTimerResults)
-                mTimerResults->addResults(mStr, diff);
         }
+        if (mTimerResults)
+            mTimerResults->addResults(mStr, data);
     }
 
     mStopped = true;
 }
+
+void Timer::setAllocationCounter(AllocationCounter counter)
+{
+    allocationCounter = counter;
+}
+
+void Timer::setTrace(TimerTrace *trace)
+{
+    timerTrace = trace;
+}
+
+TimerTrace *Timer::trace()
+{
+    return timerTrace;
+}
+
+void Timer::setTraceWorker(unsigned int worker)
+{
+    traceWorkerId = worker;
+}
+
+unsigned int Timer::traceWorker()
+{
+    return traceWorkerId;
+}
@@ -22,9 +22,15 @@
 
 #include "config.h"
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <ctime>
 #include <map>
+#include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
 enum class SHOWTIME_MODES {
     SHOWTIME_NONE = 0,
@@ -33,19 +39,26 @@ enum class SHOWTIME_MODES {
     SHOWTIME_TOP5
 };
 
-class CPPCHECKLIB TimerResultsIntf {
-public:
-    virtual ~TimerResultsIntf() { }
-
-    virtual void addResults(const std::string& str, std::clock_t clocks) = 0;
-};
-
+/** Measurements of a timed phase. They are summed when a phase is timed several times. */
 struct TimerResultsData {
+    /** CPU time */
     std::clock_t mClocks;
+    /** Wall time */
+    std::chrono::steady_clock::duration mWallTime;
+    /** Growth of the peak memory usage of the process, in bytes */
+    std::uint64_t mPeakMemoryIncrease;
+    /** Number of memory allocations, when the program counts them (see Timer::setAllocationCounter) */
+    std::uint64_t mAllocations;
+    /** Number of tokens processed */
+    std::uint64_t mTokens;
     long mNumberOfResults;
 
     TimerResultsData()
         : mClocks(0)
+        , mWallTime(0)
+        , mPeakMemoryIncrease(0)
+        , mAllocations(0)
+        , mTokens(0)
         , mNumberOfResults(0) {
     }
 
@@ -53,6 +66,26 @@ struct TimerResultsData {
         const double ret = (double)((unsigned long)mClocks) / (double)CLOCKS_PER_SEC;
         return ret;
     }
+
+    double wallSeconds() const {
+        return std::chrono::duration<double>(mWallTime).count();
+    }
+
+    void add(const TimerResultsData &other) {
+        mClocks += other.mClocks;
+        mWallTime += other.mWallTime;
+        mPeakMemoryIncrease += other.mPeakMemoryIncrease;
+        mAllocations += other.mAllocations;
+        mTokens += other.mTokens;
+        mNumberOfResults += other.mNumberOfResults;
+    }
+};
+
+class CPPCHECKLIB TimerResultsIntf {
+public:
+    virtual ~TimerResultsIntf() { }
+
+    virtual void addResults(const std::string& str, const TimerResultsData &data) = 0;
 };
 
 class CPPCHECKLIB TimerResults : public TimerResultsIntf {
@@ -61,10 +94,85 @@ public:
     }
 
     void showResults(SHOWTIME_MODES mode) const;
-    void addResults(const std::string& str, std::clock_t clocks) OVERRIDE;
+    void addResults(const std::string& str, const TimerResultsData &data) OVERRIDE;
+
+    /**
+     * Add the results of one file to the totals.
+     * @param file the checked file
+     * @param fileResults the results of the file
+     * @param keepPerFile keep the results of the file for writeResults()
+     */
+    void addFileResults(const std::string &file, const TimerResults &fileResults, bool keepPerFile);
+
+    /** Add the totals and the file results of other, e.g. of a worker process */
+    void merge(const TimerResults &other);
+
+    void clear();
+
+    bool empty() const;
+
+    /**
+     * Write the totals and the results of each file. The format is CSV
+     * if the filename ends with ".csv" and JSON otherwise.
+     * @return false if the file can't be written
+     */
+    bool writeResults(const std::string &filename) const;
+
+    void serializeBinary(std::string &buffer) const;
+    bool deserializeBinary(const char *&data, const char *end);
 
 private:
-    std::map<std::string, struct TimerResultsData> mResults;
+    typedef std::map<std::string, TimerResultsData> ResultMap;
+
+    ResultMap mResults;
+    std::vector<std::pair<std::string, ResultMap>> mFileResults;
+    mutable std::mutex mResultsSync;
+};
+
+/**
+ * The timed phases as events on a timeline, written in the Chrome trace
+ * event format that is shown by chrome://tracing and Perfetto. Each worker
+ * of -j is a process of the trace, so the load of the workers can be compared.
+ */
+class CPPCHECKLIB TimerTrace {
+public:
+    struct Event {
+        std::string name;
+        /** What was worked on, e.g. the file or the configuration */
+        std::string detail;
+        /** Start time of the steady clock, in nanoseconds */
+        std::int64_t start;
+        /** Duration in nanoseconds */
+        std::int64_t duration;
+        /** Worker of -j, 0 is the main process */
+        unsigned int worker;
+        unsigned int thread;
+    };
+
+    TimerTrace() {
+    }
+
+    void addEvent(const Event &event);
+
+    /** Add the events of other, e.g. of a worker process */
+    void merge(const TimerTrace &other);
+
+    void clear();
+
+    bool empty() const;
+
+    /**
+     * Write the events as JSON in the Chrome trace event format.
+     * @return false if the file can't be written
+     */
+    bool write(const std::string &filename) const;
+
+    void serializeBinary(std::string &buffer) const;
+    bool deserializeBinary(const char *&data, const char *end);
+
+private:
+    std::vector<Event> mEvents;
+    mutable std::mutex mEventsSync;
 };
 
 class CPPCHECKLIB Timer {
@@ -73,13 +181,49 @@ public:
     ~Timer();
     void stop();
 
+    /** Set the number of tokens that are processed in the timed phase */
+    void setTokens(std::size_t tokens) {
+        mTokens = tokens;
+    }
+
+    typedef std::uint64_t (*AllocationCounter)();
+
+    /**
+     * Set the function that returns the number of memory allocations made
+     * by the current thread so far. Without it no allocations are counted.
+     */
+    static void setAllocationCounter(AllocationCounter counter);
+
+    /** Set what is worked on, it is only shown in the trace */
+    void setDetail(const std::string &detail) {
+        if (mTrace)
+            mDetail = detail;
+    }
+
+    /**
+     * Set the trace that gets an event for every timer, also when the
+     * timing results are not shown. nullptr disables the trace.
+     */
+    static void setTrace(TimerTrace *trace);
+    static TimerTrace *trace();
+
+    /** Set the worker of -j that the current thread belongs to, for the trace */
+    static void setTraceWorker(unsigned int worker);
+    static unsigned int traceWorker();
+
 private:
     Timer(const Timer& other); // disallow copying
     Timer& operator=(const Timer&); // disallow assignments
 
     const std::string mStr;
+    std::string mDetail;
     TimerResultsIntf* mTimerResults;
+    TimerTrace* const mTrace;
     std::clock_t mStart;
+    std::chrono::steady_clock::time_point mWallStart;
+    std::uint64_t mPeakMemoryStart;
+    std::uint64_t mAllocationsStart;
+    std::size_t mTokens;
     const SHOWTIME_MODES mShowTimeMode;
     bool mStopped;
 };
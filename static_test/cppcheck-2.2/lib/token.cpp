@@ -26,31 +26,297 @@
 #include "utils.h"
 
 #include <algorithm>
+#include <atomic>
+#include <bitset>
 #include <cassert>
 #include <cctype>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <set>
 #include <stack>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
 
 const std::list<ValueFlow::Value> TokenImpl::mEmptyValueList;
 
+namespace {
+    /** The nodes of the pools are aligned for the Token, the TokenImpl and the free list */
+    const std::size_t PoolAlignment = std::max(sizeof(void *), std::max(alignof(Token), alignof(TokenImpl)));
+
+    /**
+     * Size of the blocks that the nodes are carved from. The blocks grow up
+     * to the maximum size so the small lists of library and type
+     * declarations stay small.
+     */
+    const std::size_t PoolFirstBlockSize = 1024;
+    const std::size_t PoolMaxBlockSize = 64 * 1024;
+
+    std::atomic<std::size_t> poolBlockBytes(0);
+
+    std::size_t poolNodeSize(std::size_t size)
+    {
+        return (size + PoolAlignment - 1) / PoolAlignment * PoolAlignment;
+    }
+
+    /**
+     * Pool of the token texts. The strings are spread over shards that are
+     * locked separately, each thread caches the recently interned strings.
+     * A string is counted once for each token and cache entry that uses it
+     * and is freed together with the last one.
+     */
+    class StringPool {
+    public:
+        static const TokenString *intern(const std::string &str) {
+            if (str.empty())
+                return empty();
+            const std::size_t hash = std::hash<std::string>()(str);
+            const TokenString *&cached = mCache[hash % CacheSize];
+            if (cached && cached->str == str) {
+                cached->refs.fetch_add(1, std::memory_order_relaxed);
+                return cached;
+            }
+            static thread_local CacheReleaser releaser;
+            const TokenString *old = mReleased ? nullptr : cached;
+            const TokenString *ts;
+            {
+                Shard &shard = shards()[(hash / CacheSize) % ShardCount];
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                const auto it = shard.strings.find(&str);
+                if (it != shard.strings.end()) {
+                    ts = it->second;
+                } else {
+                    TokenString *created = new TokenString(str);
+                    shard.strings.emplace(&created->str, created);
+                    ts = created;
+                }
+                ts->refs.fetch_add(mReleased ? 1 : 2, std::memory_order_relaxed);
+            }
+            if (!mReleased)
+                cached = ts;
+            if (old)
+                release(old);
+            return ts;
+        }
+
+        static void release(const TokenString *ts) {
+            if (ts == empty())
+                return;
+            std::size_t refs = ts->refs.load(std::memory_order_relaxed);
+            while (refs > 1) {
+                if (ts->refs.compare_exchange_weak(refs, refs - 1, std::memory_order_release, std::memory_order_relaxed))
+                    return;
+            }
+            const std::size_t hash = std::hash<std::string>()(ts->str);
+            Shard &shard = shards()[(hash / CacheSize) % ShardCount];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (ts->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                shard.strings.erase(&ts->str);
+                delete ts;
+            }
+        }
+
+        static const TokenString *empty() {
+            // Never destroyed, tokens may be deleted during static destruction
+            static const TokenString *s = new TokenString(std::string());
+            return s;
+        }
+
+        static std::size_t size() {
+            std::size_t n = 0;
+            for (std::size_t i = 0; i < ShardCount; ++i) {
+                std::lock_guard<std::mutex> lock(shards()[i].mutex);
+                n += shards()[i].strings.size();
+            }
+            return n;
+        }
+
+    private:
+        static const std::size_t CacheSize = 1024;
+        static const std::size_t ShardCount = 16;
+
+        struct StrPtrHash {
+            std::size_t operator()(const std::string *s) const {
+                return std::hash<std::string>()(*s);
+            }
+        };
+
+        struct StrPtrEqual {
+            bool operator()(const std::string *a, const std::string *b) const {
+                return *a == *b;
+            }
+        };
+
+        struct Shard {
+            std::mutex mutex;
+            std::unordered_map<const std::string *, TokenString *, StrPtrHash, StrPtrEqual> strings;
+        };
+
+        /** Releases the cached strings when the thread exits */
+        struct CacheReleaser {
+            ~CacheReleaser() {
+                mReleased = true;
+                for (std::size_t i = 0; i < CacheSize; ++i) {
+                    if (mCache[i])
+                        release(mCache[i]);
+                    mCache[i] = nullptr;
+                }
+            }
+        };
+
+        static Shard *shards() {
+            // Never destroyed, tokens may be deleted during static destruction
+            static Shard *s = new Shard[ShardCount];
+            return s;
+        }
+
+        static thread_local const TokenString *mCache[CacheSize];
+        static thread_local bool mReleased;
+    };
+
+    thread_local const TokenString *StringPool::mCache[StringPool::CacheSize];
+    thread_local bool StringPool::mReleased = false;
+}
+
+TokenPool::TokenPool() : mBlockBytes(0)
+{
+}
+
+TokenPool::~TokenPool()
+{
+    for (char *block : mBlocks)
+        ::operator delete(block);
+    poolBlockBytes -= mBlockBytes;
+}
+
+void *TokenPool::allocate(TokenPool *pool, std::size_t size)
+{
+    if (!pool)
+        return ::operator new(size);
+    return pool->allocateNode(pool->sizeClass(poolNodeSize(size)));
+}
+
+void TokenPool::deallocate(TokenPool *pool, void *p, std::size_t size)
+{
+    if (!pool) {
+        ::operator delete(p);
+        return;
+    }
+    SizeClass &sizeClass = pool->sizeClass(poolNodeSize(size));
+    Node *node = static_cast<Node *>(p);
+    node->next = sizeClass.freeNodes;
+    sizeClass.freeNodes = node;
+}
+
+TokenPool::SizeClass &TokenPool::sizeClass(std::size_t nodeSize)
+{
+    for (SizeClass &sizeClass : mSizeClasses) {
+        if (sizeClass.nodeSize == nodeSize)
+            return sizeClass;
+    }
+    SizeClass sizeClass;
+    sizeClass.nodeSize = nodeSize;
+    sizeClass.freeNodes = nullptr;
+    sizeClass.blockPos = nullptr;
+    sizeClass.blockEnd = nullptr;
+    mSizeClasses.push_back(sizeClass);
+    return mSizeClasses.back();
+}
+
+TokenPool::Node *TokenPool::allocateNode(SizeClass &sizeClass)
+{
+    if (Node *node = sizeClass.freeNodes) {
+        sizeClass.freeNodes = node->next;
+        return node;
+    }
+    if (static_cast<std::size_t>(sizeClass.blockEnd - sizeClass.blockPos) < sizeClass.nodeSize) {
+        const std::size_t blockSize = std::min(PoolFirstBlockSize << std::min<std::size_t>(mBlocks.size(), 6), PoolMaxBlockSize);
+        mBlocks.push_back(static_cast<char *>(::operator new(blockSize)));
+        mBlockBytes += blockSize;
+        poolBlockBytes += blockSize;
+        sizeClass.blockPos = mBlocks.back();
+        sizeClass.blockEnd = sizeClass.blockPos + blockSize;
+    }
+    Node *node = reinterpret_cast<Node *>(sizeClass.blockPos);
+    sizeClass.blockPos += sizeClass.nodeSize;
+    return node;
+}
+
+std::size_t TokenPool::totalBlockBytes()
+{
+    return poolBlockBytes;
+}
+
+Token *Token::create(TokensFrontBack *tokensFrontBack)
+{
+    void *p = TokenPool::allocate(tokensFrontBack ? tokensFrontBack->pool : nullptr, sizeof(Token));
+    try {
+        return new (p) Token(tokensFrontBack);
+    } catch (...) {
+        TokenPool::deallocate(tokensFrontBack ? tokensFrontBack->pool : nullptr, p, sizeof(Token));
+        throw;
+    }
+}
+
+void Token::destroy(Token *tok)
+{
+    TokenPool *pool = tok->pool();
+    tok->~Token();
+    TokenPool::deallocate(pool, tok, sizeof(Token));
+}
+
+void Token::destroyImpl()
+{
+    if (mImpl) {
+        mImpl->~TokenImpl();
+        TokenPool::deallocate(pool(), mImpl, sizeof(TokenImpl));
+        mImpl = nullptr;
+    }
+}
+
+const TokenString *Token::internString(const std::string &s)
+{
+    return StringPool::intern(s);
+}
+
+void Token::releaseString(const TokenString *s)
+{
+    StringPool::release(s);
+}
+
+std::size_t Token::internedStrings()
+{
+    return StringPool::size();
+}
+
+void Token::assignStr(const std::string &s)
+{
+    const TokenString *old = mStr;
+    mStr = internString(s);
+    releaseString(old);
+}
+
 Token::Token(TokensFrontBack *tokensFrontBack) :
     mTokensFrontBack(tokensFrontBack),
+    mStr(StringPool::empty()),
     mNext(nullptr),
     mPrevious(nullptr),
     mLink(nullptr),
     mTokType(eNone),
     mFlags(0)
 {
-    mImpl = new TokenImpl();
+    mImpl = new (TokenPool::allocate(pool(), sizeof(TokenImpl))) TokenImpl();
 }
 
 Token::~Token()
 {
-    delete mImpl;
+    releaseString(mStr);
+    destroyImpl();
 }
 
 static const std::set<std::string> controlFlowKeywords = {
@@ -69,53 +335,53 @@ static const std::set<std::string> controlFlowKeywords = {
 
 void Token::update_property_info()
 {
-    setFlag(fIsControlFlowKeyword, controlFlowKeywords.find(mStr) != controlFlowKeywords.end());
+    setFlag(fIsControlFlowKeyword, controlFlowKeywords.find(mStr->str) != controlFlowKeywords.end());
 
-    if (!mStr.empty()) {
-        if (mStr == "true" || mStr == "false")
+    if (!mStr->str.empty()) {
+        if (mStr->str == "true" || mStr->str == "false")
             tokType(eBoolean);
-        else if (isStringLiteral(mStr))
+        else if (isStringLiteral(mStr->str))
             tokType(eString);
-        else if (isCharLiteral(mStr))
+        else if (isCharLiteral(mStr->str))
             tokType(eChar);
-        else if (std::isalpha((unsigned char)mStr[0]) || mStr[0] == '_' || mStr[0] == '$') { // Name
+        else if (std::isalpha((unsigned char)mStr->str[0]) || mStr->str[0] == '_' || mStr->str[0] == '$') { // Name
             if (mImpl->mVarId)
                 tokType(eVariable);
-            else if (mTokensFrontBack && mTokensFrontBack->list && mTokensFrontBack->list->isKeyword(mStr))
+            else if (mTokensFrontBack && mTokensFrontBack->list && mTokensFrontBack->list->isKeyword(mStr->str))
                 tokType(eKeyword);
             else if (mTokType != eVariable && mTokType != eFunction && mTokType != eType && mTokType != eKeyword)
                 tokType(eName);
-        } else if (std::isdigit((unsigned char)mStr[0]) || (mStr.length() > 1 && mStr[0] == '-' && std::isdigit((unsigned char)mStr[1])))
+        } else if (std::isdigit((unsigned char)mStr->str[0]) || (mStr->str.length() > 1 && mStr->str[0] == '-' && std::isdigit((unsigned char)mStr->str[1])))
             tokType(eNumber);
-        else if (mStr == "=" || mStr == "<<=" || mStr == ">>=" ||
-                 (mStr.size() == 2U && mStr[1] == '=' && std::strchr("+-*/%&^|", mStr[0])))
+        else if (mStr->str == "=" || mStr->str == "<<=" || mStr->str == ">>=" ||
+                 (mStr->str.size() == 2U && mStr->str[1] == '=' && std::strchr("+-*/%&^|", mStr->str[0])))
             tokType(eAssignmentOp);
-        else if (mStr.size() == 1 && mStr.find_first_of(",[]()?:") != std::string::npos)
+        else if (mStr->str.size() == 1 && mStr->str.find_first_of(",[]()?:") != std::string::npos)
             tokType(eExtendedOp);
-        else if (mStr=="<<" || mStr==">>" || (mStr.size()==1 && mStr.find_first_of("+-*/%") != std::string::npos))
+        else if (mStr->str=="<<" || mStr->str==">>" || (mStr->str.size()==1 && mStr->str.find_first_of("+-*/%") != std::string::npos))
             tokType(eArithmeticalOp);
-        else if (mStr.size() == 1 && mStr.find_first_of("&|^~") != std::string::npos)
+        else if (mStr->str.size() == 1 && mStr->str.find_first_of("&|^~") != std::string::npos)
             tokType(eBitOp);
-        else if (mStr.size() <= 2 &&
-                 (mStr == "&&" ||
-                  mStr == "||" ||
-                  mStr == "!"))
+        else if (mStr->str.size() <= 2 &&
+                 (mStr->str == "&&" ||
+                  mStr->str == "||" ||
+                  mStr->str == "!"))
             tokType(eLogicalOp);
-        else if (mStr.size() <= 2 && !mLink &&
-                 (mStr == "==" ||
-                  mStr == "!=" ||
-                  mStr == "<"  ||
-                  mStr == "<=" ||
-                  mStr == ">"  ||
-                  mStr == ">="))
+        else if (mStr->str.size() <= 2 && !mLink &&
+                 (mStr->str == "==" ||
+                  mStr->str == "!=" ||
+                  mStr->str == "<"  ||
+                  mStr->str == "<=" ||
+                  mStr->str == ">"  ||
+                  mStr->str == ">="))
             tokType(eComparisonOp);
-        else if (mStr.size() == 2 &&
-                 (mStr == "++" ||
-                  mStr == "--"))
+        else if (mStr->str.size() == 2 &&
+                 (mStr->str == "++" ||
+                  mStr->str == "--"))
             tokType(eIncDecOp);
-        else if (mStr.size() == 1 && (mStr.find_first_of("{}") != std::string::npos || (mLink && mStr.find_first_of("<>") != std::string::npos)))
+        else if (mStr->str.size() == 1 && (mStr->str.find_first_of("{}") != std::string::npos || (mLink && mStr->str.find_first_of("<>") != std::string::npos)))
             tokType(eBracket);
-        else if (mStr == "...")
+        else if (mStr->str == "...")
             tokType(eEllipsis);
         else
             tokType(eOther);
@@ -144,10 +410,10 @@ void Token::update_property_isStandardType()
 {
     isStandardType(false);
 
-    if (mStr.size() < 3)
+    if (mStr->str.size() < 3)
         return;
 
-    if (stdTypes.find(mStr)!=stdTypes.end()) {
+    if (stdTypes.find(mStr->str)!=stdTypes.end()) {
         isStandardType(true);
         tokType(eType);
     }
@@ -158,15 +424,15 @@ void Token::update_property_char_string_literal()
     if (mTokType != Token::eString && mTokType != Token::eChar)
         return;
 
-    isLong(((mTokType == Token::eString) && isPrefixStringCharLiteral(mStr, '"', "L")) ||
-           ((mTokType == Token::eChar) && isPrefixStringCharLiteral(mStr, '\'', "L")));
+    isLong(((mTokType == Token::eString) && isPrefixStringCharLiteral(mStr->str, '"', "L")) ||
+           ((mTokType == Token::eChar) && isPrefixStringCharLiteral(mStr->str, '\'', "L")));
 }
 
 bool Token::isUpperCaseName() const
 {
     if (!isName())
         return false;
-    for (char i : mStr) {
+    for (char i : mStr->str) {
         if (std::islower(i))
             return false;
     }
@@ -175,19 +441,21 @@ bool Token::isUpperCaseName() const
 
 void Token::concatStr(std::string const& b)
 {
-    mStr.erase(mStr.length() - 1);
-    mStr.append(getStringLiteral(b) + "\"");
+    std::string s(mStr->str);
+    s.erase(s.length() - 1);
+    s.append(getStringLiteral(b) + "\"");
 
     if (isCChar() && isStringLiteral(b) && b[0] != '"') {
-        mStr.insert(0, b.substr(0, b.find('"')));
+        s.insert(0, b.substr(0, b.find('"')));
     }
+    assignStr(s);
     update_property_info();
 }
 
 std::string Token::strValue() const
 {
     assert(mTokType == eString);
-    std::string ret(getStringLiteral(mStr));
+    std::string ret(getStringLiteral(mStr->str));
     std::string::size_type pos = 0U;
     while ((pos = ret.find('\\', pos)) != std::string::npos) {
         ret.erase(pos,1U);
@@ -216,7 +484,7 @@ void Token::deleteNext(nonneg int count)
             n->mLink->link(nullptr);
 
         mNext = n->next();
-        delete n;
+        destroy(n);
         --count;
     }
 
@@ -236,7 +504,7 @@ void Token::deletePrevious(nonneg int count)
             p->mLink->link(nullptr);
 
         mPrevious = p->previous();
-        delete p;
+        destroy(p);
         --count;
     }
 
@@ -272,10 +540,10 @@ void Token::swapWithNext()
 
 void Token::takeData(Token *fromToken)
 {
-    mStr = fromToken->mStr;
+    assignStr(fromToken->mStr->str);
     tokType(fromToken->mTokType);
     mFlags = fromToken->mFlags;
-    delete mImpl;
+    destroyImpl();
     mImpl = fromToken->mImpl;
     fromToken->mImpl = nullptr;
     if (mImpl->mTemplateSimplifierPointers)
@@ -300,7 +568,7 @@ void Token::deleteThis()
         mPrevious = mPrevious->mPrevious;
         mPrevious->mNext = this;
 
-        delete toDelete;
+        destroy(toDelete);
     } else {
         // We are the last token in the list, we can't delete
         // ourselves, so just make us empty
@@ -338,7 +606,7 @@ void Token::replace(Token *replaceThis, Token *start, Token *end)
         tok->mImpl->mProgressValue = replaceThis->mImpl->mProgressValue;
 
     // Delete old token, which is replaced
-    delete replaceThis;
+    destroy(replaceThis);
 }
 
 const Token *Token::tokAt(int index) const
@@ -367,7 +635,7 @@ const Token *Token::linkAt(int index) const
 const std::string &Token::strAt(int index) const
 {
     const Token *tok = this->tokAt(index);
-    return tok ? tok->mStr : emptyString;
+    return tok ? tok->mStr->str : emptyString;
 }
 
 static int multiComparePercent(const Token *tok, const char*& haystack, nonneg int varid)
@@ -573,7 +841,7 @@ bool Token::simpleMatch(const Token *tok, const char pattern[], size_t pattern_l
     while (*current) {
         const std::size_t length = next - current;
 
-        if (!tok || length != tok->mStr.length() || std::strncmp(current, tok->mStr.c_str(), length))
+        if (!tok || length != tok->mStr->str.length() || std::strncmp(current, tok->mStr->str.c_str(), length))
             return false;
 
         current = next;
@@ -616,7 +884,7 @@ const char *Token::chrInFirstWord(const char *str, char c)
     }
 }
 
-bool Token::Match(const Token *tok, const char pattern[], nonneg int varid)
+bool Token::matchPattern(const Token *tok, const char pattern[], nonneg int varid)
 {
     const char *p = pattern;
     while (*p) {
@@ -703,6 +971,262 @@ bool Token::Match(const Token *tok, const char pattern[], nonneg int varid)
     return true;
 }
 
+namespace {
+    /**
+     * A Token::Match() pattern parsed into its words. Literal words are
+     * compared by the address of the interned token text. Patterns that
+     * use anything unusual are not parsed, they are matched by
+     * Token::matchPattern() so the behaviour is the same.
+     */
+    class CompiledPattern {
+    public:
+        explicit CompiledPattern(const std::string &text) : mText(text), mValid(true) {
+            const char *p = mText.c_str();
+            while (*p && mValid) {
+                while (*p == ' ')
+                    ++p;
+                const char *end = p;
+                while (*end && *end != ' ')
+                    ++end;
+                if (end != p)
+                    addWord(std::string(p, end));
+                p = end;
+            }
+        }
+
+        /** Is this the pattern in the given array */
+        bool isPattern(const char pattern[], std::size_t size) const {
+            return mText.size() == size && std::memcmp(mText.data(), pattern, size) == 0;
+        }
+
+        bool valid() const {
+            return mValid;
+        }
+
+        bool match(const Token *tok, nonneg int varid) const {
+            for (const Word &word : mWords) {
+                if (!tok) {
+                    // If we have no tokens, pattern "!!else" should return true
+                    if (word.kind == Word::Not)
+                        continue;
+                    return false;
+                }
+                switch (word.kind) {
+                case Word::Chars:
+                    if (tok->str().length() != 1 || !mChars[word.begin][(unsigned char)tok->str()[0]])
+                        return false;
+                    break;
+                case Word::Not:
+                    if (mAlternatives[word.begin].match(tok, varid))
+                        return false;
+                    break;
+                case Word::Alternatives: {
+                    const Alternative *alternative = mAlternatives.data() + word.begin;
+                    const Alternative * const end = mAlternatives.data() + word.end;
+                    while (alternative != end && !alternative->match(tok, varid))
+                        ++alternative;
+                    if (alternative == end) {
+                        // Empty alternative matches, use the same token for the next word
+                        if (word.optional)
+                            continue;
+                        return false;
+                    }
+                    break;
+                }
+                }
+                tok = tok->next();
+            }
+            return true;
+        }
+
+    private:
+        enum Command { Literal, Empty, Any, Assign, Bool, Char, Comp, Cop, Name, Num, Op, Or, OrOr, Str, Type, Var, VarId };
+
+        struct Alternative {
+            Command command;
+            /** Interned text of a literal, or the text the command compares with */
+            const std::string *str;
+
+            bool match(const Token *tok, nonneg int varid) const {
+                switch (command) {
+                case Literal:
+                    return &tok->str() == str;
+                case Empty:
+                    return tok->str().empty();
+                case Any:
+                    return true;
+                case Assign:
+                    return tok->isAssignmentOp();
+                case Bool:
+                    return tok->isBoolean();
+                case Char:
+                    return tok->tokType() == Token::eChar;
+                case Comp:
+                    return tok->isComparisonOp();
+                case Cop:
+                    return tok->isConstOp();
+                case Name:
+                    return tok->isName();
+                case Num:
+                    return tok->isNumber();
+                case Op:
+                    return tok->isOp();
+                case Or:
+                    return tok->tokType() == Token::eBitOp && &tok->str() == str;
+                case OrOr:
+                    return tok->tokType() == Token::eLogicalOp && &tok->str() == str;
+                case Str:
+                    return tok->tokType() == Token::eString;
+                case Type:
+                    // HACK: this is legacy behaviour, it should return false for all keywords, except types
+                    return tok->isName() && tok->varId() == 0 && (&tok->str() != str || !tok->isKeyword());
+                case Var:
+                    return tok->varId() != 0;
+                case VarId:
+                    if (varid == 0)
+                        throw InternalError(tok, "Internal error. Token::Match called with varid 0. Please report this to Cppcheck developers");
+                    return tok->varId() == varid;
+                }
+                return false;
+            }
+        };
+
+        struct Word {
+            enum Kind { Alternatives, Chars, Not } kind;
+            /** Ends with '|', the word may match no token */
+            bool optional;
+            /** The alternatives of the word, or the index of its characters */
+            std::size_t begin;
+            std::size_t end;
+        };
+
+        static Alternative alternative(Command command, const std::string &str) {
+            Alternative alternative;
+            alternative.command = command;
+            alternative.str = &StringPool::intern(str)->str;
+            return alternative;
+        }
+
+        static Alternative literal(const std::string &str) {
+            return alternative(str.empty() ? Empty : Literal, str);
+        }
+
+        void addWord(const std::string &str) {
+            Word word;
+            word.kind = Word::Alternatives;
+            word.optional = false;
+            word.begin = mAlternatives.size();
+            if (str[0] == '[' && str.find(']') != std::string::npos) {
+                // [.. => search for a one-character token..
+                word.kind = Word::Chars;
+                word.begin = mChars.size();
+                std::bitset<256> chars;
+                for (std::string::size_type i = 1; i < str.size(); ++i) {
+                    if (str[i] != ']')
+                        chars.set((unsigned char)str[i]);
+                }
+                if (std::count(str.begin(), str.end(), ']') > 1)
+                    chars.set((unsigned char)']');
+                mChars.push_back(chars);
+            } else if (str == "!!") {
+                // "!! " means "not empty", rather use matchPattern()
+                mValid = false;
+                return;
+            } else if (str.size() > 2 && str[0] == '!' && str[1] == '!') {
+                // Token can be anything except the given one
+                word.kind = Word::Not;
+                mAlternatives.push_back(literal(str.substr(2)));
+            } else {
+                // Multi options, such as void|int|char
+                std::string::size_type start = 0;
+                for (;;) {
+                    const std::string::size_type end = std::min(str.find('|', start), str.size());
+                    const std::string text = str.substr(start, end - start);
+                    if (text.size() > 1 && text[0] == '%') {
+                        static const std::map<std::string, std::pair<Command, std::string>> commands = {
+                            { "%any%", { Any, "" } }, { "%assign%", { Assign, "" } }, { "%bool%", { Bool, "" } },
+                            { "%char%", { Char, "" } }, { "%comp%", { Comp, "" } }, { "%cop%", { Cop, "" } },
+                            { "%name%", { Name, "" } }, { "%num%", { Num, "" } }, { "%op%", { Op, "" } },
+                            { "%or%", { Or, "|" } }, { "%oror%", { OrOr, "||" } }, { "%str%", { Str, "" } },
+                            { "%type%", { Type, "delete" } }, { "%var%", { Var, "" } }, { "%varid%", { VarId, "" } }
+                        };
+                        const std::map<std::string, std::pair<Command, std::string>>::const_iterator it = commands.find(text);
+                        if (it == commands.end()) {
+                            mValid = false;
+                            return;
+                        }
+                        mAlternatives.push_back(alternative(it->second.first, it->second.second));
+                    } else {
+                        mAlternatives.push_back(literal(text));
+                    }
+                    if (end == str.size())
+                        break;
+                    start = end + 1;
+                }
+                word.optional = str.back() == '|';
+            }
+            word.end = mAlternatives.size();
+            mWords.push_back(word);
+        }
+
+        /** The bytes of the array that holds the pattern */
+        const std::string mText;
+        bool mValid;
+        std::vector<Word> mWords;
+        std::vector<Alternative> mAlternatives;
+        std::vector<std::bitset<256>> mChars;
+    };
+
+    /**
+     * The parsed patterns, looked up by the text of the pattern. A slot,
+     * selected by the address of the pattern, holds the pattern that used it
+     * last. Its text is compared, an array at the same address may hold
+     * another pattern. The parsed patterns are never freed so a slot can be
+     * read without locking.
+     */
+    class CompiledPatterns {
+    public:
+        /** @return the parsed pattern */
+        static const CompiledPattern *get(const char pattern[], std::size_t size) {
+            std::atomic<const CompiledPattern *> &slot = mSlots[hash(pattern)];
+            const CompiledPattern *compiled = slot.load(std::memory_order_acquire);
+            if (compiled && compiled->isPattern(pattern, size))
+                return compiled;
+
+            typedef std::map<std::string, const CompiledPattern *> Patterns;
+            static std::mutex mutex;
+            static Patterns *patterns = new Patterns;
+            const std::string text(pattern, size);
+            std::lock_guard<std::mutex> lock(mutex);
+            Patterns::iterator it = patterns->find(text);
+            if (it == patterns->end())
+                it = patterns->emplace(text, new CompiledPattern(text)).first;
+            slot.store(it->second, std::memory_order_release);
+            return it->second;
+        }
+
+    private:
+        static const std::size_t SlotBits = 13;
+
+        static std::size_t hash(const char pattern[]) {
+            // Fibonacci hashing
+            return (std::uint64_t(reinterpret_cast<std::uintptr_t>(pattern)) * 0x9E3779B97F4A7C15ULL) >> (64 - SlotBits);
+        }
+
+        static std::atomic<const CompiledPattern *> mSlots[1U << SlotBits];
+    };
+
+    std::atomic<const CompiledPattern *> CompiledPatterns::mSlots[1U << CompiledPatterns::SlotBits];
+}
+
+bool Token::matchCompiled(const Token *tok, const char pattern[], std::size_t size, nonneg int varid)
+{
+    const CompiledPattern *compiled = CompiledPatterns::get(pattern, size);
+    if (!compiled->valid())
+        return matchPattern(tok, pattern, varid);
+    return compiled->match(tok, varid);
+}
+
 nonneg int Token::getStrLength(const Token *tok)
 {
     assert(tok != nullptr);
@@ -862,7 +1386,7 @@ static bool isOperator(const Token *tok)
 
 const Token * Token::findClosingBracket() const
 {
-    if (mStr != "<")
+    if (mStr->str != "<")
         return nullptr;
 
     const Token *closing = nullptr;
@@ -907,7 +1431,7 @@ Token * Token::findClosingBracket()
 
 const Token * Token::findOpeningBracket() const
 {
-    if (mStr != ">")
+    if (mStr->str != ">")
         return nullptr;
 
     const Token *opening = nullptr;
@@ -990,10 +1514,10 @@ void Token::function(const Function *f)
 void Token::insertToken(const std::string &tokenStr, const std::string &originalNameStr, bool prepend)
 {
     Token *newToken;
-    if (mStr.empty())
+    if (mStr->str.empty())
         newToken = this;
     else
-        newToken = new Token(mTokensFrontBack);
+        newToken = create(mTokensFrontBack);
     newToken->str(tokenStr);
     if (!originalNameStr.empty())
         newToken->originalName(originalNameStr);
@@ -1174,15 +1698,15 @@ void Token::stringify(std::ostream& os, const stringifyOptions& options) const
     }
     if (options.macro && isExpandedMacro())
         os << "$";
-    if (isName() && mStr.find(' ') != std::string::npos) {
-        for (char i : mStr) {
+    if (isName() && mStr->str.find(' ') != std::string::npos) {
+        for (char i : mStr->str) {
             if (i != ' ')
                 os << i;
         }
-    } else if (mStr[0] != '\"' || mStr.find('\0') == std::string::npos)
-        os << mStr;
+    } else if (mStr->str[0] != '\"' || mStr->str.find('\0') == std::string::npos)
+        os << mStr->str;
     else {
-        for (char i : mStr) {
+        for (char i : mStr->str) {
             if (i == '\0')
                 os << "\\0";
             else
@@ -1555,7 +2079,7 @@ void Token::astStringVerboseRecursive(std::string& ret, const nonneg int indent1
 {
     if (isExpandedMacro())
         ret += '$';
-    ret += mStr;
+    ret += mStr->str;
     if (mImpl->mValueType)
         ret += " \'" + mImpl->mValueType->str() + '\'';
     if (function()) {
@@ -1977,20 +2501,38 @@ static void removeContradictions(std::list<ValueFlow::Value>& values)
     }
 }
 
+static bool isSameValues(const std::list<ValueFlow::Value> &values1, const std::list<ValueFlow::Value> &values2)
+{
+    return values1.size() == values2.size() &&
+           std::equal(values1.begin(), values1.end(), values2.begin(), [](const ValueFlow::Value &v1, const ValueFlow::Value &v2) {
+        return v1.isSame(v2);
+    });
+}
+
 bool Token::addValue(const ValueFlow::Value &value)
 {
+    // Values before they were cleared by a known value. A known value is
+    // often added again, that does not change the values.
+    std::unique_ptr<std::list<ValueFlow::Value>> oldValues;
     if (value.isKnown() && mImpl->mValues) {
         // Clear all other values of the same type since value is known
-        mImpl->mValues->remove_if([&](const ValueFlow::Value & x) {
+        const auto sameType = [&](const ValueFlow::Value & x) {
             return x.valueType == value.valueType;
-        });
+        };
+        if (std::any_of(mImpl->mValues->begin(), mImpl->mValues->end(), sameType)) {
+            oldValues.reset(new std::list<ValueFlow::Value>(*mImpl->mValues));
+            mImpl->mValues->remove_if(sameType);
+        }
     }
 
     if (mImpl->mValues) {
         // Don't handle more than 10 values for performance reasons
         // TODO: add setting?
-        if (mImpl->mValues->size() >= 10U)
+        if (mImpl->mValues->size() >= 10U) {
+            if (oldValues)
+                valuesChanged();
             return false;
+        }
 
         // if value already exists, don't add it again
         std::list<ValueFlow::Value>::iterator it;
@@ -2063,6 +2605,8 @@ bool Token::addValue(const ValueFlow::Value &value)
     }
 
     removeContradictions(*mImpl->mValues);
+    if (!oldValues || !isSameValues(*oldValues, *mImpl->mValues))
+        valuesChanged();
 
     return true;
 }
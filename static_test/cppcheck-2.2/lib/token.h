@@ -27,12 +27,14 @@
 #include "templatesimplifier.h"
 #include "utils.h"
 
+#include <atomic>
 #include <cstddef>
 #include <functional>
 #include <list>
 #include <memory>
 #include <ostream>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 class Enumerator;
@@ -43,6 +45,19 @@ class Type;
 class ValueType;
 class Variable;
 class TokenList;
+class TokenPool;
+
+/**
+ * A token text. The tokens with equal texts share one TokenString, it is
+ * freed when the last token that uses it releases it.
+ */
+struct TokenString {
+    explicit TokenString(const std::string &s) : str(s), refs(0) {}
+
+    const std::string str;
+    /** Tokens and caches that use the text */
+    mutable std::atomic<std::size_t> refs;
+};
 
 /**
  * @brief This struct stores pointers to the front and back tokens of the list this token is in.
@@ -51,6 +66,11 @@ struct TokensFrontBack {
     Token *front;
     Token *back;
     const TokenList* list;
+    /** Incremented when the ValueFlow values of a token in the list are
+        changed. ValueFlow may change the values in several threads. */
+    std::atomic<std::size_t> valueGeneration;
+    /** Memory of the tokens in the list, nullptr to use the heap */
+    TokenPool *pool;
 };
 
 struct ScopeInfo2 {
@@ -187,9 +207,18 @@ public:
     explicit Token(TokensFrontBack *tokensFrontBack = nullptr);
     ~Token();
 
+    /**
+     * Create a token of a list. The memory is taken from the pool of the
+     * list, the token must be deleted with destroy().
+     */
+    static Token *create(TokensFrontBack *tokensFrontBack);
+
+    /** Delete a token that is created by create() */
+    static void destroy(Token *tok);
+
     template<typename T>
     void str(T&& s) {
-        mStr = s;
+        assignStr(s);
         mImpl->mVarId = 0;
 
         update_property_info();
@@ -202,9 +231,12 @@ public:
     void concatStr(std::string const& b);
 
     const std::string &str() const {
-        return mStr;
+        return mStr->str;
     }
 
+    /** Number of distinct token texts in use */
+    static std::size_t internedStrings();
+
     /**
      * Unlink and delete the next 'count' tokens.
      */
@@ -306,6 +338,9 @@ public:
      * "const" or "void" and token after that is '{'. If even one of the tokens does not
      * match its pattern, false is returned.
      *
+     * A pattern in a const char array, such as a string literal, is parsed the first
+     * time it is used, other patterns are parsed by every call.
+     *
      * @param tok List of tokens to be compared to the pattern
      * @param pattern The pattern against which the tokens are compared,
      * e.g. "const" or ") const|volatile| {".
@@ -314,7 +349,21 @@ public:
      * @return true if given token matches with given pattern
      *         false if given token does not match with given pattern
      */
-    static bool Match(const Token *tok, const char pattern[], nonneg int varid = 0);
+    template<size_t count>
+    static bool Match(const Token *tok, const char (&pattern)[count], nonneg int varid = 0) {
+        return matchCompiled(tok, pattern, count, varid);
+    }
+
+    /** A char array is not parsed once, its pattern may change */
+    template<size_t count>
+    static bool Match(const Token *tok, char (&pattern)[count], nonneg int varid = 0) {
+        return matchPattern(tok, pattern, varid);
+    }
+
+    template<class T, REQUIRES("T must be a C-string", std::is_convertible<T, const char *>)>
+    static bool Match(const Token *tok, T pattern, nonneg int varid = 0) {
+        return matchPattern(tok, pattern, varid);
+    }
 
     /**
      * @return length of C-string.
@@ -437,7 +486,7 @@ public:
         return astOperand1() != nullptr && astOperand2() != nullptr;
     }
     bool isUnaryOp(const std::string &s) const {
-        return s == mStr && astOperand1() != nullptr && astOperand2() == nullptr;
+        return s == mStr->str && astOperand1() != nullptr && astOperand2() == nullptr;
     }
     bool isUnaryPreOp() const;
 
@@ -645,28 +694,28 @@ public:
     }
 
     bool isUtf8() const {
-        return (((mTokType == eString) && isPrefixStringCharLiteral(mStr, '"', "u8")) ||
-                ((mTokType == eChar) && isPrefixStringCharLiteral(mStr, '\'', "u8")));
+        return (((mTokType == eString) && isPrefixStringCharLiteral(mStr->str, '"', "u8")) ||
+                ((mTokType == eChar) && isPrefixStringCharLiteral(mStr->str, '\'', "u8")));
     }
 
     bool isUtf16() const {
-        return (((mTokType == eString) && isPrefixStringCharLiteral(mStr, '"', "u")) ||
-                ((mTokType == eChar) && isPrefixStringCharLiteral(mStr, '\'', "u")));
+        return (((mTokType == eString) && isPrefixStringCharLiteral(mStr->str, '"', "u")) ||
+                ((mTokType == eChar) && isPrefixStringCharLiteral(mStr->str, '\'', "u")));
     }
 
     bool isUtf32() const {
-        return (((mTokType == eString) && isPrefixStringCharLiteral(mStr, '"', "U")) ||
-                ((mTokType == eChar) && isPrefixStringCharLiteral(mStr, '\'', "U")));
+        return (((mTokType == eString) && isPrefixStringCharLiteral(mStr->str, '"', "U")) ||
+                ((mTokType == eChar) && isPrefixStringCharLiteral(mStr->str, '\'', "U")));
     }
 
     bool isCChar() const {
-        return (((mTokType == eString) && isPrefixStringCharLiteral(mStr, '"', "")) ||
-                ((mTokType ==  eChar) && isPrefixStringCharLiteral(mStr, '\'', "") && mStr.length() == 3));
+        return (((mTokType == eString) && isPrefixStringCharLiteral(mStr->str, '"', "")) ||
+                ((mTokType ==  eChar) && isPrefixStringCharLiteral(mStr->str, '\'', "") && mStr->str.length() == 3));
     }
 
     bool isCMultiChar() const {
-        return (((mTokType ==  eChar) && isPrefixStringCharLiteral(mStr, '\'', "")) &&
-                (mStr.length() > 3));
+        return (((mTokType ==  eChar) && isPrefixStringCharLiteral(mStr->str, '\'', "")) &&
+                (mStr->str.length() > 3));
     }
     /**
      * @brief Is current token a template argument?
@@ -919,7 +968,7 @@ public:
      */
     void link(Token *linkToToken) {
         mLink = linkToToken;
-        if (mStr == "<" || mStr == ">")
+        if (mStr->str == "<" || mStr->str == ">")
             update_property_info();
     }
 
@@ -1136,8 +1185,12 @@ public:
     bool addValue(const ValueFlow::Value &value);
 
     void removeValues(std::function<bool(const ValueFlow::Value &)> pred) {
-        if (mImpl->mValues)
+        if (mImpl->mValues) {
+            const std::size_t size = mImpl->mValues->size();
             mImpl->mValues->remove_if(pred);
+            if (mImpl->mValues->size() != size)
+                valuesChanged();
+        }
     }
 
     nonneg int index() const {
@@ -1172,7 +1225,37 @@ private:
      */
     static const char *chrInFirstWord(const char *str, char c);
 
-    std::string mStr;
+    /**
+     * Match() for a pattern in a const char array. The pattern is parsed
+     * once, the parsed pattern is looked up by the text of the array.
+     */
+    static bool matchCompiled(const Token *tok, const char pattern[], std::size_t size, nonneg int varid);
+
+    /** Match() for any pattern, the pattern is parsed while it is matched */
+    static bool matchPattern(const Token *tok, const char pattern[], nonneg int varid);
+
+    /** Token text, interned by internString() */
+    const TokenString *mStr;
+
+    /** Pool of the token list, nullptr if the token has no list */
+    TokenPool *pool() const {
+        return mTokensFrontBack ? mTokensFrontBack->pool : nullptr;
+    }
+
+    /** Delete mImpl, it is allocated from the pool of the token list */
+    void destroyImpl();
+
+    /** Set the token text without updating the properties */
+    void assignStr(const std::string &s);
+
+    /**
+     * Get the interned copy of a token text with a reference to it. Equal
+     * texts share one TokenString.
+     */
+    static const TokenString *internString(const std::string &s);
+
+    /** Release a reference to an interned text, it is freed with the last reference */
+    static void releaseString(const TokenString *s);
 
     Token *mNext;
     Token *mPrevious;
@@ -1240,6 +1323,12 @@ private:
         Called after any mStr() modification. */
     void update_property_info();
 
+    /** Count a change of the values, see TokenList::valueGeneration() */
+    void valuesChanged() {
+        if (mTokensFrontBack)
+            mTokensFrontBack->valueGeneration.fetch_add(1, std::memory_order_relaxed);
+    }
+
     /** Update internal property cache about isStandardType() */
     void update_property_isStandardType();
 
@@ -1321,6 +1410,8 @@ public:
     }
 
     void clearValueFlow() {
+        if (mImpl->mValues && !mImpl->mValues->empty())
+            valuesChanged();
         delete mImpl->mValues;
         mImpl->mValues = nullptr;
     }
@@ -1331,7 +1422,7 @@ public:
             ret = mImpl->mAstOperand1->astString(sep);
         if (mImpl->mAstOperand2)
             ret += mImpl->mAstOperand2->astString(sep);
-        return ret + sep + mStr;
+        return ret + sep + mStr->str;
     }
 
     std::string astStringVerbose() const;
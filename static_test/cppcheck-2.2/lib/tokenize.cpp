@@ -156,7 +156,8 @@ Tokenizer::Tokenizer() :
     mVarId(0),
     mUnnamedCount(0),
     mCodeWithTemplates(false), //is there any templates?
-    mTimerResults(nullptr)
+    mTimerResults(nullptr),
+    mValueFlowJobs(1)
 #ifdef MAXTIME
     , mMaxTime(std::time(0) + MAXTIME)
 #endif
@@ -173,7 +174,8 @@ Tokenizer::Tokenizer(const Settings *settings, ErrorLogger *errorLogger) :
     mVarId(0),
     mUnnamedCount(0),
     mCodeWithTemplates(false), //is there any templates?
-    mTimerResults(nullptr)
+    mTimerResults(nullptr),
+    mValueFlowJobs(1)
 #ifdef MAXTIME
     ,mMaxTime(std::time(0) + MAXTIME)
 #endif
@@ -2377,9 +2379,9 @@ bool Tokenizer::simplifyTokens1(const std::string &configuration)
 
     if (mTimerResults) {
         Timer t("Tokenizer::simplifyTokens1::ValueFlow", mSettings->showtime, mTimerResults);
-        ValueFlow::setValues(&list, mSymbolDatabase, mErrorLogger, mSettings);
+        ValueFlow::setValues(&list, mSymbolDatabase, mErrorLogger, mSettings, mTimerResults, mValueFlowJobs);
     } else {
-        ValueFlow::setValues(&list, mSymbolDatabase, mErrorLogger, mSettings);
+        ValueFlow::setValues(&list, mSymbolDatabase, mErrorLogger, mSettings, nullptr, mValueFlowJobs);
     }
 
     mSymbolDatabase->setArrayDimensionsUsingValueFlow();
@@ -93,6 +93,11 @@ public:
         mTimerResults = tr;
     }
 
+    /** How many threads analyze the function scopes in ValueFlow at the same time */
+    void setValueFlowJobs(unsigned int jobs) {
+        mValueFlowJobs = jobs;
+    }
+
     /** Is the code C. Used for bailouts */
     bool isC() const {
         return list.isC();
@@ -965,6 +970,9 @@ private:
      */
     TimerResults *mTimerResults;
 
+    /** Threads that analyze the function scopes in ValueFlow */
+    unsigned int mValueFlowJobs;
+
 #ifdef MAXTIME
     /** Tokenizer maxtime */
     const std::time_t mMaxTime;
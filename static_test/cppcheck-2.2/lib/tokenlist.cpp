@@ -41,10 +41,12 @@ static const int AST_MAX_DEPTH = 50;
 TokenList::TokenList(const Settings* settings) :
     mTokensFrontBack(),
     mSettings(settings),
+    mForwardAnalysisBudget(nullptr),
     mIsC(false),
     mIsCpp(false)
 {
     mTokensFrontBack.list = this;
+    mTokensFrontBack.pool = &mTokenPool;
     mKeywords.insert("auto");
     mKeywords.insert("break");
     mKeywords.insert("case");
@@ -177,7 +179,7 @@ void TokenList::deleteTokens(Token *tok)
 {
     while (tok) {
         Token *next = tok->next();
-        delete tok;
+        Token::destroy(tok);
         tok = next;
     }
 }
@@ -209,7 +211,7 @@ void TokenList::addtoken(std::string str, const nonneg int lineno, const nonneg
     if (mTokensFrontBack.back) {
         mTokensFrontBack.back->insertToken(str);
     } else {
-        mTokensFrontBack.front = new Token(&mTokensFrontBack);
+        mTokensFrontBack.front = Token::create(&mTokensFrontBack);
         mTokensFrontBack.back = mTokensFrontBack.front;
         mTokensFrontBack.back->str(str);
     }
@@ -226,7 +228,7 @@ void TokenList::addtoken(std::string str, const Token *locationTok)
     if (mTokensFrontBack.back) {
         mTokensFrontBack.back->insertToken(str);
     } else {
-        mTokensFrontBack.front = new Token(&mTokensFrontBack);
+        mTokensFrontBack.front = Token::create(&mTokensFrontBack);
         mTokensFrontBack.back = mTokensFrontBack.front;
         mTokensFrontBack.back->str(str);
     }
@@ -244,7 +246,7 @@ void TokenList::addtoken(const Token * tok, const nonneg int lineno, const nonne
     if (mTokensFrontBack.back) {
         mTokensFrontBack.back->insertToken(tok->str(), tok->originalName());
     } else {
-        mTokensFrontBack.front = new Token(&mTokensFrontBack);
+        mTokensFrontBack.front = Token::create(&mTokensFrontBack);
         mTokensFrontBack.back = mTokensFrontBack.front;
         mTokensFrontBack.back->str(tok->str());
         if (!tok->originalName().empty())
@@ -264,7 +266,7 @@ void TokenList::addtoken(const Token *tok, const Token *locationTok)
     if (mTokensFrontBack.back) {
         mTokensFrontBack.back->insertToken(tok->str(), tok->originalName());
     } else {
-        mTokensFrontBack.front = new Token(&mTokensFrontBack);
+        mTokensFrontBack.front = Token::create(&mTokensFrontBack);
         mTokensFrontBack.back = mTokensFrontBack.front;
         mTokensFrontBack.back->str(tok->str());
         if (!tok->originalName().empty())
@@ -285,7 +287,7 @@ void TokenList::addtoken(const Token *tok)
     if (mTokensFrontBack.back) {
         mTokensFrontBack.back->insertToken(tok->str(), tok->originalName());
     } else {
-        mTokensFrontBack.front = new Token(&mTokensFrontBack);
+        mTokensFrontBack.front = Token::create(&mTokensFrontBack);
         mTokensFrontBack.back = mTokensFrontBack.front;
         mTokensFrontBack.back->str(tok->str());
         if (!tok->originalName().empty())
@@ -407,7 +409,7 @@ void TokenList::createTokens(simplecpp::TokenList&& tokenList)
         if (mTokensFrontBack.back) {
             mTokensFrontBack.back->insertToken(str);
         } else {
-            mTokensFrontBack.front = new Token(&mTokensFrontBack);
+            mTokensFrontBack.front = Token::create(&mTokensFrontBack);
             mTokensFrontBack.back = mTokensFrontBack.front;
             mTokensFrontBack.back->str(str);
         }
@@ -432,6 +434,14 @@ void TokenList::createTokens(simplecpp::TokenList&& tokenList)
 
 //---------------------------------------------------------------------------
 
+std::size_t TokenList::countTokens() const
+{
+    std::size_t tokens = 0;
+    for (const Token *tok = front(); tok; tok = tok->next())
+        ++tokens;
+    return tokens;
+}
+
 unsigned long long TokenList::calculateChecksum() const
 {
     unsigned long long checksum = 0;
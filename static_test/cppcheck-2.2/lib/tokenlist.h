@@ -24,9 +24,11 @@
 #include "config.h"
 #include "token.h"
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
+class ForwardAnalysisBudget;
 class Settings;
 
 namespace simplecpp {
@@ -36,6 +38,67 @@ namespace simplecpp {
 /// @addtogroup Core
 /// @{
 
+/**
+ * Memory of the Token and TokenImpl objects of one token list. The objects
+ * are carved from blocks that are released when the pool is destroyed,
+ * after the tokens. Like the token list, the pool is used by one thread at
+ * a time.
+ */
+class CPPCHECKLIB TokenPool {
+public:
+    TokenPool();
+    ~TokenPool();
+
+    /**
+     * Allocate memory for a Token or a TokenImpl
+     * @param pool pool of the token list, nullptr to use the heap
+     * @param size size of the object
+     */
+    static void *allocate(TokenPool *pool, std::size_t size);
+
+    /**
+     * Free memory that is allocated by allocate()
+     * @param pool the pool that the memory is allocated from
+     * @param p the memory
+     * @param size size of the object
+     */
+    static void deallocate(TokenPool *pool, void *p, std::size_t size);
+
+    /** Bytes of the blocks that all pools hold */
+    static std::size_t totalBlockBytes();
+
+private:
+    struct Node {
+        Node *next;
+    };
+
+    /**
+     * The nodes of one size. Tokens and TokenImpls are carved from
+     * different blocks so the tokens of a list stay close together.
+     */
+    struct SizeClass {
+        std::size_t nodeSize;
+        Node *freeNodes;
+        char *blockPos;
+        char *blockEnd;
+    };
+
+    SizeClass &sizeClass(std::size_t nodeSize);
+    Node *allocateNode(SizeClass &sizeClass);
+
+    /** Blocks that the nodes are carved from */
+    std::vector<char *> mBlocks;
+    std::size_t mBlockBytes;
+
+    std::vector<SizeClass> mSizeClasses;
+
+    /** Disable copy constructor, no implementation */
+    TokenPool(const TokenPool &);
+
+    /** Disable assignment operator, no implementation */
+    TokenPool &operator=(const TokenPool &);
+};
+
 class CPPCHECKLIB TokenList {
 public:
     explicit TokenList(const Settings* settings);
@@ -49,6 +112,16 @@ public:
         return mSettings;
     }
 
+    /** Set the budget of the forward analysis, while ValueFlow runs */
+    void setForwardAnalysisBudget(ForwardAnalysisBudget *budget) {
+        mForwardAnalysisBudget = budget;
+    }
+
+    /** @return the budget of the forward analysis, nullptr if there is no budget */
+    ForwardAnalysisBudget *getForwardAnalysisBudget() const {
+        return mForwardAnalysisBudget;
+    }
+
     /** @return the source file path. e.g. "file.cpp" */
     const std::string& getSourceFilePath() const;
 
@@ -114,6 +187,14 @@ public:
         return mTokensFrontBack.front;
     }
 
+    /**
+     * Changes when the ValueFlow values of a token in the list are changed.
+     * Equal generations mean that the values are the same.
+     */
+    std::size_t valueGeneration() const {
+        return mTokensFrontBack.valueGeneration.load(std::memory_order_relaxed);
+    }
+
     /** get last token of list */
     const Token *back() const {
         return mTokensFrontBack.back;
@@ -153,6 +234,9 @@ public:
     */
     unsigned long long calculateChecksum() const;
 
+    /** Count the tokens in the list */
+    std::size_t countTokens() const;
+
     /**
      * Create abstract syntax tree.
      */
@@ -199,6 +283,9 @@ private:
 
     void determineCppC();
 
+    /** Memory of the tokens, it is destroyed after the tokens */
+    TokenPool mTokenPool;
+
     /** Token list */
     TokensFrontBack mTokensFrontBack;
 
@@ -211,6 +298,9 @@ private:
     /** settings */
     const Settings* mSettings;
 
+    /** budget of the forward analysis */
+    ForwardAnalysisBudget* mForwardAnalysisBudget;
+
     std::set<std::string> mKeywords;
 
     /** File is known to be C/C++ code */
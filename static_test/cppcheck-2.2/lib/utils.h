@@ -25,6 +25,8 @@
 
 #include <cctype>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -104,6 +106,47 @@ CPPCHECKLIB bool isValidGlobPattern(const std::string& pattern);
 
 CPPCHECKLIB bool matchglob(const std::string& pattern, const std::string& name);
 
+/** Append value to buffer in native byte order */
+template<class T>
+inline void appendBinary(std::string &buffer, T value)
+{
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+/** Append the length and the characters of str to buffer */
+inline void appendBinary(std::string &buffer, const std::string &str)
+{
+    appendBinary(buffer, static_cast<std::uint32_t>(str.size()));
+    buffer.append(str);
+}
+
+/**
+ * Read a value written by appendBinary()
+ * @param data start of the data, it is moved past the value
+ * @param end end of the data
+ * @param value the value is written here
+ * @return false if the data is truncated
+ */
+template<class T>
+inline bool readBinary(const char *&data, const char *end, T &value)
+{
+    if (end - data < static_cast<std::ptrdiff_t>(sizeof(value)))
+        return false;
+    std::memcpy(&value, data, sizeof(value));
+    data += sizeof(value);
+    return true;
+}
+
+inline bool readBinary(const char *&data, const char *end, std::string &str)
+{
+    std::uint32_t len = 0;
+    if (!readBinary(data, end, len) || end - data < static_cast<std::ptrdiff_t>(len))
+        return false;
+    str.assign(data, len);
+    data += len;
+    return true;
+}
+
 #define UNUSED(x) (void)(x)
 
 // Use the nonneg macro when you want to assert that a variable/argument is not negative
@@ -88,21 +88,26 @@
 #include "settings.h"
 #include "standards.h"
 #include "symboldatabase.h"
+#include "timer.h"
 #include "token.h"
 #include "tokenlist.h"
 #include "utils.h"
 #include "valueptr.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstring>
+#include <exception>
 #include <functional>
 #include <iterator>
 #include <limits>
 #include <map>
+#include <memory>
 #include <set>
 #include <stack>
+#include <thread>
 #include <tuple>
 #include <vector>
 
@@ -2195,8 +2200,22 @@ static bool evalAssignment(ValueFlow::Value &lhsValue, const std::string &assign
     return true;
 }
 
-// Check if its an alias of the variable or is being aliased to this variable
-static bool isAliasOf(const Variable * var, const Token *tok, nonneg int varid, const std::list<ValueFlow::Value>& values, bool* inconclusive = nullptr)
+static const ValueFlow::Value &selectValue(const ValueFlow::Value &value)
+{
+    return value;
+}
+
+template<class Key>
+static const ValueFlow::Value &selectValue(const std::pair<const Key, ValueFlow::Value> &p)
+{
+    return p.second;
+}
+
+// Check if its an alias of the variable or is being aliased to this variable.
+// The values are iterated in place, this is called for every token that the
+// values are forwarded to.
+template<class ValueIterator>
+static bool isAliasOf(const Variable * var, const Token *tok, nonneg int varid, ValueIterator first, ValueIterator last, bool* inconclusive = nullptr)
 {
     if (tok->varId() == varid)
         return false;
@@ -2207,7 +2226,8 @@ static bool isAliasOf(const Variable * var, const Token *tok, nonneg int varid,
     if (var && !var->isPointer())
         return false;
     // Search through non value aliases
-    for (const ValueFlow::Value &val : values) {
+    for (ValueIterator it = first; it != last; ++it) {
+        const ValueFlow::Value &val = selectValue(*it);
         if (!val.isNonValue())
             continue;
         if (val.isInconclusive())
@@ -2276,7 +2296,7 @@ struct SelectMapKeys {
 
 struct SelectMapValues {
     template<class Pair>
-    typename Pair::second_type operator()(const Pair& p) const {
+    const typename Pair::second_type &operator()(const Pair& p) const {
         return p.second;
     }
 };
@@ -2558,7 +2578,7 @@ struct SingleValueFlowForwardAnalyzer : ValueFlowForwardAnalyzer {
                 const Variable* var = p.second;
                 if (tok->varId() == varid)
                     return true;
-                if (isAliasOf(var, tok, varid, {value}, &inconclusive))
+                if (isAliasOf(var, tok, varid, &value, &value + 1, &inconclusive))
                     return true;
             }
         }
@@ -2687,7 +2707,7 @@ static ForwardAnalyzer::Action valueFlowForwardVariable(Token* const startToken,
     ForwardAnalyzer::Action actions;
     for (ValueFlow::Value& v : values) {
         VariableForwardAnalyzer a(var, v, aliases, tokenlist);
-        actions |= valueFlowGenericForward(startToken, endToken, a, settings);
+        actions |= valueFlowGenericForward(startToken, endToken, a, tokenlist, settings);
     }
     return actions;
 }
@@ -2797,7 +2817,7 @@ static ForwardAnalyzer::Action valueFlowForwardExpression(Token* startToken,
     ForwardAnalyzer::Action actions;
     for (const ValueFlow::Value& v : values) {
         ExpressionForwardAnalyzer a(exprTok, v, tokenlist);
-        actions |= valueFlowGenericForward(startToken, endToken, a, settings);
+        actions |= valueFlowGenericForward(startToken, endToken, a, tokenlist, settings);
     }
     return actions;
 }
@@ -4379,6 +4399,83 @@ static std::vector<const Variable*> getExprVariables(const Token* expr,
     return result;
 }
 
+/**
+ * Calls f for each function scope. With more than one job the function
+ * scopes are analyzed by several threads. Only passes that write values to
+ * the tokens of the analyzed function, and that do not read the values they
+ * write in other functions, may use this. Their result does not depend on the
+ * order of the function scopes.
+ * - A function scope that is nested in another function scope shares its
+ *   tokens, they are analyzed by one thread in order.
+ * - getLifetimeTokens() reads the values of the return statements of
+ *   functions that return a reference. Those functions are analyzed before
+ *   the threads are started.
+ */
+static void forEachFunctionScope(const SymbolDatabase *symboldatabase, const Settings *settings, unsigned int jobs, const std::function<void(const Scope *)> &f)
+{
+    const std::vector<const Scope *> &functionScopes = symboldatabase->functionScopes;
+    if (jobs <= 1 || functionScopes.size() <= 1 || settings->debugwarnings) {
+        for (const Scope *scope : functionScopes)
+            f(scope);
+        return;
+    }
+
+    // Group the function scopes by the outermost function scope
+    std::vector<std::vector<const Scope *>> groups;
+    std::vector<bool> parallel;
+    std::map<const Scope *, std::size_t> groupOf;
+    for (const Scope *scope : functionScopes) {
+        const Scope *outermost = scope;
+        for (const Scope *nestedIn = scope->nestedIn; nestedIn; nestedIn = nestedIn->nestedIn) {
+            if (nestedIn->type == Scope::eFunction)
+                outermost = nestedIn;
+        }
+        const std::pair<std::map<const Scope *, std::size_t>::iterator, bool> inserted = groupOf.insert(std::make_pair(outermost, groups.size()));
+        if (inserted.second) {
+            groups.emplace_back();
+            parallel.push_back(true);
+        }
+        groups[inserted.first->second].push_back(scope);
+        if (scope->function && Function::returnsReference(scope->function))
+            parallel[inserted.first->second] = false;
+    }
+
+    std::vector<std::size_t> parallelGroups;
+    for (std::size_t i = 0; i < groups.size(); ++i) {
+        if (!parallel[i]) {
+            for (const Scope *scope : groups[i])
+                f(scope);
+        } else {
+            parallelGroups.push_back(i);
+        }
+    }
+
+    // The exception of the first group is rethrown
+    std::vector<std::exception_ptr> exceptions(parallelGroups.size());
+    std::atomic<std::size_t> next(0);
+    const auto worker = [&]() {
+        for (std::size_t i = next++; i < parallelGroups.size(); i = next++) {
+            try {
+                for (const Scope *scope : groups[parallelGroups[i]])
+                    f(scope);
+            } catch (...) {
+                exceptions[i] = std::current_exception();
+            }
+        }
+    };
+    const std::size_t threadCount = std::min<std::size_t>(jobs, parallelGroups.size());
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < threadCount; ++i)
+        threads.emplace_back(worker);
+    worker();
+    for (std::thread &t : threads)
+        t.join();
+    for (const std::exception_ptr &e : exceptions) {
+        if (e)
+            std::rethrow_exception(e);
+    }
+}
+
 struct ValueFlowConditionHandler {
     struct Condition {
         const Token *vartok;
@@ -4395,8 +4492,9 @@ struct ValueFlowConditionHandler {
     void afterCondition(TokenList *tokenlist,
                         SymbolDatabase *symboldatabase,
                         ErrorLogger *errorLogger,
-                        const Settings *settings) const {
-        for (const Scope *scope : symboldatabase->functionScopes) {
+                        const Settings *settings,
+                        unsigned int jobs) const {
+        forEachFunctionScope(symboldatabase, settings, jobs, [&](const Scope *scope) {
             std::set<unsigned> aliased;
             for (Token *tok = const_cast<Token *>(scope->bodyStart); tok != scope->bodyEnd; tok = tok->next()) {
                 if (Token::Match(tok, "if|while|for ("))
@@ -4640,14 +4738,15 @@ struct ValueFlowConditionHandler {
                     }
                 }
             }
-        }
+        });
     }
 };
 
 static void valueFlowAfterCondition(TokenList *tokenlist,
                                     SymbolDatabase *symboldatabase,
                                     ErrorLogger *errorLogger,
-                                    const Settings *settings)
+                                    const Settings *settings,
+                                    unsigned int jobs)
 {
     ValueFlowConditionHandler handler;
     handler.forward =
@@ -4687,7 +4786,7 @@ static void valueFlowAfterCondition(TokenList *tokenlist,
 
         return cond;
     };
-    handler.afterCondition(tokenlist, symboldatabase, errorLogger, settings);
+    handler.afterCondition(tokenlist, symboldatabase, errorLogger, settings, jobs);
 }
 
 static bool isInBounds(const ValueFlow::Value& value, MathLib::bigint x)
@@ -5040,17 +5139,17 @@ static void valueFlowForLoop(TokenList *tokenlist, SymbolDatabase* symboldatabas
             ProgramMemory mem1, mem2, memAfter;
             if (valueFlowForLoop2(tok, &mem1, &mem2, &memAfter)) {
                 ProgramMemory::Map::const_iterator it;
-                for (it = mem1.values.begin(); it != mem1.values.end(); ++it) {
+                for (it = mem1.values().begin(); it != mem1.values().end(); ++it) {
                     if (!it->second.isIntValue())
                         continue;
                     valueFlowForLoopSimplify(bodyStart, it->first, false, it->second.intvalue, tokenlist, errorLogger, settings);
                 }
-                for (it = mem2.values.begin(); it != mem2.values.end(); ++it) {
+                for (it = mem2.values().begin(); it != mem2.values().end(); ++it) {
                     if (!it->second.isIntValue())
                         continue;
                     valueFlowForLoopSimplify(bodyStart, it->first, false, it->second.intvalue, tokenlist, errorLogger, settings);
                 }
-                for (it = memAfter.values.begin(); it != memAfter.values.end(); ++it) {
+                for (it = memAfter.values().begin(); it != memAfter.values().end(); ++it) {
                     if (!it->second.isIntValue())
                         continue;
                     valueFlowForLoopSimplifyAfter(tok, it->first, it->second.intvalue, tokenlist, errorLogger, settings);
@@ -5110,15 +5209,12 @@ struct MultiValueFlowForwardAnalyzer : ValueFlowForwardAnalyzer {
     }
 
     virtual bool isAlias(const Token* tok, bool& inconclusive) const OVERRIDE {
-        std::list<ValueFlow::Value> vals;
-        std::transform(values.begin(), values.end(), std::back_inserter(vals), SelectMapValues{});
-
         for (const auto& p:getVars()) {
             nonneg int varid = p.first;
             const Variable* var = p.second;
             if (tok->varId() == varid)
                 return true;
-            if (isAliasOf(var, tok, varid, vals, &inconclusive))
+            if (isAliasOf(var, tok, varid, values.begin(), values.end(), &inconclusive))
                 return true;
         }
         return false;
@@ -5254,7 +5350,7 @@ static void valueFlowInjectParameter(TokenList* tokenlist, ErrorLogger* errorLog
         if (skip)
             continue;
         MultiValueFlowForwardAnalyzer a(arg, tokenlist);
-        valueFlowGenericForward(const_cast<Token*>(functionScope->bodyStart), functionScope->bodyEnd, a, settings);
+        valueFlowGenericForward(const_cast<Token*>(functionScope->bodyStart), functionScope->bodyEnd, a, tokenlist, settings);
     }
 }
 
@@ -5996,7 +6092,7 @@ static ForwardAnalyzer::Action valueFlowContainerForward(Token* tok,
         TokenList* tokenlist)
 {
     ContainerVariableForwardAnalyzer a(var, value, getAliasesFromValues({value}), tokenlist);
-    return valueFlowGenericForward(tok, endToken, a, tokenlist->getSettings());
+    return valueFlowGenericForward(tok, endToken, a, tokenlist, tokenlist->getSettings());
 }
 static ForwardAnalyzer::Action valueFlowContainerForward(Token* tok,
         const Variable* var,
@@ -6154,7 +6250,8 @@ static std::list<ValueFlow::Value> getIteratorValues(std::list<ValueFlow::Value>
 static void valueFlowIteratorAfterCondition(TokenList *tokenlist,
         SymbolDatabase *symboldatabase,
         ErrorLogger *errorLogger,
-        const Settings *settings)
+        const Settings *settings,
+        unsigned int jobs)
 {
     ValueFlowConditionHandler handler;
     handler.forward =
@@ -6190,7 +6287,7 @@ static void valueFlowIteratorAfterCondition(TokenList *tokenlist,
 
         return cond;
     };
-    handler.afterCondition(tokenlist, symboldatabase, errorLogger, settings);
+    handler.afterCondition(tokenlist, symboldatabase, errorLogger, settings, jobs);
 }
 
 static void valueFlowIteratorInfer(TokenList *tokenlist, const Settings *settings)
@@ -6221,7 +6318,7 @@ static void valueFlowIteratorInfer(TokenList *tokenlist, const Settings *setting
     }
 }
 
-static void valueFlowContainerSize(TokenList *tokenlist, SymbolDatabase* symboldatabase, ErrorLogger * /*errorLogger*/, const Settings *settings)
+static void valueFlowContainerSize(TokenList *tokenlist, SymbolDatabase* symboldatabase, ErrorLogger * /*errorLogger*/, const Settings *settings, unsigned int jobs)
 {
     // declaration
     for (const Variable *var : symboldatabase->variableList()) {
@@ -6248,7 +6345,7 @@ static void valueFlowContainerSize(TokenList *tokenlist, SymbolDatabase* symbold
     }
 
     // after assignment
-    for (const Scope *functionScope : symboldatabase->functionScopes) {
+    forEachFunctionScope(symboldatabase, settings, jobs, [&](const Scope *functionScope) {
         for (const Token *tok = functionScope->bodyStart; tok != functionScope->bodyEnd; tok = tok->next()) {
             if (Token::Match(tok, "%name%|;|{|} %var% = %str% ;")) {
                 const Token *containerTok = tok->next();
@@ -6273,7 +6370,7 @@ static void valueFlowContainerSize(TokenList *tokenlist, SymbolDatabase* symbold
                 }
             }
         }
-    }
+    });
 
     // conditional conditionSize
     for (const Scope &scope : symboldatabase->scopeList) {
@@ -6323,7 +6420,8 @@ static void valueFlowContainerSize(TokenList *tokenlist, SymbolDatabase* symbold
 static void valueFlowContainerAfterCondition(TokenList *tokenlist,
         SymbolDatabase *symboldatabase,
         ErrorLogger *errorLogger,
-        const Settings *settings)
+        const Settings *settings,
+        unsigned int jobs)
 {
     ValueFlowConditionHandler handler;
     handler.forward =
@@ -6396,7 +6494,7 @@ static void valueFlowContainerAfterCondition(TokenList *tokenlist,
         }
         return cond;
     };
-    handler.afterCondition(tokenlist, symboldatabase, errorLogger, settings);
+    handler.afterCondition(tokenlist, symboldatabase, errorLogger, settings, jobs);
 }
 
 static void valueFlowFwdAnalysis(const TokenList *tokenlist, const Settings *settings)
@@ -6782,57 +6880,185 @@ static std::size_t getTotalValues(TokenList *tokenlist)
     return n;
 }
 
-void ValueFlow::setValues(TokenList *tokenlist, SymbolDatabase* symboldatabase, ErrorLogger *errorLogger, const Settings *settings)
+namespace {
+    /**
+     * Runs the passes of ValueFlow::setValues(). The passes only read the
+     * tokens, the symbol database and the values, and they are deterministic.
+     * When no value has changed since a pass was last started, the pass would
+     * not change anything, and it is skipped.
+     */
+    class ValueFlowPassRunner {
+    public:
+        ValueFlowPassRunner(const TokenList *tokenlist, const Settings *settings, TimerResultsIntf *timerResults)
+            : mTokenList(tokenlist)
+            , mShowTime(timerResults ? settings->showtime : SHOWTIME_MODES::SHOWTIME_NONE)
+            , mTimerResults(timerResults)
+            , mTokens(mShowTime != SHOWTIME_MODES::SHOWTIME_NONE ? tokenlist->countTokens() : 0)
+            , mTimed(mShowTime != SHOWTIME_MODES::SHOWTIME_NONE || Timer::trace()) {
+        }
+
+        void run(const char name[], const std::function<void()> &pass) {
+            const std::map<std::string, std::size_t>::iterator it = mStartGeneration.find(name);
+            if (it != mStartGeneration.end() && it->second == mTokenList->valueGeneration())
+                return;
+            mStartGeneration[name] = mTokenList->valueGeneration();
+            if (!mTimed) {
+                pass();
+            } else {
+                Timer t(std::string("ValueFlow::") + name, mShowTime, mTimerResults);
+                t.setTokens(mTokens);
+                pass();
+            }
+        }
+
+        SHOWTIME_MODES showTime() const {
+            return mShowTime;
+        }
+
+        TimerResultsIntf *timerResults() const {
+            return mTimerResults;
+        }
+
+        std::size_t tokens() const {
+            return mTokens;
+        }
+
+        /** Are the passes timed, for --showtime or for the trace? */
+        bool timed() const {
+            return mTimed;
+        }
+
+    private:
+        const TokenList *mTokenList;
+        const SHOWTIME_MODES mShowTime;
+        TimerResultsIntf *mTimerResults;
+        /** Number of tokens, only counted when the passes are timed */
+        const std::size_t mTokens;
+        const bool mTimed;
+        /** Value generation of the token list when the passes were last started */
+        std::map<std::string, std::size_t> mStartGeneration;
+    };
+
+    /** Sets the budget of the forward analysis in the token list while ValueFlow runs */
+    class ForwardAnalysisBudgetSetter {
+    public:
+        ForwardAnalysisBudgetSetter(TokenList *tokenlist, ForwardAnalysisBudget *budget)
+            : mTokenList(tokenlist) {
+            mTokenList->setForwardAnalysisBudget(budget);
+        }
+
+        ~ForwardAnalysisBudgetSetter() {
+            mTokenList->setForwardAnalysisBudget(nullptr);
+        }
+
+    private:
+        TokenList *mTokenList;
+    };
+}
+
+static void reportForwardAnalysisBudget(TokenList *tokenlist, ErrorLogger *errorLogger, const Settings *settings, const ForwardAnalysisBudget &budget)
+{
+    if (!errorLogger || !settings->isEnabled(Settings::INFORMATION))
+        return;
+    if (budget.timeExceeded() && tokenlist->front()) {
+        const std::list<ErrorMessage::FileLocation> callstack(1, ErrorMessage::FileLocation(tokenlist->front(), tokenlist));
+        const ErrorMessage errmsg(callstack, tokenlist->getSourceFilePath(), Severity::information,
+                                  "ValueFlow analysis of the file took more than " + MathLib::toString(settings->maxValueFlowTime) + " seconds, the rest of the file is analyzed with less precision. Use --max-valueflow-time to change the limit.",
+                                  "valueFlowMaxTime", false);
+        errorLogger->reportErr(errmsg);
+    }
+    for (const Scope *scope : budget.exceededFunctions()) {
+        const std::list<ErrorMessage::FileLocation> callstack(1, ErrorMessage::FileLocation(scope->classDef, tokenlist));
+        const ErrorMessage errmsg(callstack, tokenlist->getSourceFilePath(), Severity::information,
+                                  "ValueFlow analysis of the function '" + scope->className + "' exceeded its budget, the rest of the function is analyzed with less precision. Use --max-valueflow-tokens and --max-valueflow-forks to change the limits.",
+                                  "valueFlowMaxBudget", false);
+        errorLogger->reportErr(errmsg);
+    }
+}
+
+void ValueFlow::setValues(TokenList *tokenlist, SymbolDatabase* symboldatabase, ErrorLogger *errorLogger, const Settings *settings, TimerResultsIntf *timerResults, unsigned int jobs)
 {
     for (Token *tok = tokenlist->front(); tok; tok = tok->next())
         tok->clearValueFlow();
 
-    valueFlowNumber(tokenlist);
-    valueFlowString(tokenlist);
-    valueFlowArray(tokenlist);
-    valueFlowUnknownFunctionReturn(tokenlist, settings);
-    valueFlowGlobalConstVar(tokenlist, settings);
-    valueFlowGlobalStaticVar(tokenlist, settings);
-    valueFlowPointerAlias(tokenlist);
-    valueFlowLifetime(tokenlist, symboldatabase, errorLogger, settings);
-    valueFlowBitAnd(tokenlist);
-    valueFlowSameExpressions(tokenlist);
-    valueFlowFwdAnalysis(tokenlist, settings);
-
+    ValueFlowPassRunner runner(tokenlist, settings, timerResults);
+    // The forward analysis is only charged when it has a limit
+    std::unique_ptr<ForwardAnalysisBudget> budget;
+    if (settings->maxValueFlowForks > 0 || settings->maxValueFlowTime > 0 || settings->maxValueFlowTokens > 0)
+        budget.reset(new ForwardAnalysisBudget(settings));
+    const ForwardAnalysisBudgetSetter budgetSetter(tokenlist, budget.get());
+
+#define VALUEFLOW_PASS(pass, ...) runner.run(#pass, [&]() { pass(__VA_ARGS__); })
+
+    VALUEFLOW_PASS(valueFlowNumber, tokenlist);
+    VALUEFLOW_PASS(valueFlowString, tokenlist);
+    VALUEFLOW_PASS(valueFlowArray, tokenlist);
+    VALUEFLOW_PASS(valueFlowUnknownFunctionReturn, tokenlist, settings);
+    VALUEFLOW_PASS(valueFlowGlobalConstVar, tokenlist, settings);
+    VALUEFLOW_PASS(valueFlowGlobalStaticVar, tokenlist, settings);
+    VALUEFLOW_PASS(valueFlowPointerAlias, tokenlist);
+    VALUEFLOW_PASS(valueFlowLifetime, tokenlist, symboldatabase, errorLogger, settings);
+    VALUEFLOW_PASS(valueFlowBitAnd, tokenlist);
+    VALUEFLOW_PASS(valueFlowSameExpressions, tokenlist);
+    VALUEFLOW_PASS(valueFlowFwdAnalysis, tokenlist, settings);
+
+    // Repeat the passes until no new values are found. The total is only
+    // recounted when some value has changed.
     std::size_t values = 0;
-    std::size_t n = 4;
-    while (n > 0 && values < getTotalValues(tokenlist)) {
-        values = getTotalValues(tokenlist);
-        valueFlowPointerAliasDeref(tokenlist);
-        valueFlowArrayBool(tokenlist);
-        valueFlowRightShift(tokenlist, settings);
-        valueFlowOppositeCondition(symboldatabase, settings);
-        valueFlowTerminatingCondition(tokenlist, symboldatabase, errorLogger, settings);
-        valueFlowBeforeCondition(tokenlist, symboldatabase, errorLogger, settings);
-        valueFlowAfterMove(tokenlist, symboldatabase, errorLogger, settings);
-        valueFlowAfterCondition(tokenlist, symboldatabase, errorLogger, settings);
-        valueFlowInferCondition(tokenlist, settings);
-        valueFlowAfterAssign(tokenlist, symboldatabase, errorLogger, settings);
-        valueFlowSwitchVariable(tokenlist, symboldatabase, errorLogger, settings);
-        valueFlowForLoop(tokenlist, symboldatabase, errorLogger, settings);
-        valueFlowSubFunction(tokenlist, symboldatabase, errorLogger, settings);
-        valueFlowFunctionReturn(tokenlist, errorLogger);
-        valueFlowLifetime(tokenlist, symboldatabase, errorLogger, settings);
-        valueFlowFunctionDefaultParameter(tokenlist, symboldatabase, errorLogger, settings);
-        valueFlowUninit(tokenlist, symboldatabase, errorLogger, settings);
+    std::size_t total = 0;
+    std::size_t totalGeneration = 0;
+    for (int iteration = 1; iteration <= 4; ++iteration) {
+        if (iteration == 1 || totalGeneration != tokenlist->valueGeneration()) {
+            totalGeneration = tokenlist->valueGeneration();
+            total = getTotalValues(tokenlist);
+        }
+        if (values >= total)
+            break;
+        values = total;
+        // Only the first iteration is done when the time budget is exceeded
+        if (iteration > 1 && budget && budget->checkTime())
+            break;
+
+        std::unique_ptr<Timer> iterationTimer;
+        if (runner.timed()) {
+            iterationTimer.reset(new Timer("ValueFlow::setValues iteration " + MathLib::toString(iteration), runner.showTime(), runner.timerResults()));
+            iterationTimer->setTokens(runner.tokens());
+        }
+
+        VALUEFLOW_PASS(valueFlowPointerAliasDeref, tokenlist);
+        VALUEFLOW_PASS(valueFlowArrayBool, tokenlist);
+        VALUEFLOW_PASS(valueFlowRightShift, tokenlist, settings);
+        VALUEFLOW_PASS(valueFlowOppositeCondition, symboldatabase, settings);
+        VALUEFLOW_PASS(valueFlowTerminatingCondition, tokenlist, symboldatabase, errorLogger, settings);
+        VALUEFLOW_PASS(valueFlowBeforeCondition, tokenlist, symboldatabase, errorLogger, settings);
+        VALUEFLOW_PASS(valueFlowAfterMove, tokenlist, symboldatabase, errorLogger, settings);
+        VALUEFLOW_PASS(valueFlowAfterCondition, tokenlist, symboldatabase, errorLogger, settings, jobs);
+        VALUEFLOW_PASS(valueFlowInferCondition, tokenlist, settings);
+        VALUEFLOW_PASS(valueFlowAfterAssign, tokenlist, symboldatabase, errorLogger, settings);
+        VALUEFLOW_PASS(valueFlowSwitchVariable, tokenlist, symboldatabase, errorLogger, settings);
+        VALUEFLOW_PASS(valueFlowForLoop, tokenlist, symboldatabase, errorLogger, settings);
+        VALUEFLOW_PASS(valueFlowSubFunction, tokenlist, symboldatabase, errorLogger, settings);
+        VALUEFLOW_PASS(valueFlowFunctionReturn, tokenlist, errorLogger);
+        VALUEFLOW_PASS(valueFlowLifetime, tokenlist, symboldatabase, errorLogger, settings);
+        VALUEFLOW_PASS(valueFlowFunctionDefaultParameter, tokenlist, symboldatabase, errorLogger, settings);
+        VALUEFLOW_PASS(valueFlowUninit, tokenlist, symboldatabase, errorLogger, settings);
         if (tokenlist->isCPP()) {
-            valueFlowSmartPointer(tokenlist, errorLogger, settings);
-            valueFlowIterators(tokenlist, settings);
-            valueFlowIteratorAfterCondition(tokenlist, symboldatabase, errorLogger, settings);
-            valueFlowIteratorInfer(tokenlist, settings);
-            valueFlowContainerSize(tokenlist, symboldatabase, errorLogger, settings);
-            valueFlowContainerAfterCondition(tokenlist, symboldatabase, errorLogger, settings);
+            VALUEFLOW_PASS(valueFlowSmartPointer, tokenlist, errorLogger, settings);
+            VALUEFLOW_PASS(valueFlowIterators, tokenlist, settings);
+            VALUEFLOW_PASS(valueFlowIteratorAfterCondition, tokenlist, symboldatabase, errorLogger, settings, jobs);
+            VALUEFLOW_PASS(valueFlowIteratorInfer, tokenlist, settings);
+            VALUEFLOW_PASS(valueFlowContainerSize, tokenlist, symboldatabase, errorLogger, settings, jobs);
+            VALUEFLOW_PASS(valueFlowContainerAfterCondition, tokenlist, symboldatabase, errorLogger, settings, jobs);
         }
-        valueFlowSafeFunctions(tokenlist, symboldatabase, errorLogger, settings);
-        n--;
+        VALUEFLOW_PASS(valueFlowSafeFunctions, tokenlist, symboldatabase, errorLogger, settings);
     }
 
-    valueFlowDynamicBufferSize(tokenlist, symboldatabase, errorLogger, settings);
+    VALUEFLOW_PASS(valueFlowDynamicBufferSize, tokenlist, symboldatabase, errorLogger, settings);
+
+#undef VALUEFLOW_PASS
+
+    if (budget)
+        reportForwardAnalysisBudget(tokenlist, errorLogger, settings, *budget);
 }
 
 
@@ -33,6 +33,7 @@
 class ErrorLogger;
 class Settings;
 class SymbolDatabase;
+class TimerResultsIntf;
 class Token;
 class TokenList;
 class ValueType;
@@ -151,6 +152,28 @@ namespace ValueFlow {
             return !(*this == rhs);
         }
 
+        /** Are all members equal? operator== ignores some of them. */
+        bool isSame(const Value &rhs) const {
+            return valueType == rhs.valueType &&
+                   bound == rhs.bound &&
+                   intvalue == rhs.intvalue &&
+                   tokvalue == rhs.tokvalue &&
+                   floatValue == rhs.floatValue &&
+                   moveKind == rhs.moveKind &&
+                   varvalue == rhs.varvalue &&
+                   condition == rhs.condition &&
+                   errorPath == rhs.errorPath &&
+                   varId == rhs.varId &&
+                   safe == rhs.safe &&
+                   conditional == rhs.conditional &&
+                   defaultArg == rhs.defaultArg &&
+                   indirect == rhs.indirect &&
+                   path == rhs.path &&
+                   lifetimeKind == rhs.lifetimeKind &&
+                   lifetimeScope == rhs.lifetimeScope &&
+                   valueKind == rhs.valueKind;
+        }
+
         void decreaseRange() {
             if (bound == Bound::Lower)
                 visitValue(increment{});
@@ -329,8 +352,9 @@ namespace ValueFlow {
     /// Constant folding of expression. This can be used before the full ValueFlow has been executed (ValueFlow::setValues).
     const ValueFlow::Value * valueFlowConstantFoldAST(Token *expr, const Settings *settings);
 
-    /// Perform valueflow analysis.
-    void setValues(TokenList *tokenlist, SymbolDatabase* symboldatabase, ErrorLogger *errorLogger, const Settings *settings);
+    /// Perform valueflow analysis. The passes are timed with timerResults when --showtime is given.
+    /// Some passes analyze the function scopes with up to jobs threads.
+    void setValues(TokenList *tokenlist, SymbolDatabase* symboldatabase, ErrorLogger *errorLogger, const Settings *settings, TimerResultsIntf *timerResults = nullptr, unsigned int jobs = 1);
 
     std::string eitherTheConditionIsRedundant(const Token *condition);
 
@@ -23,6 +23,7 @@
 #include "standards.h"
 #include "suppressions.h"
 #include "testsuite.h"
+#include "threadexecutor.h"
 #include "timer.h"
 
 #include <list>
@@ -89,6 +90,13 @@ private:
         TEST_CASE(errorExitcode);
         TEST_CASE(errorExitcodeMissing);
         TEST_CASE(errorExitcodeStr);
+#ifdef THREADING_MODEL_FORK
+        TEST_CASE(executorProcess);
+        TEST_CASE(executorThread);
+        TEST_CASE(executorInvalid);
+#endif
+        TEST_CASE(buildDirFormat);
+        TEST_CASE(buildDirFormatInvalid);
         TEST_CASE(exitcodeSuppressionsOld); // TODO: Create and test real suppression file
         TEST_CASE(exitcodeSuppressions);
         TEST_CASE(exitcodeSuppressionsNoFile);
@@ -98,10 +106,15 @@ private:
         TEST_CASE(jobs);
         TEST_CASE(jobsMissingCount);
         TEST_CASE(jobsInvalid);
+        TEST_CASE(configJobs);
+        TEST_CASE(configJobsInvalid);
         TEST_CASE(maxConfigs);
         TEST_CASE(maxConfigsMissingCount);
         TEST_CASE(maxConfigsInvalid);
         TEST_CASE(maxConfigsTooSmall);
+        TEST_CASE(maxValueFlow);
+        TEST_CASE(maxValueFlowInvalid);
+        TEST_CASE(maxValueFlowNegative);
         TEST_CASE(reportProgressTest); // "Test" suffix to avoid hiding the parent's reportProgress
         TEST_CASE(stdc99);
         TEST_CASE(stdcpp11);
@@ -125,6 +138,9 @@ private:
         TEST_CASE(xmlverinvalid);
         TEST_CASE(doc);
         TEST_CASE(showtime);
+        TEST_CASE(showtimeOutput);
+        TEST_CASE(showtimeOutputWithoutShowtime);
+        TEST_CASE(traceOutput);
         TEST_CASE(errorlist1);
         TEST_CASE(errorlistverbose1);
         TEST_CASE(errorlistverbose2);
@@ -585,6 +601,51 @@ private:
         ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv));
     }
 
+#ifdef THREADING_MODEL_FORK
+    void executorProcess() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--executor=process", "file.cpp"};
+        settings.executor = Settings::ExecutorType::Thread;
+        ASSERT(defParser.parseFromArgs(3, argv));
+        ASSERT(settings.executor == Settings::ExecutorType::Process);
+    }
+
+    void executorThread() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--executor=thread", "file.cpp"};
+        settings.executor = Settings::ExecutorType::Process;
+        ASSERT(defParser.parseFromArgs(3, argv));
+        ASSERT(settings.executor == Settings::ExecutorType::Thread);
+        settings.executor = Settings::ExecutorType::Process;
+    }
+
+    void executorInvalid() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--executor=fiber", "file.cpp"};
+        // Fails since there is no such executor
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv));
+    }
+#endif
+
+    void buildDirFormat() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--cppcheck-build-dir-format=binary", "file.cpp"};
+        settings.buildDirFormat = Settings::BuildDirFormat::XML;
+        ASSERT(defParser.parseFromArgs(3, argv));
+        ASSERT(settings.buildDirFormat == Settings::BuildDirFormat::Binary);
+
+        const char * const argv2[] = {"cppcheck", "--cppcheck-build-dir-format=xml", "file.cpp"};
+        ASSERT(defParser.parseFromArgs(3, argv2));
+        ASSERT(settings.buildDirFormat == Settings::BuildDirFormat::XML);
+    }
+
+    void buildDirFormatInvalid() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--cppcheck-build-dir-format=json", "file.cpp"};
+        // Fails since there is no such format
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv));
+    }
+
     void exitcodeSuppressionsOld() {
         // TODO: Fails since cannot open the file
         REDIRECT;
@@ -654,6 +715,22 @@ private:
         ASSERT_EQUALS(false, defParser.parseFromArgs(4, argv));
     }
 
+    void configJobs() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "-j4", "--config-jobs=2", "file.cpp"};
+        settings.configJobs = 0;
+        ASSERT(defParser.parseFromArgs(4, argv));
+        ASSERT_EQUALS(4, settings.jobs);
+        ASSERT_EQUALS(2, settings.configJobs);
+    }
+
+    void configJobsInvalid() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--config-jobs=e", "file.cpp"};
+        // Fails since invalid count given for --config-jobs=
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv));
+    }
+
     void maxConfigs() {
         REDIRECT;
         const char * const argv[] = {"cppcheck", "-f", "--max-configs=12", "file.cpp"};
@@ -685,6 +762,32 @@ private:
         ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv));
     }
 
+    void maxValueFlow() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--max-valueflow-forks=10", "--max-valueflow-time=5", "--max-valueflow-tokens=100000", "file.cpp"};
+        settings.maxValueFlowForks = 0;
+        settings.maxValueFlowTime = 0;
+        settings.maxValueFlowTokens = 0;
+        ASSERT(defParser.parseFromArgs(5, argv));
+        ASSERT_EQUALS(10, settings.maxValueFlowForks);
+        ASSERT_EQUALS(5, settings.maxValueFlowTime);
+        ASSERT_EQUALS(100000, settings.maxValueFlowTokens);
+    }
+
+    void maxValueFlowInvalid() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--max-valueflow-tokens=e", "file.cpp"};
+        // Fails since the limit is not a number
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv));
+    }
+
+    void maxValueFlowNegative() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--max-valueflow-time=-1", "file.cpp"};
+        // Fails since the limit must not be negative
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv));
+    }
+
     void reportProgressTest() {
         REDIRECT;
         const char * const argv[] = {"cppcheck", "--report-progress", "file.cpp"};
@@ -898,6 +1001,33 @@ private:
         ASSERT(settings.showtime == SHOWTIME_MODES::SHOWTIME_SUMMARY);
     }
 
+    void showtimeOutput() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--showtime=summary", "--showtime-output=times.json", "file.cpp"};
+        settings.showtimeOutput.clear();
+        ASSERT(defParser.parseFromArgs(4, argv));
+        ASSERT_EQUALS("times.json", settings.showtimeOutput);
+        settings.showtime = SHOWTIME_MODES::SHOWTIME_NONE;
+        settings.showtimeOutput.clear();
+    }
+
+    void showtimeOutputWithoutShowtime() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--showtime-output=times.csv", "file.cpp"};
+        settings.showtime = SHOWTIME_MODES::SHOWTIME_NONE;
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv));
+        settings.showtimeOutput.clear();
+    }
+
+    void traceOutput() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--trace-output=trace.json", "file.cpp"};
+        settings.traceOutput.clear();
+        ASSERT(defParser.parseFromArgs(3, argv));
+        ASSERT_EQUALS("trace.json", settings.traceOutput);
+        settings.traceOutput.clear();
+    }
+
     void errorlist1() {
         REDIRECT;
         const char * const argv[] = {"cppcheck", "--errorlist"};
@@ -16,15 +16,27 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "analyzerinfo.h"
 #include "check.h"
+#include "checkunusedfunctions.h"
 #include "cppcheck.h"
 #include "errorlogger.h"
+#include "settings.h"
 #include "testsuite.h"
 
+#include <simplecpp.h>
 #include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <list>
+#include <map>
 #include <string>
 
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 class TestCppcheck : public TestFixture {
 public:
@@ -33,6 +45,20 @@ public:
 
 private:
 
+    class ErrorLogger3 : public ErrorLogger {
+    public:
+        std::string output;
+
+        void reportOut(const std::string &outmsg) OVERRIDE {
+            output += outmsg + '\n';
+        }
+        void bughuntingReport(const std::string & /*str*/) OVERRIDE {}
+
+        void reportErr(const ErrorMessage &msg) OVERRIDE {
+            output += msg.toString(false) + '\n';
+        }
+    };
+
     class ErrorLogger2 : public ErrorLogger {
     public:
         std::list<std::string> id;
@@ -49,6 +75,12 @@ private:
         TEST_CASE(instancesSorted);
         TEST_CASE(classInfoFormat);
         TEST_CASE(getErrorMessages);
+        TEST_CASE(checkConfigurationsInParallel);
+        TEST_CASE(unusedFunctionInParallel);
+        TEST_CASE(purgeSamePreprocessedCode);
+        TEST_CASE(analyseWholeProgramInParallel);
+        TEST_CASE(buildDirFormat);
+        TEST_CASE(checkOriginalPath);
     }
 
     void instancesSorted() const {
@@ -103,6 +135,248 @@ private:
         ASSERT(foundPurgedConfiguration);
         ASSERT(foundTooManyConfigs);
     }
+
+    static std::string checkConfigurations(unsigned int configJobs) {
+        const char code[] = "void f() { int a[2]; a[2] = 0; }\n"
+                            "#ifdef A\n"
+                            "void fa() { int *p = 0; *p = 0; }\n"
+                            "#endif\n"
+                            "#ifdef B\n"
+                            "int fb() { return 1 / 0; }\n"
+                            "#endif\n"
+                            "#ifdef C\n"
+                            "#endif\n"
+                            "#ifdef D\n"
+                            "#error D\n"
+                            "#endif\n"
+                            "#ifdef E\n"
+                            "void fe() { char c[1]; c[1] = 0; }\n"
+                            "#endif\n";
+        ErrorLogger3 errorLogger;
+        CppCheck cppCheck(errorLogger, true, nullptr);
+        cppCheck.settings().configJobs = configJobs;
+        cppCheck.settings().debugwarnings = true;
+        cppCheck.check("test.c", code);
+        return errorLogger.output;
+    }
+
+    void checkConfigurationsInParallel() const {
+        const std::string output = checkConfigurations(1);
+        ASSERT_EQUALS(output, checkConfigurations(4));
+        ASSERT_EQUALS(output, checkConfigurations(2));
+
+        ASSERT(output.find("Checking test.c: A...") < output.find("Checking test.c: B..."));
+        ASSERT(output.find("Checking test.c: B...") < output.find("Checking test.c: C..."));
+        ASSERT(output.find("Checking test.c: C...") < output.find("Checking test.c: E..."));
+        ASSERT(output.find("[test.c:3]: (error) Null pointer dereference: p") < output.find("Checking test.c: B..."));
+        ASSERT(output.find("The configuration 'C' was not checked because its code equals another one.") != std::string::npos);
+        ASSERT_EQUALS(std::string::npos, output.find("Checking test.c: D..."));
+        ASSERT(output.find("Checking test.c: E...") < output.find("[test.c:14]: (error) Array 'c[1]' accessed at index 1, which is out of bounds."));
+    }
+
+    static std::string checkUnusedFunctions(unsigned int configJobs) {
+        const char code[] = "static void used() {}\n"
+                            "void unused() {}\n"
+                            "#ifdef A\n"
+                            "void fa() { used(); }\n"
+                            "#endif\n"
+                            "#ifdef B\n"
+                            "void fb() { unusedB(); }\n"
+                            "void unusedB() {}\n"
+                            "#endif\n"
+                            "#ifdef C\n"
+                            "void fc() { fa(); }\n"
+                            "#endif\n"
+                            "int main() { fb(); fc(); return 0; }\n";
+        ErrorLogger3 errorLogger;
+        CheckUnusedFunctions::clear();
+        CppCheck cppCheck(errorLogger, true, nullptr);
+        cppCheck.settings().configJobs = configJobs;
+        cppCheck.settings().quiet = true;
+        cppCheck.settings().addEnabled("unusedFunction");
+        cppCheck.check("test.c", code);
+        cppCheck.analyseWholeProgram();
+        CheckUnusedFunctions::clear();
+        return errorLogger.output;
+    }
+
+    void unusedFunctionInParallel() const {
+        const std::string output = checkUnusedFunctions(1);
+        ASSERT_EQUALS("[test.c:2]: (style) The function 'unused' is never used.\n", output);
+        for (int i = 0; i < 10; ++i) {
+            ASSERT_EQUALS(output, checkUnusedFunctions(4));
+            ASSERT_EQUALS(output, checkUnusedFunctions(2));
+        }
+    }
+
+    void purgeSamePreprocessedCode() const {
+        const char code[] = "int x;\n"
+                            "#ifdef A\n"
+                            "#endif\n"
+                            "#ifdef B\n"
+                            "int y;\n"
+                            "#else\n"
+                            "int y;\n"
+                            "#endif\n";
+        ErrorLogger3 errorLogger;
+        CppCheck cppCheck(errorLogger, true, nullptr);
+        cppCheck.settings().debugwarnings = true;
+        cppCheck.check("test.c", code);
+        const std::string &output = errorLogger.output;
+
+        // A is skipped before it is tokenized
+        ASSERT(output.find("The configuration 'A' was not checked because its code equals another one.") != std::string::npos);
+        ASSERT(output.find("The configuration 'A' was not tokenized because its preprocessed code equals the configuration ''. 6 tokens were not simplified and checked.") != std::string::npos);
+
+        // The line numbers of B differ, it is skipped after it is simplified
+        ASSERT(output.find("The configuration 'B' was not checked because its code equals another one.") != std::string::npos);
+        ASSERT_EQUALS(std::string::npos, output.find("The configuration 'B' was not tokenized"));
+    }
+
+    static std::string analyseWholeProgram(unsigned int jobs) {
+        ErrorLogger3 errorLogger;
+        CppCheck cppCheck(errorLogger, true, nullptr);
+        cppCheck.settings().jobs = jobs;
+        cppCheck.settings().addEnabled("unusedFunction");
+        cppCheck.analyseWholeProgram(".", std::map<std::string, std::size_t>());
+        return errorLogger.output;
+    }
+
+    void analyseWholeProgramInParallel() const {
+        {
+            std::ofstream fout("files.txt");
+            fout << "wholeprogram1.a1::a.c\n"
+                 << "wholeprogram2.a1::b.c\n";
+        }
+        {
+            std::ofstream fout("wholeprogram1.a1");
+            fout << "<?xml version=\"1.0\"?>\n"
+                 << "<analyzerinfo checksum=\"1\">\n"
+                 << "  <FileInfo check=\"Null pointer\">\n"
+                 << "    <unsafe-usage my-id=\"a.c:1:6\" my-argnr=\"1\" my-argname=\"p\" file=\"a.c\" line=\"1\" col=\"19\" value=\"0\"/>\n"
+                 << "  </FileInfo>\n"
+                 << "  <FileInfo check=\"CheckUnusedFunctions\">\n"
+                 << "    <functiondecl functionName=\"f\" lineNumber=\"1\"/>\n"
+                 << "    <functiondecl functionName=\"unused\" lineNumber=\"2\"/>\n"
+                 << "  </FileInfo>\n"
+                 << "</analyzerinfo>\n";
+        }
+        {
+            std::ofstream fout("wholeprogram2.a1");
+            fout << "<?xml version=\"1.0\"?>\n"
+                 << "<analyzerinfo checksum=\"2\">\n"
+                 << "  <FileInfo check=\"ctu\">\n"
+                 << "    <function-call call-id=\"a.c:1:6\" call-funcname=\"f\" call-argnr=\"1\" file=\"b.c\" line=\"2\" col=\"15\" call-argexpr=\"0\" call-argvaluetype=\"0\" call-argvalue=\"0\"/>\n"
+                 << "  </FileInfo>\n"
+                 << "  <FileInfo check=\"CheckUnusedFunctions\">\n"
+                 << "    <functiondecl functionName=\"main\" lineNumber=\"2\"/>\n"
+                 << "    <functioncall functionName=\"f\"/>\n"
+                 << "  </FileInfo>\n"
+                 << "</analyzerinfo>\n";
+        }
+
+        const std::string output = analyseWholeProgram(1);
+        const std::string output4 = analyseWholeProgram(4);
+        std::remove("files.txt");
+        std::remove("wholeprogram1.a1");
+        std::remove("wholeprogram2.a1");
+
+        ASSERT_EQUALS(output, output4);
+        ASSERT_EQUALS("[a.c:2]: (style) The function 'unused' is never used.\n"
+                      "[b.c:2] -> [a.c:1]: (error) Null pointer dereference: p\n", output);
+    }
+
+    static std::string checkBuildDir(Settings::BuildDirFormat format) {
+        const char codeA[] = "#include \"builddir.h\"\n"
+                             "void f(int *p) { *p = 0; }\n"
+                             "void unused() { int a[2]; a[2] = 0; }\n";
+        const char codeB[] = "#include \"builddir.h\"\n"
+                             "int main() { f(0); return 0; }\n";
+        ErrorLogger3 errorLogger;
+        CppCheck cppCheck(errorLogger, true, nullptr);
+        cppCheck.settings().buildDir = ".";
+        cppCheck.settings().buildDirFormat = format;
+        cppCheck.settings().quiet = true;
+        cppCheck.settings().addEnabled("unusedFunction");
+        cppCheck.check("builddir_a.c", codeA);
+        cppCheck.check("builddir_b.c", codeB);
+        // The results of the first run are reused
+        cppCheck.check("builddir_a.c", codeA);
+        cppCheck.analyseWholeProgram(".", std::map<std::string, std::size_t>());
+        return errorLogger.output;
+    }
+
+    void buildDirFormat() const {
+        {
+            std::ofstream fout("builddir.h");
+            fout << "void f(int *p);\n";
+        }
+        {
+            std::ofstream fout("files.txt");
+            fout << "builddir_a.a1::builddir_a.c\n"
+                 << "builddir_b.a1::builddir_b.c\n";
+        }
+
+        const std::string xml = checkBuildDir(Settings::BuildDirFormat::XML);
+        std::string data;
+        ASSERT(AnalyzerInformation::loadFile("builddir_a.a1", data));
+        ASSERT_EQUALS(false, AnalyzerInformation::isBinaryFile(data));
+
+        // The XML files are not reused
+        const std::string binary = checkBuildDir(Settings::BuildDirFormat::Binary);
+        ASSERT(AnalyzerInformation::loadFile("builddir_a.a1", data));
+        ASSERT_EQUALS(true, AnalyzerInformation::isBinaryFile(data));
+
+        // A truncated file is not reused
+        {
+            std::ofstream fout("builddir_a.a1", std::ios::binary);
+            fout.write(data.data(), data.size() - 1);
+        }
+        const std::string truncated = checkBuildDir(Settings::BuildDirFormat::Binary);
+
+        std::remove("builddir.h");
+        std::remove(simplecpp::HeaderCache::cacheFileName(".", "builddir.h").c_str());
+        std::remove("files.txt");
+        std::remove("builddir_a.a1");
+        std::remove("builddir_b.a1");
+
+        ASSERT_EQUALS("[builddir_a.c:3]: (error) Array 'a[2]' accessed at index 2, which is out of bounds.\n"
+                      "[builddir_a.c:3]: (error) Array 'a[2]' accessed at index 2, which is out of bounds.\n"
+                      "[builddir_a.c:3]: (style) The function 'unused' is never used.\n"
+                      "[builddir_b.c:2] -> [builddir_a.c:2]: (error) Null pointer dereference: p\n", xml);
+        ASSERT_EQUALS(xml, binary);
+        ASSERT_EQUALS(xml, truncated);
+    }
+
+    void checkOriginalPath() const {
+#ifndef _WIN32
+        // link points to real/sub, so link/../a.c is real/a.c. The simplified
+        // path a.c is only used in the results.
+        char dir[] = "/tmp/cppcheck-testcppcheck-XXXXXX";
+        ASSERT(mkdtemp(dir) != nullptr);
+        const std::string base(dir);
+        ASSERT_EQUALS(0, mkdir((base + "/real").c_str(), 0700));
+        ASSERT_EQUALS(0, mkdir((base + "/real/sub").c_str(), 0700));
+        ASSERT_EQUALS(0, symlink("real/sub", (base + "/link").c_str()));
+        {
+            std::ofstream fout(base + "/real/a.c");
+            fout << "void f() { int a[2]; a[2] = 0; }\n";
+        }
+
+        ErrorLogger3 errorLogger;
+        CppCheck cppCheck(errorLogger, true, nullptr);
+        cppCheck.settings().quiet = true;
+        cppCheck.check(base + "/link/../a.c");
+
+        std::remove((base + "/real/a.c").c_str());
+        std::remove((base + "/link").c_str());
+        rmdir((base + "/real/sub").c_str());
+        rmdir((base + "/real").c_str());
+        rmdir(base.c_str());
+
+        ASSERT_EQUALS("[" + base + "/a.c:1]: (error) Array 'a[2]' accessed at index 2, which is out of bounds.\n", errorLogger.output);
+#endif
+    }
 };
 
 REGISTER_TEST(TestCppcheck)
@@ -58,6 +58,9 @@ private:
         TEST_CASE(DeserializeInvalidInput);
         TEST_CASE(SerializeSanitize);
         TEST_CASE(SerializeFileLocation);
+        TEST_CASE(SerializeBinary);
+        TEST_CASE(DeserializeBinaryTruncated);
+        TEST_CASE(ErrorMessageSetUnique);
 
         TEST_CASE(suppressUnmatchedSuppressions);
     }
@@ -310,6 +313,86 @@ private:
         ASSERT_EQUALS("abcd:/,", msg2.callStack.front().getinfo());
     }
 
+    void SerializeBinary() const {
+        ErrorMessage::FileLocation loc1(":/,;", 654, 33);
+        loc1.setfile("[]:;,()");
+        loc1.setinfo("abcd:/,");
+        ErrorMessage::FileLocation loc2("file.c", -1, 0);
+
+        std::list<ErrorMessage::FileLocation> locs{loc1, loc2};
+
+        ErrorMessage msg(locs, emptyString, Severity::warning, std::string("Illegal character in \"foo\001bar\""), "errorId", CWE(398U), true);
+        msg.hash = 1234;
+
+        // Two messages in one buffer
+        std::string data;
+        msg.serializeBinary(data);
+        msg.serializeBinary(data);
+
+        const char *pos = data.data();
+        const char * const end = pos + data.size();
+        for (int i = 0; i < 2; ++i) {
+            ErrorMessage msg2;
+            ASSERT_EQUALS(true, msg2.deserializeBinary(pos, end));
+            ASSERT_EQUALS("errorId", msg2.id);
+            ASSERT_EQUALS(Severity::warning, msg2.severity);
+            ASSERT_EQUALS(398U, msg2.cwe.id);
+            ASSERT_EQUALS(1234U, msg2.hash);
+            ASSERT_EQUALS(true, msg2.inconclusive);
+            ASSERT_EQUALS("Illegal character in \"foo\\001bar\"", msg2.shortMessage());
+            ASSERT_EQUALS("Illegal character in \"foo\\001bar\"", msg2.verboseMessage());
+            ASSERT_EQUALS(2U, msg2.callStack.size());
+            ASSERT_EQUALS("[]:;,()", msg2.callStack.front().getfile(false));
+            ASSERT_EQUALS(":/,;", msg2.callStack.front().getOrigFile(false));
+            ASSERT_EQUALS(654, msg2.callStack.front().line);
+            ASSERT_EQUALS(33, msg2.callStack.front().column);
+            ASSERT_EQUALS("abcd:/,", msg2.callStack.front().getinfo());
+            ASSERT_EQUALS("file.c", msg2.callStack.back().getfile(false));
+            ASSERT_EQUALS(-1, msg2.callStack.back().line);
+        }
+        ASSERT(pos == end);
+    }
+
+    void DeserializeBinaryTruncated() const {
+        std::list<ErrorMessage::FileLocation> locs{ErrorMessage::FileLocation("file.c", 1, 2)};
+        ErrorMessage msg(locs, emptyString, Severity::error, "Programming error", "errorId", false);
+
+        std::string data;
+        msg.serializeBinary(data);
+        for (std::string::size_type len = 0; len < data.size(); ++len) {
+            const char *pos = data.data();
+            ErrorMessage msg2;
+            ASSERT_EQUALS(false, msg2.deserializeBinary(pos, data.data() + len));
+        }
+    }
+
+    void ErrorMessageSetUnique() const {
+        std::list<ErrorMessage::FileLocation> locs{fooCpp5, barCpp8};
+        const ErrorMessage msg(locs, emptyString, Severity::error, "Programming error.\nVerbose error", "errorId", false);
+
+        ErrorMessageSet messages;
+        ASSERT_EQUALS(false, messages.contains(msg, false));
+        ASSERT_EQUALS(true, messages.insert(msg, false));
+        ASSERT_EQUALS(true, messages.contains(msg, false));
+        ASSERT_EQUALS(false, messages.contains(msg, true));
+        ASSERT_EQUALS(false, messages.insert(msg, false));
+        ASSERT_EQUALS(false, messages.insert(ErrorMessage(locs, emptyString, Severity::error, "Programming error.\nOther verbose error", "errorId", false), false));
+        ASSERT_EQUALS(true, messages.insert(msg, true));
+        ASSERT_EQUALS(true, messages.insert(ErrorMessage(locs, emptyString, Severity::error, "Programming error.\nVerbose error", "otherId", false), false));
+        ASSERT_EQUALS(true, messages.insert(ErrorMessage(locs, emptyString, Severity::warning, "Programming error.\nVerbose error", "errorId", false), false));
+        ASSERT_EQUALS(true, messages.insert(ErrorMessage(locs, emptyString, Severity::error, "Programming error.\nVerbose error", "errorId", true), false));
+
+        // The column is not part of the key
+        std::list<ErrorMessage::FileLocation> locs2{fooCpp5, ErrorMessage::FileLocation("bar.cpp", 8, 3)};
+        ASSERT_EQUALS(false, messages.insert(ErrorMessage(locs2, emptyString, Severity::error, "Programming error.\nVerbose error", "errorId", false), false));
+        std::list<ErrorMessage::FileLocation> locs3{fooCpp5, ErrorMessage::FileLocation("bar.cpp", 9, 1)};
+        ASSERT_EQUALS(true, messages.insert(ErrorMessage(locs3, emptyString, Severity::error, "Programming error.\nVerbose error", "errorId", false), false));
+
+        ASSERT_EQUALS(6U, messages.size());
+        messages.clear();
+        ASSERT_EQUALS(true, messages.insert(msg, false));
+    }
+
     void suppressUnmatchedSuppressions() {
         std::list<Suppressions::Suppression> suppressions;
 
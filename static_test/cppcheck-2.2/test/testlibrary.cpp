@@ -62,7 +62,9 @@ private:
         TEST_CASE(memory3);
         TEST_CASE(resource);
         TEST_CASE(podtype);
+        TEST_CASE(usedDefines);
         TEST_CASE(container);
+        TEST_CASE(detectContainer);
         TEST_CASE(version);
         TEST_CASE(loadLibErrors);
     }
@@ -708,6 +710,36 @@ private:
         ASSERT_EQUALS(library.allocId("CreateX"), library.deallocId("DeleteX"));
     }
 
+    void usedDefines() const {
+        const char xmldata[] = "<?xml version=\"1.0\"?>\n"
+                               "<def>\n"
+                               "  <define name=\"A\" value=\"B + 1\"/>\n"
+                               "  <define name=\"B\" value=\"2\"/>\n"
+                               "  <define name=\"C(x)\" value=\"(x + A)\"/>\n"
+                               "  <define name=\"D\" value=\"0x1234\"/>\n"
+                               "  <define name=\"E(a,b)\" value=\"a ## b\"/>\n"
+                               "</def>";
+
+        Library library;
+        ASSERT_EQUALS(true, Library::OK == (readLibrary(library, xmldata)).errorcode);
+
+        ASSERT_EQUALS(true, library.isDefine("C"));
+        ASSERT_EQUALS(false, library.isDefine("x"));
+
+        const std::vector<std::size_t> none;
+        const std::vector<std::size_t> b{1};
+        const std::vector<std::size_t> ab{0, 1};
+        const std::vector<std::size_t> abc{0, 1, 2};
+        const std::vector<std::size_t> d{3};
+        const std::vector<std::size_t> all{0, 1, 2, 3, 4};
+        ASSERT(none == library.getUsedDefines({"x", "f"}));
+        ASSERT(b == library.getUsedDefines({"B"}));
+        ASSERT(ab == library.getUsedDefines({"A"}));
+        ASSERT(abc == library.getUsedDefines({"C"}));
+        ASSERT(d == library.getUsedDefines({"D"}));
+        ASSERT(all == library.getUsedDefines({"E"}));
+    }
+
     void podtype() const {
         {
             const char xmldata[] = "<?xml version=\"1.0\"?>\n"
@@ -841,6 +873,29 @@ private:
         ASSERT_EQUALS(C.arrayLike_indexOp, true);
     }
 
+    void detectContainer() const {
+        const char xmldata[] = "<?xml version=\"1.0\"?>\n"
+                               "<def>\n"
+                               "  <container id=\"A\" startPattern=\"std :: A &lt;\" endPattern=\"&gt; !!::\"/>\n"
+                               "  <container id=\"B\" startPattern=\"%name% :: B &lt;\"/>\n"
+                               "  <container id=\"C\" startPattern=\"std :: B &lt;\" endPattern=\"&gt; !!::\"/>\n"
+                               "</def>";
+
+        Library library;
+        ASSERT_EQUALS(true, Library::OK == (readLibrary(library, xmldata)).errorcode);
+
+        const char * const code[] = { "std :: A < int > x ;", "std :: B < int > x ;", "foo :: B < int > x ;", "std :: D < int > x ;" };
+        const Library::Container * const expected[] = { &library.containers["A"], &library.containers["B"], &library.containers["B"], nullptr };
+        for (int i = 0; i < 4; ++i) {
+            TokenList tokenList(nullptr);
+            std::istringstream istr(code[i]);
+            tokenList.createTokens(istr);
+            Token::createMutualLinks(tokenList.front()->tokAt(3), tokenList.front()->tokAt(5));
+
+            ASSERT(library.detectContainer(tokenList.front()) == expected[i]);
+        }
+    }
+
     void version() const {
         {
             const char xmldata [] = "<?xml version=\"1.0\"?>\n"
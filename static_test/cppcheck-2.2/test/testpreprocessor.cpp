@@ -26,7 +26,9 @@
 #include "testsuite.h"
 
 #include <simplecpp.h>
+#include <cstdio>
 #include <cstring>
+#include <fstream>
 #include <list>
 #include <map>
 #include <set>
@@ -246,6 +248,14 @@ private:
         TEST_CASE(testDirectiveIncludeTypes);
         TEST_CASE(testDirectiveIncludeLocations);
         TEST_CASE(testDirectiveIncludeComments);
+
+        TEST_CASE(headerCache);
+        TEST_CASE(headerCacheLimit);
+        TEST_CASE(tokenizeBuffer);
+        TEST_CASE(tokenizeFile);
+
+        TEST_CASE(libraryDefines);
+        TEST_CASE(libraryDefinesPaste);
     }
 
     void preprocess(const char* code, std::map<std::string, std::string>& actual, const char filename[] = "file.c") {
@@ -2362,6 +2372,227 @@ private:
         preprocessor.dump(ostr);
         ASSERT_EQUALS(dumpdata, ostr.str());
     }
+
+    static std::string loadHeader(const char code[], simplecpp::HeaderCache *headerCache, std::size_t *outputs = nullptr) {
+        std::vector<std::string> files;
+        std::istringstream istr(code);
+        const simplecpp::TokenList rawtokens(istr, files, "test.c");
+        simplecpp::OutputList outputList;
+        std::map<std::string, simplecpp::TokenList *> filedata = simplecpp::load(rawtokens, files, simplecpp::DUI(), &outputList, headerCache);
+        std::string ret;
+        for (std::map<std::string, simplecpp::TokenList *>::const_iterator it = filedata.begin(); it != filedata.end(); ++it) {
+            for (const simplecpp::Token *tok = it->second->cfront(); tok; tok = tok->next)
+                ret += tok->location.file() + ':' + MathLib::toString(tok->location.line) + ':' + MathLib::toString(tok->location.col) + ' ' + tok->str() + '\n';
+        }
+        simplecpp::cleanup(filedata);
+        if (outputs)
+            *outputs = outputList.size();
+        return ret;
+    }
+
+    void headerCache() {
+        const char code[] = "#include \"headercache1.h\"\n"
+                            "#include \"headercache2.h\"\n";
+        {
+            std::ofstream fout("headercache1.h");
+            fout << "#line 10 \"other.h\"\n"
+                 << "int a;\n";
+        }
+        {
+            std::ofstream fout("headercache2.h");
+            fout << "int b; \xff\n";
+        }
+
+        simplecpp::HeaderCache headerCache;
+        std::size_t outputs[4] = {0};
+        const std::string expected = loadHeader(code, nullptr, &outputs[0]);
+        const std::string cached1 = loadHeader(code, &headerCache, &outputs[1]);
+        const std::string cached2 = loadHeader(code, &headerCache, &outputs[2]);
+
+        // The header is tokenized again when it is changed
+        {
+            std::ofstream fout("headercache2.h");
+            fout << "int c;\n";
+        }
+        const std::string changed = loadHeader(code, &headerCache);
+        const std::string expectedChanged = loadHeader(code, nullptr);
+
+        // Tokens that are stored in the directory are used by another cache
+        simplecpp::HeaderCache headerCache1;
+        headerCache1.setDirectory(".");
+        const std::string stored = loadHeader(code, &headerCache1);
+        simplecpp::HeaderCache headerCache2;
+        headerCache2.setDirectory(".");
+        std::ifstream storedFile(simplecpp::HeaderCache::cacheFileName(".", "headercache2.h"));
+        const bool isStored = storedFile.is_open();
+        storedFile.close();
+        const std::string loaded = loadHeader(code, &headerCache2, &outputs[3]);
+
+        std::remove("headercache1.h");
+        std::remove("headercache2.h");
+        std::remove(simplecpp::HeaderCache::cacheFileName(".", "headercache1.h").c_str());
+        std::remove(simplecpp::HeaderCache::cacheFileName(".", "headercache2.h").c_str());
+
+        ASSERT(expected.find("other.h:10:1 int") != std::string::npos);
+        ASSERT_EQUALS(expected, cached1);
+        ASSERT_EQUALS(expected, cached2);
+        ASSERT_EQUALS(1U, outputs[0]);
+        ASSERT_EQUALS(outputs[0], outputs[1]);
+        ASSERT_EQUALS(outputs[0], outputs[2]);
+        ASSERT(changed.find(" c\n") != std::string::npos);
+        ASSERT_EQUALS(expectedChanged, changed);
+        ASSERT_EQUALS(true, isStored);
+        ASSERT_EQUALS(changed, stored);
+        ASSERT_EQUALS(changed, loaded);
+        ASSERT_EQUALS(0U, outputs[3]);
+    }
+
+    void headerCacheLimit() {
+        const char code[] = "#include \"headercache1.h\"\n"
+                            "#include \"headercache2.h\"\n";
+        {
+            std::ofstream fout("headercache1.h");
+            fout << "int a;\n";
+        }
+        {
+            std::ofstream fout("headercache2.h");
+            fout << "int b;\n";
+        }
+
+        // The least recently used header is removed when there are too many tokens
+        simplecpp::HeaderCache headerCache;
+        headerCache.setMaxTokens(5);
+        const std::string expected = loadHeader(code, nullptr);
+        const std::string limited = loadHeader(code, &headerCache);
+        const std::size_t limitedCount = headerCache.tokenCount();
+
+        headerCache.setMaxTokens(100);
+        const std::string unlimited = loadHeader(code, &headerCache);
+        const std::size_t unlimitedCount = headerCache.tokenCount();
+        headerCache.setMaxTokens(3);
+        const std::size_t shrunkCount = headerCache.tokenCount();
+        headerCache.clear();
+        const std::size_t clearedCount = headerCache.tokenCount();
+
+        std::remove("headercache1.h");
+        std::remove("headercache2.h");
+
+        ASSERT_EQUALS(expected, limited);
+        ASSERT_EQUALS(expected, unlimited);
+        ASSERT_EQUALS(3U, limitedCount);
+        ASSERT_EQUALS(6U, unlimitedCount);
+        ASSERT_EQUALS(3U, shrunkCount);
+        ASSERT_EQUALS(0U, clearedCount);
+    }
+
+    static std::string tokenListToString(const simplecpp::TokenList &tokens, const simplecpp::OutputList &outputList) {
+        std::string ret;
+        for (const simplecpp::Token *tok = tokens.cfront(); tok; tok = tok->next)
+            ret += tok->location.file() + ':' + MathLib::toString(tok->location.line) + ':' + MathLib::toString(tok->location.col) + ' ' + tok->str() + '\n';
+        for (const simplecpp::Output &output : outputList)
+            ret += MathLib::toString(output.type) + ' ' + MathLib::toString(output.location.line) + ' ' + output.msg + '\n';
+        return ret;
+    }
+
+    void tokenizeBuffer() {
+        // Tokenizing a buffer gives the same result as tokenizing a stream
+        const std::string code[] = {
+            "",
+            "x",
+            "int a;\n",
+            "int a;\r\nint b;\rint c;\r\n",
+            "\xef\xbb\xbfint a;\n",
+            "\xef\xbbint a;\n",
+            std::string("\xfe\xff\0i\0n\0t\0 \0a\0;\0\r\0\n\0b", 19),
+            std::string("\xff\xfei\0n\0t\0 \0a\0;\0\r\0\n\0b\0", 20),
+            "#define A(x) \\\n  x + \\\r\n  1\nA(2)",
+            "// comment \\\n still comment\nint a; /* block\n comment */ int b; // end",
+            "/* unterminated",
+            "const char *s = \"abc\\\"def\"; char c = '\\'';",
+            "const char *s = \"unterminated\n",
+            "R\"delim(raw \" string)delim\" R\"(raw)\" u8R\"(x)\"",
+            "R\"delim(unterminated",
+            "#include <header.h>\n#include <header.h",
+            "1'000'000 0x1p-3 .5e+2 a\\",
+            "\x80 int a;\n",
+            "a\\"
+        };
+        for (const std::string &c : code) {
+            std::vector<std::string> files1, files2;
+            simplecpp::OutputList outputList1, outputList2;
+            std::istringstream istr(c);
+            const simplecpp::TokenList tokens1(istr, files1, "test.c", &outputList1);
+            const simplecpp::TokenList tokens2(c.data(), c.size(), files2, "test.c", &outputList2);
+            ASSERT_EQUALS(tokenListToString(tokens1, outputList1), tokenListToString(tokens2, outputList2));
+        }
+    }
+
+    void tokenizeFile() {
+        const char code[] = "#ifdef A\nint a;\r\n#endif\nint b; // comment\n";
+        {
+            std::ofstream fout("tokenizefile.c", std::ios::binary);
+            fout << code;
+        }
+        std::vector<std::string> files1, files2, files3;
+        simplecpp::OutputList outputList1, outputList2, outputList3;
+        std::istringstream istr(code);
+        const simplecpp::TokenList tokens1(istr, files1, "tokenizefile.c", &outputList1);
+        const simplecpp::TokenList tokens2("tokenizefile.c", files2, &outputList2);
+        std::remove("tokenizefile.c");
+        const simplecpp::TokenList tokens3("tokenizefile.c", files3, &outputList3);
+
+        ASSERT_EQUALS(tokenListToString(tokens1, outputList1), tokenListToString(tokens2, outputList2));
+        ASSERT_EQUALS(1U, files2.size());
+        ASSERT_EQUALS(true, tokens3.empty());
+        ASSERT_EQUALS(1U, files3.size());
+    }
+
+    void libraryDefines() {
+        // Only the library defines that the code uses are given to simplecpp
+        const char xmldata[] = "<?xml version=\"1.0\"?>\n"
+                               "<def>\n"
+                               "  <define name=\"A\" value=\"B + 1\"/>\n"
+                               "  <define name=\"B\" value=\"2\"/>\n"
+                               "  <define name=\"CD\" value=\"3\"/>\n"
+                               "</def>";
+        Settings settings;
+        ASSERT(settings.library.loadxmldata(xmldata, sizeof(xmldata)));
+        Preprocessor preprocessor(settings, this);
+
+        const char code1[] = "x = A ;";
+        std::vector<std::string> files1;
+        std::istringstream istr1(code1);
+        const simplecpp::TokenList tokens1(istr1, files1, "test.c");
+        ASSERT_EQUALS("x = $2 $+ $1 ;", preprocessor.getcode(tokens1, "", files1, false));
+
+        const char code2[] = "#define CAT(a, b) a ## b\n"
+                             "x = CAT(C, D) ;";
+        std::vector<std::string> files2;
+        std::istringstream istr2(code2);
+        const simplecpp::TokenList tokens2(istr2, files2, "test.c");
+        ASSERT_EQUALS("\nx = $3 ;", preprocessor.getcode(tokens2, "", files2, false));
+    }
+
+    void libraryDefinesPaste() {
+        // A used library define pastes tokens, so all library defines are given to simplecpp
+        const char xmldata[] = "<?xml version=\"1.0\"?>\n"
+                               "<def>\n"
+                               "  <define name=\"MK(x)\" value=\"x ## _T\"/>\n"
+                               "  <define name=\"A_T\" value=\"4\"/>\n"
+                               "  <define name=\"B\" value=\"5\"/>\n"
+                               "</def>";
+        Settings settings;
+        ASSERT(settings.library.loadxmldata(xmldata, sizeof(xmldata)));
+        ASSERT_EQUALS(3U, settings.library.getUsedDefines(std::set<std::string> {"MK"}).size());
+        ASSERT_EQUALS(1U, settings.library.getUsedDefines(std::set<std::string> {"B"}).size());
+        Preprocessor preprocessor(settings, this);
+
+        const char code[] = "x = MK(A) ;";
+        std::vector<std::string> files;
+        std::istringstream istr(code);
+        const simplecpp::TokenList tokens(istr, files, "test.c");
+        ASSERT_EQUALS("x = $4 ;", preprocessor.getcode(tokens, "", files, false));
+    }
 };
 
 REGISTER_TEST(TestPreprocessor)
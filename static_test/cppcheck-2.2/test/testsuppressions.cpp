@@ -48,6 +48,7 @@ private:
         TEST_CASE(suppressionsPathSeparator);
         TEST_CASE(suppressionsLine0);
         TEST_CASE(suppressionsFileComment);
+        TEST_CASE(suppressionsMatchOrder);
 
         TEST_CASE(inlinesuppress);
         TEST_CASE(inlinesuppress_symbolname);
@@ -483,6 +484,39 @@ private:
         ASSERT_EQUALS(true, suppressions.isSuppressed(errorMessage("syntaxError", "test.cpp", 0)));
     }
 
+    void suppressionsMatchOrder() {
+        // The first suppression that matches is marked as matched, no matter
+        // if it is found by error id, by file name or by glob pattern
+        Suppressions suppressions;
+        std::istringstream s("abc:a.c:2\n"
+                             "*:a.c:1\n"
+                             "abc:a.c:1\n"
+                             "abc:b*.c\n"
+                             "abc\n"
+                             "def:dir\\b.c\n"
+                             "unmatchedSuppression:*\n");
+        ASSERT_EQUALS("", suppressions.parseFile(s));
+
+        ASSERT_EQUALS(true, suppressions.isSuppressedLocal(errorMessage("abc", "a.c", 1)));
+        ASSERT_EQUALS(false, suppressions.isSuppressedLocal(errorMessage("abc", "b.c", 1)));
+        ASSERT_EQUALS(true, suppressions.isSuppressed(errorMessage("abc", "b.c", 1)));
+        ASSERT_EQUALS(true, suppressions.isSuppressed(errorMessage("def", "dir/b.c", 1)));
+        ASSERT_EQUALS(true, suppressions.isSuppressed(errorMessage("unmatchedSuppression", "x.c", 1)));
+        ASSERT_EQUALS(false, suppressions.isSuppressed(errorMessage("ghi", "x.c", 1)));
+
+        const std::list<Suppressions::Suppression> unmatchedA = suppressions.getUnmatchedLocalSuppressions("a.c", true);
+        ASSERT_EQUALS(2, unmatchedA.size());
+        ASSERT_EQUALS(2, unmatchedA.front().lineNumber);
+        ASSERT_EQUALS("abc", unmatchedA.back().errorId);
+        ASSERT_EQUALS(1, unmatchedA.back().lineNumber);
+        ASSERT_EQUALS(0, suppressions.getUnmatchedLocalSuppressions("dir/b.c", true).size());
+
+        const std::list<Suppressions::Suppression> unmatchedGlobal = suppressions.getUnmatchedGlobalSuppressions(true);
+        ASSERT_EQUALS(1, unmatchedGlobal.size());
+        ASSERT_EQUALS("abc", unmatchedGlobal.front().errorId);
+        ASSERT_EQUALS("", unmatchedGlobal.front().fileName);
+    }
+
     void suppressionsFileComment() {
         std::istringstream file1("# comment\nabc");
         Suppressions suppressions1;
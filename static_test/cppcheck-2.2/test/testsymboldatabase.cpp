@@ -31,6 +31,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <limits>
 #include <list>
 #include <map>
 #include <set>
@@ -81,7 +82,7 @@ private:
     }
 
     static const Scope *findFunctionScopeByToken(const SymbolDatabase * db, const Token *tok) {
-        std::list<Scope>::const_iterator scope;
+        ChunkedList<Scope>::const_iterator scope;
 
         for (scope = db->scopeList.begin(); scope != db->scopeList.end(); ++scope) {
             if (scope->type == Scope::eFunction) {
@@ -327,6 +328,7 @@ private:
         TEST_CASE(symboldatabase87); // #9922 'extern const char ( * x [ 256 ] ) ;'
 
         TEST_CASE(createSymbolDatabaseFindAllScopes1);
+        TEST_CASE(findInNestedList);
 
         TEST_CASE(enum1);
         TEST_CASE(enum2);
@@ -375,6 +377,7 @@ private:
         TEST_CASE(findFunction29);
         TEST_CASE(findFunction30);
         TEST_CASE(findFunction31);
+        TEST_CASE(findFunction32); // same name, different number of arguments
         TEST_CASE(findFunctionContainer);
         TEST_CASE(findFunctionExternC);
         TEST_CASE(findFunctionGlobalScope); // ::foo
@@ -1716,7 +1719,7 @@ private:
         if (db) {
             bool seen_something = false;
             for (const Scope & scope : db->scopeList) {
-                for (std::list<Function>::const_iterator func = scope.functionList.begin(); func != scope.functionList.end(); ++func) {
+                for (ChunkedList<Function>::const_iterator func = scope.functionList.begin(); func != scope.functionList.end(); ++func) {
                     ASSERT_EQUALS("Sub", func->token->str());
                     ASSERT_EQUALS(true, func->hasBody());
                     ASSERT_EQUALS(Function::eConstructor, func->type);
@@ -1989,10 +1992,10 @@ private:
 
         ASSERT(db && db->scopeList.size() == 1);
         if (db && db->scopeList.size() == 1) {
-            std::list<Scope>::const_iterator it = db->scopeList.begin();
+            ChunkedList<Scope>::const_iterator it = db->scopeList.begin();
             ASSERT(it->varlist.size() == 1);
             if (it->varlist.size() == 1) {
-                std::list<Variable>::const_iterator var = it->varlist.begin();
+                ChunkedList<Variable>::const_iterator var = it->varlist.begin();
                 ASSERT(var->name() == "i");
                 ASSERT(var->typeStartToken()->str() == "int");
             }
@@ -2004,10 +2007,10 @@ private:
 
         ASSERT(db && db->scopeList.size() == 1);
         if (db && db->scopeList.size() == 1) {
-            std::list<Scope>::const_iterator it = db->scopeList.begin();
+            ChunkedList<Scope>::const_iterator it = db->scopeList.begin();
             ASSERT(it->varlist.size() == 1);
             if (it->varlist.size() == 1) {
-                std::list<Variable>::const_iterator var = it->varlist.begin();
+                ChunkedList<Variable>::const_iterator var = it->varlist.begin();
                 ASSERT(var->name() == "array");
                 ASSERT(var->typeStartToken()->str() == "int");
             }
@@ -2019,10 +2022,10 @@ private:
 
         ASSERT(db && db->scopeList.size() == 1);
         if (db && db->scopeList.size() == 1) {
-            std::list<Scope>::const_iterator it = db->scopeList.begin();
+            ChunkedList<Scope>::const_iterator it = db->scopeList.begin();
             ASSERT(it->varlist.size() == 1);
             if (it->varlist.size() == 1) {
-                std::list<Variable>::const_iterator var = it->varlist.begin();
+                ChunkedList<Variable>::const_iterator var = it->varlist.begin();
                 ASSERT(var->name() == "array");
                 ASSERT(var->typeStartToken()->str() == "int");
             }
@@ -2361,7 +2364,7 @@ private:
         if (db) {
             ASSERT_EQUALS(3, db->scopeList.size());
             if (db->scopeList.size() == 3) {
-                std::list<Scope>::const_iterator scope = db->scopeList.begin();
+                ChunkedList<Scope>::const_iterator scope = db->scopeList.begin();
                 ++scope;
                 ASSERT_EQUALS((unsigned int)Scope::eClass, (unsigned int)scope->type);
                 ASSERT_EQUALS(1, scope->functionList.size());
@@ -2385,7 +2388,7 @@ private:
         if (db) {
             ASSERT_EQUALS(3, db->scopeList.size());
             if (db->scopeList.size() == 3) {
-                std::list<Scope>::const_iterator scope = db->scopeList.begin();
+                ChunkedList<Scope>::const_iterator scope = db->scopeList.begin();
                 ++scope;
                 ASSERT_EQUALS((unsigned int)Scope::eClass, (unsigned int)scope->type);
                 ASSERT_EQUALS(1, scope->functionList.size());
@@ -2978,7 +2981,7 @@ private:
         ASSERT(db && db->typeList.size() == 5);
         if (!db || db->typeList.size() < 5)
             return;
-        std::list<Type>::const_iterator i = db->typeList.begin();
+        ChunkedList<Type>::const_iterator i = db->typeList.begin();
         const Type* Foo = &(*i++);
         const Type* Bar = &(*i++);
         const Type* Sub = &(*i++);
@@ -3047,7 +3050,7 @@ private:
         ASSERT(db && db->typeList.size() == 3);
         if (!db || db->typeList.size() != 3)
             return;
-        std::list<Type>::const_iterator i = db->typeList.begin();
+        ChunkedList<Type>::const_iterator i = db->typeList.begin();
         const Type* Fred = &(*i++);
         const Type* Wilma = &(*i++);
         const Type* Barney = &(*i++);
@@ -3137,7 +3140,7 @@ private:
             ASSERT(db->getVariableFromVarId(i) != nullptr);
 
         ASSERT_EQUALS(4U, db->scopeList.size());
-        std::list<Scope>::const_iterator scope = db->scopeList.begin();
+        ChunkedList<Scope>::const_iterator scope = db->scopeList.begin();
         ASSERT_EQUALS(Scope::eGlobal, scope->type);
         ++scope;
         ASSERT_EQUALS(Scope::eStruct, scope->type);
@@ -3155,7 +3158,7 @@ private:
 
         ASSERT(db != nullptr);
         ASSERT_EQUALS(4U, db->scopeList.size());
-        std::list<Scope>::const_iterator scope = db->scopeList.begin();
+        ChunkedList<Scope>::const_iterator scope = db->scopeList.begin();
         ASSERT_EQUALS(Scope::eGlobal, scope->type);
         ++scope;
         ASSERT_EQUALS(Scope::eStruct, scope->type);
@@ -3363,7 +3366,7 @@ private:
         if (db) {
             ASSERT(db->scopeList.size() == 4U);
             if (db->scopeList.size() == 4U) {
-                std::list<Scope>::const_iterator it = db->scopeList.begin();
+                ChunkedList<Scope>::const_iterator it = db->scopeList.begin();
                 ASSERT(it->type == Scope::eGlobal);
                 ASSERT((++it)->type == Scope::eFunction);
                 ASSERT((++it)->type == Scope::eIf);
@@ -3387,7 +3390,7 @@ private:
         if (db) {
             ASSERT(db->typeList.size() == 3U);
             if (db->typeList.size() == 3U) {
-                std::list<Type>::const_iterator it = db->typeList.begin();
+                ChunkedList<Type>::const_iterator it = db->typeList.begin();
                 const Type * classB = &(*it);
                 const Type * classC = &(*(++it));
                 const Type * classA = &(*(++it));
@@ -4752,6 +4755,27 @@ private:
         ASSERT_EQUALS(Scope::eUnion, db->scopeList.back().type);
     }
 
+    void findInNestedList() {
+        GET_SYMBOL_DB("namespace N {\n"
+                      "  void A() {}\n"
+                      "  class A { struct B { int x; }; };\n"
+                      "  class A;\n"
+                      "}\n"
+                      "N::A::B b;");
+        Scope *n = const_cast<Scope *>(db->findScopeByName("N"));
+        ASSERT(n != nullptr);
+        if (!n)
+            return;
+        const Scope *function = n->findInNestedList("A");
+        ASSERT(function && function->type == Scope::eFunction);
+        const Scope *record = n->findRecordInNestedList("A");
+        ASSERT(record && record->type == Scope::eClass && record->bodyStart->linenr() == 3);
+        ASSERT(record && record->findRecordInNestedList("B") == n->findInNestedListRecursive("B"));
+        ASSERT(n->findInNestedList("B") == nullptr);
+        ASSERT(n->findRecordInNestedList("C") == nullptr);
+        ASSERT(db->findScope(Token::findsimplematch(tokenizer.tokens(), "N :: A :: B b"), &db->scopeList.front()) == n->findInNestedListRecursive("B"));
+    }
+
     void enum1() {
         GET_SYMBOL_DB("enum BOOL { FALSE, TRUE }; enum BOOL b;");
 
@@ -4799,7 +4823,7 @@ private:
         ASSERT_EQUALS(3U, db->scopeList.size());
 
         // Assert that all enum values are known
-        std::list<Scope>::const_iterator scope = db->scopeList.begin();
+        ChunkedList<Scope>::const_iterator scope = db->scopeList.begin();
 
         // Offsets
         ++scope;
@@ -4888,7 +4912,7 @@ private:
         ASSERT_EQUALS(2U, db->scopeList.size());
 
         // Assert that all enum values are known
-        std::list<Scope>::const_iterator scope = db->scopeList.begin();
+        ChunkedList<Scope>::const_iterator scope = db->scopeList.begin();
 
         ++scope;
         ASSERT_EQUALS((unsigned int)Scope::eEnum, (unsigned int)scope->type);
@@ -5142,7 +5166,7 @@ private:
                       "};");
         ASSERT(db && db->scopeList.back().functionList.size() == 4);
         if (db && db->scopeList.back().functionList.size() == 4) {
-            std::list<Function>::const_iterator it = db->scopeList.back().functionList.begin();
+            ChunkedList<Function>::const_iterator it = db->scopeList.back().functionList.begin();
             ASSERT((it++)->isPure());
             ASSERT((it++)->isPure());
             ASSERT(!(it++)->isPure());
@@ -6138,6 +6162,22 @@ private:
         ASSERT_EQUALS(1, foo->function()->tokenDef->linenr());
     }
 
+    void findFunction32() {
+        GET_SYMBOL_DB("struct Base { void f(double); void f(int, int); };\n"
+                      "struct Fred : Base { void f(int); void g(); };\n"
+                      "void Fred::g() { f(1); f(1, 2); f(3); Base::f(1.0); f(4, 5); }");
+        const Token *f = Token::findsimplematch(tokenizer.tokens(), "f ( 1 ) ;");
+        ASSERT(f && f->function() && f->function()->tokenDef->linenr() == 2);
+        f = Token::findsimplematch(tokenizer.tokens(), "f ( 1 , 2 ) ;");
+        ASSERT(f && f->function() && f->function()->tokenDef->linenr() == 1 && f->function()->argCount() == 2);
+        f = Token::findsimplematch(tokenizer.tokens(), "f ( 3 ) ;");
+        ASSERT(f && f->function() && f->function()->tokenDef->linenr() == 2);
+        f = Token::findsimplematch(tokenizer.tokens(), "f ( 1.0 ) ;");
+        ASSERT(f && f->function() && f->function()->tokenDef->linenr() == 1 && f->function()->argCount() == 1);
+        f = Token::findsimplematch(tokenizer.tokens(), "f ( 4 , 5 ) ;");
+        ASSERT(f && f->function() && f->function()->tokenDef->linenr() == 1 && f->function()->argCount() == 2);
+    }
+
     void findFunctionContainer() {
         {
             GET_SYMBOL_DB("void dostuff(std::vector<int> v);\n"
@@ -6600,7 +6640,7 @@ private:
 
         ASSERT(db && db->scopeList.size() == 3);
         if (db && db->scopeList.size() == 3) {
-            std::list<Scope>::const_iterator scope = db->scopeList.begin();
+            ChunkedList<Scope>::const_iterator scope = db->scopeList.begin();
             ASSERT_EQUALS(Scope::eGlobal, scope->type);
             ++scope;
             ASSERT_EQUALS(Scope::eFunction, scope->type);
@@ -6621,7 +6661,7 @@ private:
 
         ASSERT(db && db->scopeList.size() == 3);
         if (db && db->scopeList.size() == 3) {
-            std::list<Scope>::const_iterator scope = db->scopeList.begin();
+            ChunkedList<Scope>::const_iterator scope = db->scopeList.begin();
             ASSERT_EQUALS(Scope::eGlobal, scope->type);
             ++scope;
             ASSERT_EQUALS(Scope::eFunction, scope->type);
@@ -6638,7 +6678,7 @@ private:
 
         ASSERT(db && db->scopeList.size() == 3);
         if (db && db->scopeList.size() == 3) {
-            std::list<Scope>::const_iterator scope = db->scopeList.begin();
+            ChunkedList<Scope>::const_iterator scope = db->scopeList.begin();
             ASSERT_EQUALS(Scope::eGlobal, scope->type);
             ++scope;
             ASSERT_EQUALS(Scope::eFunction, scope->type);
@@ -6671,7 +6711,7 @@ private:
 
         ASSERT(db && db->scopeList.size() == 3);
         if (db && db->scopeList.size() == 3) {
-            std::list<Scope>::const_iterator scope = db->scopeList.begin();
+            ChunkedList<Scope>::const_iterator scope = db->scopeList.begin();
             ASSERT_EQUALS(Scope::eGlobal, scope->type);
             ++scope;
             ASSERT_EQUALS(Scope::eClass, scope->type);
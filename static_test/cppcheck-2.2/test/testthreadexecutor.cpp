@@ -16,15 +16,33 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "errorlogger.h"
+#include "errortypes.h"
 #include "settings.h"
 #include "testsuite.h"
 #include "threadexecutor.h"
 
+#include <csignal>
 #include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <list>
 #include <map>
 #include <ostream>
 #include <string>
 #include <utility>
+#include <vector>
+
+#ifdef THREADING_MODEL_FORK
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 class TestThreadExecutor : public TestFixture {
 public:
@@ -38,7 +56,7 @@ private:
      * Execute check using n jobs for y files which are have
      * identical data, given within data.
      */
-    void check(unsigned int jobs, int files, int result, const std::string &data) {
+    void check(unsigned int jobs, int files, int result, const std::string &data, Settings::ExecutorType executorType = Settings::ExecutorType::Process) {
         errout.str("");
         output.str("");
         if (!ThreadExecutor::isEnabled()) {
@@ -54,6 +72,7 @@ private:
         }
 
         settings.jobs = jobs;
+        settings.executor = executorType;
         ThreadExecutor executor(filemap, settings, *this);
         for (std::map<std::string, std::size_t>::const_iterator i = filemap.begin(); i != filemap.end(); ++i)
             executor.addFileContent(i->first, data);
@@ -71,6 +90,17 @@ private:
         TEST_CASE(no_errors_equal_amount_files);
         TEST_CASE(one_error_less_files);
         TEST_CASE(one_error_several_files);
+        TEST_CASE(thread_executor_many_errors);
+        TEST_CASE(thread_executor_many_threads);
+        TEST_CASE(thread_executor_one_error_several_files);
+        TEST_CASE(thread_executor_different_file_sizes);
+        TEST_CASE(work_items_order);
+        TEST_CASE(work_stealing);
+        TEST_CASE(file_timings);
+        TEST_CASE(file_timings_cached_process);
+        TEST_CASE(file_timings_cached_thread);
+        TEST_CASE(findings_batched);
+        TEST_CASE(child_crash);
     }
 
     void deadlock_with_many_errors() {
@@ -135,6 +165,283 @@ private:
               "  return 0;\n"
               "}");
     }
+
+    void thread_executor_many_errors() {
+        std::ostringstream oss;
+        oss << "int main()\n"
+            << "{\n";
+        for (int i = 0; i < 500; i++)
+            oss << "  {char *a = malloc(10);}\n";
+
+        oss << "  return 0;\n"
+            << "}\n";
+        check(2, 3, 3, oss.str(), Settings::ExecutorType::Thread);
+    }
+
+    void thread_executor_many_threads() {
+        check(16, 100, 100,
+              "int main()\n"
+              "{\n"
+              "  char *a = malloc(10);\n"
+              "  return 0;\n"
+              "}", Settings::ExecutorType::Thread);
+    }
+
+    void thread_executor_one_error_several_files() {
+        check(2, 20, 20,
+              "int main()\n"
+              "{\n"
+              "  {char *a = malloc(10);}\n"
+              "  return 0;\n"
+              "}", Settings::ExecutorType::Thread);
+    }
+
+    void thread_executor_different_file_sizes() {
+        if (!ThreadExecutor::isEnabled())
+            return;
+
+        // The large files are checked first, the idle threads steal the small files
+        std::map<std::string, std::size_t> filemap;
+        for (int i = 1; i <= 25; ++i) {
+            std::ostringstream oss;
+            oss << "file_" << i << ".cpp";
+            filemap[oss.str()] = (i % 5) * 1000 + i;
+        }
+
+        settings.jobs = 3;
+        settings.executor = Settings::ExecutorType::Thread;
+        ThreadExecutor executor(filemap, settings, *this);
+        for (std::map<std::string, std::size_t>::const_iterator i = filemap.begin(); i != filemap.end(); ++i)
+            executor.addFileContent(i->first,
+                                    "int main()\n"
+                                    "{\n"
+                                    "  {char *a = malloc(10);}\n"
+                                    "  return 0;\n"
+                                    "}");
+
+        ASSERT_EQUALS(25, executor.check());
+
+#ifdef THREADING_MODEL_FORK
+        // The time of every file is recorded
+        ASSERT_EQUALS(25, executor.mFileTimings.size());
+        ASSERT_EQUALS(1, executor.mFileTimings.count(":file_1.cpp"));
+#endif
+    }
+
+    void work_items_order() {
+#ifdef THREADING_MODEL_FORK
+        std::map<std::string, std::size_t> filemap;
+        filemap["a.cpp"] = 10;
+        filemap["b.cpp"] = 30;
+        filemap["c.cpp"] = 20;
+
+        settings.buildDir.clear();
+        ThreadExecutor executor(filemap, settings, *this);
+        executor.createWorkItems();
+        ASSERT_EQUALS(3, executor.mWorkItems.size());
+        ASSERT_EQUALS("b.cpp", *executor.mWorkItems[0].file);
+        ASSERT_EQUALS("c.cpp", *executor.mWorkItems[1].file);
+        ASSERT_EQUALS("a.cpp", *executor.mWorkItems[2].file);
+#endif
+    }
+
+    void work_stealing() {
+#ifdef THREADING_MODEL_FORK
+        std::map<std::string, std::size_t> filemap;
+        for (int i = 1; i <= 6; ++i) {
+            std::ostringstream oss;
+            oss << "file_" << i << ".cpp";
+            filemap[oss.str()] = i * 100;
+        }
+
+        settings.buildDir.clear();
+        ThreadExecutor executor(filemap, settings, *this);
+        executor.createWorkItems();
+
+        // Dealt round robin: queue 0 gets 6,4,2 and queue 1 gets 5,3,1
+        std::vector<ThreadExecutor::WorkQueue> queues(2);
+        for (std::size_t i = 0; i < executor.mWorkItems.size(); ++i)
+            queues[i % 2].items.push_back(&executor.mWorkItems[i]);
+
+        // A thread takes the most expensive file of its own queue
+        ASSERT_EQUALS("file_6.cpp", *ThreadExecutor::nextWorkItem(queues, 0)->file);
+        ASSERT_EQUALS("file_4.cpp", *ThreadExecutor::nextWorkItem(queues, 0)->file);
+        ASSERT_EQUALS("file_2.cpp", *ThreadExecutor::nextWorkItem(queues, 0)->file);
+        // .. and then steals the cheapest file of another queue
+        ASSERT_EQUALS("file_1.cpp", *ThreadExecutor::nextWorkItem(queues, 0)->file);
+        ASSERT_EQUALS("file_5.cpp", *ThreadExecutor::nextWorkItem(queues, 1)->file);
+        ASSERT_EQUALS("file_3.cpp", *ThreadExecutor::nextWorkItem(queues, 0)->file);
+        ASSERT(ThreadExecutor::nextWorkItem(queues, 0) == nullptr);
+        ASSERT(ThreadExecutor::nextWorkItem(queues, 1) == nullptr);
+#endif
+    }
+
+#ifdef THREADING_MODEL_FORK
+    /** Create an empty temporary build dir */
+    static std::string createBuildDir() {
+        char dir[] = "/tmp/cppcheck-testthreadexecutor-XXXXXX";
+        return mkdtemp(dir) ? dir : "";
+    }
+
+    /** Remove the build dir and the files in it */
+    static void removeBuildDir(const std::string &buildDir) {
+        if (DIR *dir = opendir(buildDir.c_str())) {
+            while (const struct dirent *entry = readdir(dir)) {
+                if (std::strcmp(entry->d_name, ".") != 0 && std::strcmp(entry->d_name, "..") != 0)
+                    std::remove((buildDir + '/' + entry->d_name).c_str());
+            }
+            closedir(dir);
+        }
+        rmdir(buildDir.c_str());
+    }
+#endif
+
+    void file_timings() {
+#ifdef THREADING_MODEL_FORK
+        std::map<std::string, std::size_t> filemap;
+        filemap["a.cpp"] = 10;
+        filemap["b.cpp"] = 1000;
+        filemap["c.cpp"] = 20;
+
+        // The time of the previous run is used instead of the size
+        const std::string buildDir = createBuildDir();
+        ASSERT(!buildDir.empty());
+        {
+            std::ofstream fout(buildDir + "/timings.txt");
+            fout << "500:" << ":a.cpp\n"
+                 << "100:" << ":b.cpp\n";
+        }
+        settings.buildDir = buildDir;
+        ThreadExecutor executor(filemap, settings, *this);
+        executor.createWorkItems();
+        settings.buildDir.clear();
+        removeBuildDir(buildDir);
+
+        ASSERT_EQUALS(3, executor.mWorkItems.size());
+        ASSERT_EQUALS("a.cpp", *executor.mWorkItems[0].file);
+        ASSERT_EQUALS("b.cpp", *executor.mWorkItems[1].file);
+        ASSERT_EQUALS("c.cpp", *executor.mWorkItems[2].file);
+
+        // The largest time is kept, a faster run lowers it by a quarter
+        executor.addFileTiming(executor.mWorkItems[0], 100);
+        executor.addFileTiming(executor.mWorkItems[1], 200);
+        executor.addFileTiming(executor.mWorkItems[2], 30);
+        ASSERT_EQUALS(375, executor.mFileTimings[":a.cpp"]);
+        ASSERT_EQUALS(200, executor.mFileTimings[":b.cpp"]);
+        ASSERT_EQUALS(30, executor.mFileTimings[":c.cpp"]);
+#endif
+    }
+
+    void file_timings_cached(Settings::ExecutorType executorType) {
+#ifdef THREADING_MODEL_FORK
+        std::map<std::string, std::size_t> filemap;
+        filemap["a.cpp"] = 10;
+
+        const std::string buildDir = createBuildDir();
+        ASSERT(!buildDir.empty());
+        settings.buildDir = buildDir;
+        settings.jobs = 2;
+        settings.executor = executorType;
+        {
+            ThreadExecutor executor(filemap, settings, *this);
+            executor.addFileContent("a.cpp", "void f() { char *p = malloc(10); }");
+            ASSERT_EQUALS(1, executor.check());
+        }
+
+        // The results of the second run are read from the build dir, that
+        // time is not recorded
+        {
+            std::ofstream fout(buildDir + "/timings.txt");
+            fout << "5000:" << ":a.cpp\n";
+        }
+        ThreadExecutor executor(filemap, settings, *this);
+        executor.addFileContent("a.cpp", "void f() { char *p = malloc(10); }");
+        ASSERT_EQUALS(1, executor.check());
+        settings.buildDir.clear();
+        removeBuildDir(buildDir);
+
+        ASSERT_EQUALS(5000, executor.mFileTimings[":a.cpp"]);
+#endif
+    }
+
+    void file_timings_cached_process() {
+        file_timings_cached(Settings::ExecutorType::Process);
+    }
+
+    void file_timings_cached_thread() {
+        file_timings_cached(Settings::ExecutorType::Thread);
+    }
+
+    void findings_batched() {
+#ifdef THREADING_MODEL_FORK
+        errout.str("");
+        std::map<std::string, std::size_t> filemap;
+        settings.executor = Settings::ExecutorType::Process;
+        ThreadExecutor executor(filemap, settings, *this);
+
+        int pipes[2];
+        ASSERT_EQUALS(0, pipe(pipes));
+        ASSERT_EQUALS(0, fcntl(pipes[0], F_SETFL, O_NONBLOCK));
+        executor.mWpipe = pipes[1];
+
+        // The findings are queued..
+        const std::list<ErrorMessage::FileLocation> locations(1, ErrorMessage::FileLocation("a.c", 1, 1));
+        executor.reportErr(ErrorMessage(locations, "a.c", Severity::error, "Memory leak: p", "memleak", false));
+        executor.reportErr(ErrorMessage(locations, "a.c", Severity::error, "Memory leak: q", "memleak", false));
+        unsigned int result = 0;
+        ASSERT_EQUALS(0, executor.handleRead(pipes[0], result));
+        ASSERT_EQUALS("", errout.str());
+
+        // .. and sent when the file is done
+        const std::uint32_t fileResult = 1;
+        std::string childEnd(reinterpret_cast<const char *>(&fileResult), sizeof(fileResult));
+        childEnd += '\0';
+        executor.writeToPipe(ThreadExecutor::CHILD_END, childEnd);
+        ASSERT_EQUALS(-1, executor.handleRead(pipes[0], result));
+        ASSERT_EQUALS(1, result);
+        ASSERT_EQUALS("[a.c:1]: (error) Memory leak: p\n"
+                      "[a.c:1]: (error) Memory leak: q\n", errout.str());
+        close(pipes[0]);
+        close(pipes[1]);
+#endif
+    }
+
+    void child_crash() {
+#ifdef THREADING_MODEL_FORK
+        errout.str("");
+        std::map<std::string, std::size_t> filemap;
+        settings.executor = Settings::ExecutorType::Process;
+        ThreadExecutor executor(filemap, settings, *this);
+
+        int pipes[2];
+        ASSERT_EQUALS(0, pipe(pipes));
+        const pid_t pid = fork();
+        ASSERT(pid >= 0);
+        if (pid == 0) {
+            close(pipes[0]);
+            executor.mWpipe = pipes[1];
+            executor.installCrashHandler();
+            const struct rlimit noCore = { 0, 0 };
+            setrlimit(RLIMIT_CORE, &noCore);
+            const std::list<ErrorMessage::FileLocation> locations(1, ErrorMessage::FileLocation("a.c", 1, 1));
+            executor.reportErr(ErrorMessage(locations, "a.c", Severity::error, "Memory leak: p", "memleak", false));
+            // The child crashes before it is done with the file
+            std::raise(SIGSEGV);
+            std::exit(0);
+        }
+        close(pipes[1]);
+        int stat = 0;
+        waitpid(pid, &stat, 0);
+        ASSERT(WIFSIGNALED(stat));
+        ASSERT_EQUALS(SIGSEGV, WTERMSIG(stat));
+
+        // The finding that was queued before the crash is delivered
+        unsigned int result = 0;
+        while (executor.handleRead(pipes[0], result) == 1) {}
+        close(pipes[0]);
+        ASSERT_EQUALS("[a.c:1]: (error) Memory leak: p\n", errout.str());
+#endif
+    }
 };
 
 REGISTER_TEST(TestThreadExecutor)
@@ -20,7 +20,11 @@
 #include "timer.h"
 
 #include <cmath>
+#include <cstdio>
 #include <ctime>
+#include <fstream>
+#include <sstream>
+#include <string>
 
 class TestTimer : public TestFixture {
 public:
@@ -31,6 +35,8 @@ private:
 
     void run() OVERRIDE {
         TEST_CASE(result);
+        TEST_CASE(fileResults);
+        TEST_CASE(trace);
     }
 
     void result() const {
@@ -41,6 +47,107 @@ private:
         t1.mClocks = CLOCKS_PER_SEC * 5 / 2;
         ASSERT(std::fabs(t1.seconds()-2.5) < 0.01);
     }
+
+    void fileResults() const {
+        TimerResultsData data;
+        data.mClocks = CLOCKS_PER_SEC;
+        data.mAllocations = 3;
+        data.mTokens = 10;
+        data.mNumberOfResults = 1;
+        TimerResults file;
+        file.addResults("phase", data);
+
+        TimerResults total;
+        total.addFileResults("a.c", file, true);
+        total.addFileResults("b.c", file, false);
+
+        // the results of a worker process are sent to the parent process
+        std::string buffer;
+        total.serializeBinary(buffer);
+        TimerResults worker;
+        const char *data1 = buffer.data();
+        ASSERT_EQUALS(true, worker.deserializeBinary(data1, buffer.data() + buffer.size()));
+        ASSERT(data1 == buffer.data() + buffer.size());
+        TimerResults truncated;
+        const char *data2 = buffer.data();
+        ASSERT_EQUALS(false, truncated.deserializeBinary(data2, buffer.data() + buffer.size() - 1));
+
+        TimerResults merged;
+        merged.merge(worker);
+        merged.merge(worker);
+        ASSERT_EQUALS(true, merged.writeResults("timerresults.csv"));
+        std::ifstream fin("timerresults.csv");
+        std::ostringstream csv;
+        csv << fin.rdbuf();
+        fin.close();
+        std::remove("timerresults.csv");
+        ASSERT_EQUALS("file,phase,calls,cpu,wall,peakMemoryIncrease,allocations,tokens\n"
+                      "\"a.c\",\"phase\",1,1,0,0,3,10\n"
+                      "\"a.c\",\"phase\",1,1,0,0,3,10\n"
+                      "\"\",\"phase\",4,4,0,0,12,40\n", csv.str());
+    }
+
+    void trace() const {
+        TimerTrace trace;
+        Timer::setTrace(&trace);
+        Timer::setTraceWorker(2);
+        {
+            Timer t1("phase", SHOWTIME_MODES::SHOWTIME_NONE);
+            t1.setDetail("a \"b\".c");
+        }
+        Timer::setTraceWorker(0);
+        Timer::setTrace(nullptr);
+        {
+            Timer t2("untraced", SHOWTIME_MODES::SHOWTIME_NONE);
+        }
+
+        // the events of a worker process are sent to the parent process
+        std::string buffer;
+        trace.serializeBinary(buffer);
+        TimerTrace worker;
+        const char *data1 = buffer.data();
+        ASSERT_EQUALS(true, worker.deserializeBinary(data1, buffer.data() + buffer.size()));
+        ASSERT(data1 == buffer.data() + buffer.size());
+        TimerTrace truncated;
+        const char *data2 = buffer.data();
+        ASSERT_EQUALS(false, truncated.deserializeBinary(data2, buffer.data() + buffer.size() - 1));
+
+        TimerTrace merged;
+        merged.merge(worker);
+        ASSERT_EQUALS(true, merged.write("timertrace.json"));
+        std::ifstream fin("timertrace.json");
+        std::ostringstream json;
+        json << fin.rdbuf();
+        fin.close();
+        std::remove("timertrace.json");
+        ASSERT(json.str().find("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,\"tid\":0,\"args\":{\"name\":\"worker 2\"}}") != std::string::npos);
+        ASSERT(json.str().find("{\"name\":\"phase\",\"cat\":\"cppcheck\",\"ph\":\"X\",\"ts\":0.000,\"dur\":") != std::string::npos);
+        ASSERT(json.str().find(",\"pid\":2,\"tid\":") != std::string::npos);
+        ASSERT(json.str().find("\"args\":{\"detail\":\"a \\\"b\\\".c\"}") != std::string::npos);
+        ASSERT_EQUALS(std::string::npos, json.str().find("untraced"));
+
+        // an event more than 1 second after the first one keeps its precision
+        TimerTrace longTrace;
+        TimerTrace::Event event;
+        event.name = "first";
+        event.start = 1000000;
+        event.duration = 1000;
+        event.worker = 0;
+        event.thread = 0;
+        longTrace.addEvent(event);
+        event.name = "late";
+        event.start += 1500000500;
+        event.duration = 2500;
+        longTrace.addEvent(event);
+        ASSERT_EQUALS(true, longTrace.write("timertrace.json"));
+        std::ifstream fin2("timertrace.json");
+        std::ostringstream json2;
+        json2 << fin2.rdbuf();
+        fin2.close();
+        std::remove("timertrace.json");
+        ASSERT(json2.str().find("\"name\":\"first\",\"cat\":\"cppcheck\",\"ph\":\"X\",\"ts\":0.000,\"dur\":1.000,") != std::string::npos);
+        ASSERT(json2.str().find("\"name\":\"late\",\"cat\":\"cppcheck\",\"ph\":\"X\",\"ts\":1500000.500,\"dur\":2.500,") != std::string::npos);
+    }
 };
 
 REGISTER_TEST(TestTimer)
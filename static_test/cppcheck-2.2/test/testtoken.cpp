@@ -23,7 +23,9 @@
 #include "tokenize.h"
 #include "tokenlist.h"
 
+#include <cstring>
 #include <string>
+#include <thread>
 #include <vector>
 
 struct InternalError;
@@ -63,6 +65,8 @@ private:
         TEST_CASE(getCharAt);
         TEST_CASE(strValue);
         TEST_CASE(concatStr);
+        TEST_CASE(internedStr);
+        TEST_CASE(internedStrReleased);
 
         TEST_CASE(deleteLast);
         TEST_CASE(deleteFirst);
@@ -82,6 +86,7 @@ private:
         TEST_CASE(matchOr);
         TEST_CASE(matchOp);
         TEST_CASE(matchConstOp);
+        TEST_CASE(matchCompiledPattern);
 
         TEST_CASE(isArithmeticalOp);
         TEST_CASE(isOp);
@@ -110,6 +115,7 @@ private:
         TEST_CASE(expressionString);
 
         TEST_CASE(hasKnownIntValue);
+        TEST_CASE(valueGeneration);
     }
 
     void nextprevious() const {
@@ -499,8 +505,54 @@ private:
         ASSERT(tok.isUtf8());
     }
 
+    void internedStr() const {
+        Token tok1;
+        Token tok2;
+
+        tok1.str("abc");
+        tok2.str(std::string("ab") + "c");
+        ASSERT(&tok1.str() == &tok2.str());
+
+        tok2.str("\"ab\"");
+        tok2.concatStr("\"cd\"");
+        ASSERT_EQUALS("abc", tok1.str());
+        ASSERT_EQUALS("\"abcd\"", tok2.str());
+        tok2.str(tok2.str());
+        ASSERT_EQUALS("\"abcd\"", tok2.str());
+
+        // tokens allocated by another thread
+        Token *tok3 = nullptr;
+        std::thread t([&tok3]() {
+            tok3 = new Token;
+            tok3->str("abc");
+        });
+        t.join();
+        ASSERT(&tok1.str() == &tok3->str());
+        delete tok3;
+
+        // tokens of a list
+        TokenList list(nullptr);
+        list.addtoken("abc", 1, 0);
+        ASSERT(&tok1.str() == &list.front()->str());
+    }
+
+    void internedStrReleased() const {
+        const std::size_t strings = Token::internedStrings();
+        // The thread releases the texts it caches when it exits
+        std::thread t([&]() {
+            TokenList list(nullptr);
+            for (int i = 0; i < 10000; ++i)
+                list.addtoken("internedStrReleased" + MathLib::toString(i), 1, 0);
+            ASSERT(Token::internedStrings() > strings);
+            list.front()->deleteNext(5000);
+        });
+        t.join();
+        // The texts are freed with the last token that uses them
+        ASSERT_EQUALS(strings, Token::internedStrings());
+    }
+
     void deleteLast() const {
-        TokensFrontBack listEnds{ nullptr };
+        TokensFrontBack listEnds{ nullptr, nullptr, nullptr, {0}, nullptr };
         Token ** const tokensBack = &(listEnds.back);
         Token tok(&listEnds);
         tok.insertToken("aba");
@@ -510,7 +562,7 @@ private:
     }
 
     void deleteFirst() const {
-        TokensFrontBack listEnds{ nullptr };
+        TokensFrontBack listEnds{ nullptr, nullptr, nullptr, {0}, nullptr };
         Token ** const tokensFront = &(listEnds.front);
         Token tok(&listEnds);
 
@@ -791,6 +843,53 @@ private:
         }
     }
 
+    static bool matchConstArray(const Token *tok, char last) {
+        const char pattern[] = { '%', 'a', 'n', 'y', '%', ' ', '%', 'a', 'n', 'y', '%', ' ', last, '\0' };
+        return Token::Match(tok, pattern);
+    }
+
+    void matchCompiledPattern() const {
+        // A string literal pattern is parsed once, other patterns are parsed by every call
+#define ASSERT_MATCH(expected, tok, pattern) do { \
+        const char *p = pattern; \
+        ASSERT_EQUALS(expected, Token::Match(tok, p)); \
+        ASSERT_EQUALS(expected, Token::Match(tok, pattern)); \
+} while (false)
+        givenACodeSampleToTokenize var("void f ( ) { int a ; a = 1 | 2 ; if ( a == 1 ) { } else { } }");
+        const Token *tok = Token::findsimplematch(var.tokens(), "int");
+        ASSERT_MATCH(true, tok, "%type% %var% ;");
+        ASSERT_MATCH(true, tok, "char|int %name% ;|=");
+        ASSERT_MATCH(true, tok, "const| int %any%");
+        ASSERT_MATCH(false, tok, "const|char %name%");
+        ASSERT_MATCH(true, tok, "|int %name%");
+        ASSERT_EQUALS(true, Token::Match(tok->tokAt(3), "%varid% %assign% %num% %or%", tok->next()->varId()));
+        ASSERT_EQUALS(false, Token::Match(tok->tokAt(3), "%varid% %assign% %num% %or%", tok->next()->varId() + 1));
+        ASSERT_MATCH(true, tok->tokAt(3), "%var% [=+] 1 %op%|%cop%");
+        ASSERT_MATCH(false, tok->tokAt(3), "%var% = [(]");
+        ASSERT_MATCH(true, tok->tokAt(3), "!!if =");
+        ASSERT_MATCH(true, tok->tokAt(9), "if ( %var% %comp% 1|2 ) {");
+        ASSERT_MATCH(false, tok->tokAt(9), "if ( %var% %comp% 1 ) { } !!else");
+        ASSERT_MATCH(true, tok->tokAt(15)->link(), "} else {");
+        ASSERT_MATCH(true, var.tokens()->linkAt(4), "} !!else");
+        ASSERT_MATCH(false, var.tokens()->linkAt(4), "} %any%");
+#undef ASSERT_MATCH
+
+        // Const arrays at the same address that hold different patterns
+        ASSERT_EQUALS(true, matchConstArray(tok, ';'));
+        ASSERT_EQUALS(false, matchConstArray(tok, '='));
+        ASSERT_EQUALS(true, matchConstArray(tok->tokAt(3), '1'));
+        ASSERT_EQUALS(false, matchConstArray(tok->tokAt(3), ';'));
+
+        // A char array that holds another pattern
+        char pattern[32] = "int %name% ;";
+        ASSERT_EQUALS(true, Token::Match(tok, pattern));
+        std::strcpy(pattern, "char %name% ;");
+        ASSERT_EQUALS(false, Token::Match(tok, pattern));
+        pattern[4] = '\0';
+        ASSERT_EQUALS(false, Token::Match(tok, pattern));
+        std::strcpy(pattern, "int");
+        ASSERT_EQUALS(true, Token::Match(tok, pattern));
+    }
 
     void isArithmeticalOp() const {
         std::vector<std::string>::const_iterator test_op, test_ops_end = arithmeticalOps.end();
@@ -1135,6 +1234,47 @@ private:
         ASSERT_EQUALS(true, token.addValue(v2));
         ASSERT_EQUALS(false, token.hasKnownIntValue());
     }
+
+    void valueGeneration() const {
+        TokensFrontBack listEnds{ nullptr, nullptr, nullptr, {0}, nullptr };
+        Token token(&listEnds);
+        ASSERT_EQUALS(0U, listEnds.valueGeneration.load());
+
+        ValueFlow::Value v1(1);
+        ASSERT_EQUALS(true, token.addValue(v1));
+        const std::size_t generation1 = listEnds.valueGeneration.load();
+        ASSERT(generation1 != 0U);
+
+        // adding the same value again changes nothing
+        ASSERT_EQUALS(false, token.addValue(v1));
+        ASSERT_EQUALS(generation1, listEnds.valueGeneration.load());
+
+        token.removeValues([](const ValueFlow::Value &v) {
+            return v.intvalue == 2;
+        });
+        ASSERT_EQUALS(generation1, listEnds.valueGeneration.load());
+
+        token.removeValues([](const ValueFlow::Value &v) {
+            return v.intvalue == 1;
+        });
+        const std::size_t generation2 = listEnds.valueGeneration.load();
+        ASSERT(generation2 != generation1);
+
+        token.clearValueFlow();
+        ASSERT_EQUALS(generation2, listEnds.valueGeneration.load());
+
+        // a known value that replaces the same known value changes nothing
+        ValueFlow::Value v2(2);
+        v2.setKnown();
+        ASSERT_EQUALS(true, token.addValue(v2));
+        const std::size_t generation3 = listEnds.valueGeneration.load();
+        ASSERT(generation3 != generation2);
+        ASSERT_EQUALS(true, token.addValue(v2));
+        ASSERT_EQUALS(generation3, listEnds.valueGeneration.load());
+        v2.errorPath.emplace_back(&token, "assigned value is 2");
+        ASSERT_EQUALS(true, token.addValue(v2));
+        ASSERT(generation3 != listEnds.valueGeneration.load());
+    }
 };
 
 REGISTER_TEST(TestToken)
@@ -17,9 +17,13 @@
  */
 
 
+#include "chunkedlist.h"
 #include "testsuite.h"
 #include "utils.h"
 
+#include <string>
+#include <vector>
+
 class TestUtils : public TestFixture {
 public:
     TestUtils() : TestFixture("TestUtils") {
@@ -29,6 +33,7 @@ private:
     void run() OVERRIDE {
         TEST_CASE(isValidGlobPattern);
         TEST_CASE(matchglob);
+        TEST_CASE(chunkedList);
     }
 
     void isValidGlobPattern() {
@@ -67,6 +72,54 @@ private:
         ASSERT_EQUALS(true, ::matchglob("?y?", "xyz"));
         ASSERT_EQUALS(true, ::matchglob("?/?/?", "x/y/z"));
     }
+
+    void chunkedList() {
+        ChunkedList<std::string> list;
+        std::vector<const std::string *> pointers;
+        for (int i = 0; i < 100; ++i) {
+            list.emplace_back(std::to_string(i));
+            pointers.push_back(&list.back());
+        }
+        ASSERT_EQUALS(100U, list.size());
+        ASSERT_EQUALS("0", list.front());
+        ASSERT_EQUALS("99", list.back());
+
+        // the elements are never moved
+        int i = 0;
+        for (const std::string &s : list) {
+            ASSERT(&s == pointers[i]);
+            ASSERT_EQUALS(std::to_string(i), s);
+            ++i;
+        }
+        ASSERT_EQUALS(100, i);
+
+        // iterate backwards, across the chunk boundaries
+        ChunkedList<std::string>::const_reverse_iterator it = list.rbegin();
+        for (i = 99; i >= 0; --i, ++it)
+            ASSERT_EQUALS(std::to_string(i), *it);
+        ASSERT(it == list.rend());
+
+        // remove elements at the back, the chunks that become empty are freed
+        while (list.size() > 4)
+            list.pop_back();
+        ASSERT_EQUALS("3", list.back());
+        ASSERT(&list.back() == pointers[3]);
+        list.push_back("x");
+        ASSERT_EQUALS("x", list.back());
+
+        // an end iterator stays the end when elements are added
+        ChunkedList<std::string>::iterator end = list.end();
+        list.push_back("y");
+        ASSERT(--end != list.end());
+        ASSERT_EQUALS("y", *end);
+
+        const ChunkedList<std::string> copy(list);
+        ASSERT_EQUALS(6U, copy.size());
+        ASSERT_EQUALS("x", *std::next(copy.begin(), 4));
+        list.clear();
+        ASSERT_EQUALS(true, list.empty());
+        ASSERT(list.begin() == list.end());
+    }
 };
 
 REGISTER_TEST(TestUtils)
@@ -140,6 +140,9 @@ private:
         TEST_CASE(valueFlowCrashConstructorInitialization);
 
         TEST_CASE(valueFlowUnknownMixedOperators);
+
+        TEST_CASE(valueFlowParallelFunctionScopes);
+        TEST_CASE(valueFlowForwardBudget);
     }
 
     static bool isNotTokValue(const ValueFlow::Value &val) {
@@ -4969,6 +4972,89 @@ private:
 
         ASSERT_EQUALS(false, testValueOfXKnown(code, 4U, 1));
     }
+
+    std::string valueFlowOutput(const char code[], unsigned int valueFlowJobs) {
+        Tokenizer tokenizer(&settings, this);
+        tokenizer.setValueFlowJobs(valueFlowJobs);
+        std::istringstream istr(code);
+        tokenizer.tokenize(istr, "test.cpp");
+        std::ostringstream ostr;
+        tokenizer.tokens()->printValueFlow(false, ostr);
+        return ostr.str();
+    }
+
+    void valueFlowParallelFunctionScopes() {
+        // The function scopes are analyzed by several threads, the values must be the same
+        const char code[] = "int &get(std::vector<int> &v) {\n"
+                            "    if (v.empty()) {}\n"
+                            "    return v[0];\n"
+                            "}\n"
+                            "int f1(int x) {\n"
+                            "    if (x == 1) {}\n"
+                            "    return x + 1;\n"
+                            "}\n"
+                            "void f2(std::vector<int> &v) {\n"
+                            "    std::string s = \"abc\";\n"
+                            "    if (s.size() == 3) {}\n"
+                            "    if (v.empty())\n"
+                            "        return;\n"
+                            "    get(v) = 1;\n"
+                            "}\n"
+                            "void f3(int *p) {\n"
+                            "    struct Local {\n"
+                            "        int g(int y) { if (y > 2) { return y; } return 0; }\n"
+                            "    };\n"
+                            "    if (!p) {}\n"
+                            "    *p = 0;\n"
+                            "}\n";
+        errout.str("");
+        const std::string serial = valueFlowOutput(code, 1);
+        ASSERT(serial.find("Line 21") != std::string::npos);
+        ASSERT_EQUALS(serial, valueFlowOutput(code, 2));
+        ASSERT_EQUALS(serial, valueFlowOutput(code, 4));
+    }
+
+    bool testValueOfX(const Settings &s, const char code[], int linenr, int value) {
+        Tokenizer tokenizer(&s, this);
+        std::istringstream istr(code);
+        tokenizer.tokenize(istr, "test.cpp");
+
+        for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next()) {
+            if (tok->str() == "x" && tok->linenr() == linenr) {
+                for (const ValueFlow::Value &v : tok->values()) {
+                    if (v.isIntValue() && !v.isImpossible() && v.intvalue == value)
+                        return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    void valueFlowForwardBudget() {
+        const char code[] = "int f(int a) {\n"
+                            "    int x = 0;\n"
+                            "    if (a) {\n"
+                            "        a = x;\n"
+                            "    }\n"
+                            "    return x;\n"
+                            "}\n";
+        Settings s(settings);
+        s.addEnabled("information");
+
+        errout.str("");
+        ASSERT_EQUALS(true, testValueOfX(s, code, 4U, 0));
+        ASSERT_EQUALS(true, testValueOfX(s, code, 6U, 0));
+        ASSERT_EQUALS("", errout.str());
+
+        // When the budget is exceeded the scope of the if is not forked, but the
+        // analysis continues after it
+        s.maxValueFlowTokens = 1;
+        errout.str("");
+        ASSERT_EQUALS(false, testValueOfX(s, code, 4U, 0));
+        ASSERT_EQUALS(true, testValueOfX(s, code, 6U, 0));
+        ASSERT_EQUALS("[test.cpp:1]: (information) ValueFlow analysis of the function 'f' exceeded its budget, the rest of the function is analyzed with less precision. Use --max-valueflow-tokens and --max-valueflow-forks to change the limits.\n", errout.str());
+    }
 };
 
 REGISTER_TEST(TestValueFlow)
@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+#
+# Micro benchmarks of Cppcheck.
+#
+# Usage:
+#   tools/bench.py [--cppcheck=<binary>]... [--repeat=<count>] <benchmark>
+#
+# Every benchmark writes a generated source file to a temporary directory and
+# runs each cppcheck binary (default ./cppcheck) on it with one or more sets of
+# options. The run with the best wall time is printed with its user and system
+# time, so the binaries of two builds can be compared.
+#
+# Benchmarks:
+#   conditions  20 functions with 120 if, for and while statements each, so
+#             the time is spent in the ValueFlow analysis of the conditions.
+#   findings  One file with 100000 missing includes, checked with -j2 so the
+#             100000 findings are sent from the child to the parent.
+#   tokenize  One 16 MB file that is only preprocessed and printed (-E), so
+#             the time is spent in reading and tokenizing the file.
+
+import argparse
+import os
+import resource
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+
+def generate_conditions(filename):
+    with open(filename, 'wt') as f:
+        for func in range(20):
+            f.write('int f%d(int a, int b, int *p) {\n    int x = 0;\n    int y = a;\n' % func)
+            for i in range(40):
+                f.write('    if (a > %d) { x = %d; } else { y = b + %d; }\n' % (i, i, i))
+                f.write('    for (int i%d = 0; i%d < b; i%d++) { if (x == %d) p[i%d] = y; }\n' % (i, i, i, i, i))
+                f.write('    while (y < %d && p) { y += x; if (y == %d) break; }\n' % (i * 10, i))
+            f.write('    return x + y;\n}\n')
+    return [[]]
+
+
+def generate_findings(filename):
+    with open(filename, 'wt') as f:
+        for i in range(100000):
+            f.write('#include "missing%d.h"\n' % i)
+    options = ['-j2', '--enable=information', '--check-config']
+    return [options + ['--executor=process'], options + ['--executor=thread']]
+
+
+def generate_tokenize(filename):
+    with open(filename, 'wt') as f:
+        for i in range(200000):
+            f.write('static const char *s%d = "string %d"; /* comment */ int x%d = 0x%x + %d.5e3;\n' % (i, i, i, i, i))
+    return [['-E']]
+
+
+BENCHMARKS = {
+    'conditions': ('conditions.c', generate_conditions),
+    'findings': ('findings.c', generate_findings),
+    'tokenize': ('tokenize.c', generate_tokenize),
+}
+
+
+def run(cppcheck, args, repeat):
+    best = None
+    lines = 0
+    for _ in range(repeat):
+        usage = resource.getrusage(resource.RUSAGE_CHILDREN)
+        start = time.time()
+        p = subprocess.Popen([cppcheck, '-q'] + args, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+        stdout, stderr = p.communicate()
+        elapsed = time.time() - start
+        after = resource.getrusage(resource.RUSAGE_CHILDREN)
+        cpu = (after.ru_utime - usage.ru_utime, after.ru_stime - usage.ru_stime)
+        lines = len(stdout.splitlines()) + len(stderr.splitlines())
+        if best is None or elapsed < best[0]:
+            best = (elapsed, cpu)
+    return best, lines
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Cppcheck micro benchmarks')
+    parser.add_argument('--cppcheck', action='append', help='cppcheck binary, can be given more than once')
+    parser.add_argument('--repeat', type=int, default=5, help='number of runs, the best time is printed')
+    parser.add_argument('benchmark', choices=sorted(BENCHMARKS.keys()))
+    args = parser.parse_args()
+
+    binaries = args.cppcheck or ['./cppcheck']
+    tmpdir = tempfile.mkdtemp()
+    try:
+        name, generate = BENCHMARKS[args.benchmark]
+        filename = os.path.join(tmpdir, name)
+        for options in generate(filename):
+            for cppcheck in binaries:
+                (elapsed, cpu), lines = run(cppcheck, options + [filename], args.repeat)
+                print('%s %s: %.3f s, user %.3f s, sys %.3f s, %d output lines' %
+                      (cppcheck, ' '.join(options), elapsed, cpu[0], cpu[1], lines))
+    finally:
+        shutil.rmtree(tmpdir)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -298,6 +298,9 @@ int main(int argc, char **argv)
          << "        endif # !CPPCHK_GLIBCXX_DEBUG\n"
          << "    endif # GNU/kFreeBSD\n"
          << "\n"
+         << "    # std::thread is used by --executor=thread\n"
+         << "    LDFLAGS += -pthread\n"
+         << "\n"
          << "endif # COMSPEC\n"
          << "\n";
 